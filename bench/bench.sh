@@ -0,0 +1,53 @@
+#!/usr/local/bin/zsh
+
+setup_bench() {
+    gcc-9 -O2 -S -o ./build/testlib.s ./test/testlib.c
+}
+
+bench_mincc() {
+    MINCC=./build/mincc.out
+    IN_C=$1
+    option=$2
+    OUT_ASSEMBLY=./build/bench.s
+    LIB=./build/testlib.s
+    EXEC=./build/bench
+
+    ${MINCC} ${=option} ${IN_C} ${OUT_ASSEMBLY}
+    if [ $? -ne 0 ]; then
+        echo "\e[0;31m[FAIL]\e[m failed to compile ${IN_C} (${option})"
+        exit 1
+    fi
+    gcc-9 ${OUT_ASSEMBLY} ${LIB} -o ${EXEC}
+
+    echo "\e[0;34m[BENCH]\e[m ${IN_C} (${option})"
+    awk '
+        /^_[A-Za-z0-9_]+:$/ { func_name = substr($1, 2, length($1) - 2); order[++n] = func_name }
+        /^\t[a-z]/          { count[func_name]++ }
+        END { for (i = 1; i <= n; i++) if (count[order[i]] > 0) printf "  %-24s %6d instructions\n", order[i], count[order[i]] }
+    ' ${OUT_ASSEMBLY}
+    start=$(date +%s%N)
+    ${EXEC} > /dev/null
+    end=$(date +%s%N)
+    echo "  elapsed                  $(( (end - start) / 1000000 )) ms"
+
+    rm -Rf ${OUT_ASSEMBLY} ${EXEC}
+}
+
+teardown_bench() {
+    rm -Rf ./build/testlib.s
+}
+
+
+setup_bench
+
+for bench_file in ./bench/*.c; do
+    for option in -O0 -O1 -O2; do
+        bench_mincc ${bench_file} ${option}
+    done
+done
+
+for option in "-O2 --no-vectorize" "-O2 --avx2"; do
+    bench_mincc ./bench/vector_add.c ${option}
+done
+
+teardown_bench
@@ -0,0 +1,37 @@
+int put_int(int x);
+
+int table[4096];
+
+int scatter_compound(int n) {
+    int i = 0, j = 0, k = 0;
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < 16; j++) {
+            for (k = 0; k < 16; k++) {
+                table[i*j+k] += i ^ k;
+            }
+        }
+    }
+    return table[255];
+}
+
+int scatter_desugared(int n) {
+    int i = 0, j = 0, k = 0;
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < 16; j++) {
+            for (k = 0; k < 16; k++) {
+                table[i*j+k] = table[i*j+k] + (i ^ k);
+            }
+        }
+    }
+    return table[255];
+}
+
+int main() {
+    int r = 0, x = 0;
+    for (r = 0; r < 100; r++) {
+        x = scatter_compound(256);
+        x = scatter_desugared(256);
+    }
+    put_int(x);
+    return 0;
+}
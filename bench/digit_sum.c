@@ -0,0 +1,19 @@
+int put_int(int x);
+
+int digit_sum(int n) {
+    int s = 0;
+    while (n != 0) {
+        s += n % 10;
+        n = n / 10;
+    }
+    return s;
+}
+
+int main() {
+    int i = 0, acc = 0;
+    for (i = -1000000; i < 1000000; i++) {
+        acc = acc + digit_sum(i * 1013) + i % 7 + i / 60;
+    }
+    put_int(acc);
+    return 0;
+}
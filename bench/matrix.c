@@ -0,0 +1,33 @@
+int put_int(int x);
+
+int a[64][64];
+int b[64][64];
+int c[64][64];
+
+int main() {
+    int i = 0, j = 0, k = 0, round = 0, acc = 0;
+    for (i = 0; i < 64; i++) {
+        for (j = 0; j < 64; j++) {
+            a[i][j] = i + j;
+            b[i][j] = i - j;
+        }
+    }
+    for (round = 0; round < 32; round++) {
+        for (i = 0; i < 64; i++) {
+            for (j = 0; j < 64; j++) {
+                int s = 0;
+                for (k = 0; k < 64; k++) {
+                    s += a[i][k] * b[k][j];
+                }
+                c[i][j] = s + round;
+            }
+        }
+        for (i = 0; i < 64; i++) {
+            for (j = 0; j < 64; j++) {
+                acc = acc ^ (c[i][j] + i * 64 + j);
+            }
+        }
+    }
+    put_int(acc);
+    return 0;
+}
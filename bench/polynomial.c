@@ -0,0 +1,18 @@
+int put_int(int x);
+
+int horner(int x) {
+    return ((((3*x + 5)*x - 7)*x + 11)*x - 13)*x + 17;
+}
+
+int expanded(int x) {
+    return 3*x*x*x*x*x + 5*x*x*x*x - 7*x*x*x + 11*x*x - 13*x + 17;
+}
+
+int main() {
+    int i = 0, acc = 0;
+    for (i = 0; i < 2000000; i++) {
+        acc = acc ^ horner(i & 63) ^ expanded(i & 31);
+    }
+    put_int(acc);
+    return 0;
+}
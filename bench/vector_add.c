@@ -0,0 +1,23 @@
+int put_int(int x);
+
+int x[4096];
+int y[4096];
+int z[4096];
+
+int main() {
+    int i = 0, round = 0, acc = 0;
+    for (i = 0; i < 4096; i++) {
+        x[i] = i * 3;
+        y[i] = 4096 - i;
+    }
+    for (round = 0; round < 20000; round++) {
+        for (i = 0; i < 4096; i++) {
+            z[i] = x[i] + y[i] + round;
+        }
+        for (i = 0; i < 4096; i++) {
+            acc += z[i];
+        }
+    }
+    put_int(acc);
+    return 0;
+}
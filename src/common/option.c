@@ -0,0 +1,97 @@
+#include "option.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "memory.h"
+
+
+// option-value
+int parse_option_integer(char* arg, char* value);
+
+// assertion
+void invalid_option_error(char* arg);
+void invalid_arguments_error();
+
+
+// option
+Option* option_new() {
+    Option* option = (Option*)safe_malloc(sizeof(Option));
+    option->input_filename = NULL;
+    option->output_filename = NULL;
+    option->opt_level = 0;
+    option->emit_ir = 0;
+    option->peephole_stats = 0;
+    option->licm_report = 0;
+    option->dce_report = 0;
+    option->inline_threshold = 32;
+    option->inline_report = 0;
+    option->omit_frame_pointer = 1;
+    option->vector_width = 16;
+    return option;
+}
+
+void option_parse(Option* option, int argc, char* argv[]) {
+    int i = 0;
+    for (i = 1; i < argc; i++) {
+        char* arg = argv[i];
+        if (arg[0] != '-') {
+            if (option->input_filename == NULL)       option->input_filename = arg;
+            else if (option->output_filename == NULL) option->output_filename = arg;
+            else                                      invalid_arguments_error();
+        } else if (strcmp(arg, "-O0") == 0) {
+            option->opt_level = 0;
+        } else if (strcmp(arg, "-O1") == 0) {
+            option->opt_level = 1;
+        } else if (strcmp(arg, "-O2") == 0) {
+            option->opt_level = 2;
+        } else if (strcmp(arg, "--emit-ir") == 0) {
+            option->emit_ir = 1;
+        } else if (strcmp(arg, "--peephole-stats") == 0) {
+            option->peephole_stats = 1;
+        } else if (strcmp(arg, "--licm-report") == 0) {
+            option->licm_report = 1;
+        } else if (strcmp(arg, "--dce-report") == 0) {
+            option->dce_report = 1;
+        } else if (strncmp(arg, "--inline-threshold=", 19) == 0) {
+            option->inline_threshold = parse_option_integer(arg, arg + 19);
+        } else if (strcmp(arg, "--inline-report") == 0) {
+            option->inline_report = 1;
+        } else if (strcmp(arg, "--no-omit-frame-pointer") == 0) {
+            option->omit_frame_pointer = 0;
+        } else if (strcmp(arg, "--avx2") == 0) {
+            option->vector_width = 32;
+        } else if (strcmp(arg, "--no-vectorize") == 0) {
+            option->vector_width = 0;
+        } else {
+            invalid_option_error(arg);
+        }
+    }
+    if (option->input_filename == NULL || option->output_filename == NULL) {
+        invalid_arguments_error();
+    }
+}
+
+void option_delete(Option* option) {
+    if (option == NULL) return;
+    free(option);
+}
+
+// option-value
+int parse_option_integer(char* arg, char* value) {
+    char* end = NULL;
+    long parsed = strtol(value, &end, 10);
+    if (*value == '\0' || *end != '\0' || parsed < 0 || parsed > 1 << 20) invalid_option_error(arg);
+    return (int)parsed;
+}
+
+// assertion
+void invalid_option_error(char* arg) {
+    fprintf(stderr, "Error: unknown option '%s'\n", arg);
+    exit(1);
+}
+
+void invalid_arguments_error() {
+    fprintf(stderr, "Error: invalid command-line arguments\n");
+    exit(1);
+}
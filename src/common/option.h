@@ -0,0 +1,26 @@
+#ifndef _OPTION_H_
+#define _OPTION_H_
+
+
+typedef struct {
+    char* input_filename;
+    char* output_filename;
+    int opt_level;
+    int emit_ir;
+    int peephole_stats;
+    int licm_report;
+    int dce_report;
+    int inline_threshold;
+    int inline_report;
+    int omit_frame_pointer;
+    int vector_width;
+} Option;
+
+
+// option
+Option* option_new();
+void option_parse(Option* option, int argc, char* argv[]);
+void option_delete(Option* option);
+
+
+#endif  // _OPTION_H_
@@ -0,0 +1,206 @@
+#include "asminst.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../common/memory.h"
+
+
+typedef struct {
+    char* name;
+    int reg;
+    int width;
+} AsmRegister;
+
+AsmRegister asm_registers[] = {
+    { "rax", 0, 8 },  { "eax", 0, 4 },   { "ax", 0, 2 },    { "al", 0, 1 },
+    { "rbx", 1, 8 },  { "ebx", 1, 4 },   { "bx", 1, 2 },    { "bl", 1, 1 },
+    { "rcx", 2, 8 },  { "ecx", 2, 4 },   { "cx", 2, 2 },    { "cl", 2, 1 },
+    { "rdx", 3, 8 },  { "edx", 3, 4 },   { "dx", 3, 2 },    { "dl", 3, 1 },
+    { "rsi", 4, 8 },  { "esi", 4, 4 },   { "si", 4, 2 },    { "sil", 4, 1 },
+    { "rdi", 5, 8 },  { "edi", 5, 4 },   { "di", 5, 2 },    { "dil", 5, 1 },
+    { "rbp", 6, 8 },  { "ebp", 6, 4 },   { "bp", 6, 2 },    { "bpl", 6, 1 },
+    { "rsp", 7, 8 },  { "esp", 7, 4 },   { "sp", 7, 2 },    { "spl", 7, 1 },
+    { "r8", 8, 8 },   { "r8d", 8, 4 },   { "r8w", 8, 2 },   { "r8b", 8, 1 },
+    { "r9", 9, 8 },   { "r9d", 9, 4 },   { "r9w", 9, 2 },   { "r9b", 9, 1 },
+    { "r10", 10, 8 }, { "r10d", 10, 4 }, { "r10w", 10, 2 }, { "r10b", 10, 1 },
+    { "r11", 11, 8 }, { "r11d", 11, 4 }, { "r11w", 11, 2 }, { "r11b", 11, 1 },
+    { "r12", 12, 8 }, { "r12d", 12, 4 }, { "r12w", 12, 2 }, { "r12b", 12, 1 },
+    { "r13", 13, 8 }, { "r13d", 13, 4 }, { "r13w", 13, 2 }, { "r13b", 13, 1 },
+    { "r14", 14, 8 }, { "r14d", 14, 4 }, { "r14w", 14, 2 }, { "r14b", 14, 1 },
+    { "r15", 15, 8 }, { "r15d", 15, 4 }, { "r15w", 15, 2 }, { "r15b", 15, 1 },
+    { NULL, 0, 0 }
+};
+
+
+// asm-inst
+AsmInst* asm_inst_new_empty(AsmInstType type, char* opcode);
+void split_operands(AsmInst* inst, char* text);
+
+// asm-operand
+AsmRegister* find_register(char* name, size_t len);
+
+
+// asm-inst
+AsmInst* asm_inst_parse(char* code) {
+    size_t len = strlen(code);
+    if (len > 0 && code[len - 1] == '\n') len--;
+
+    if (code[0] != '\t' && len > 0 && code[len - 1] == ':') {
+        char* label = (char*)safe_malloc(len * sizeof(char));
+        strncpy(label, code, len - 1);
+        label[len - 1] = '\0';
+        return asm_inst_new_empty(ASM_INST_LABEL, label);
+    }
+    if (code[0] != '\t' || code[1] == '.' || strchr(code, '"') != NULL) {
+        return asm_inst_new_empty(ASM_INST_DIRECTIVE, str_new(code));
+    }
+
+    char* text = (char*)safe_malloc(len * sizeof(char));
+    strncpy(text, code + 1, len - 1);
+    text[len - 1] = '\0';
+    char* space = strchr(text, ' ');
+    if (space != NULL) *space = '\0';
+
+    AsmInst* inst = asm_inst_new_empty(ASM_INST_OP, str_new(text));
+    if (space != NULL) split_operands(inst, space + 1);
+    free(text);
+    return inst;
+}
+
+AsmInst* asm_inst_new(char* opcode, size_t num_operands, ...) {
+    AsmInst* inst = asm_inst_new_empty(ASM_INST_OP, str_new(opcode));
+    va_list list;
+    va_start(list, num_operands);
+    size_t i = 0;
+    for (i = 0; i < num_operands; i++) {
+        vector_push_back(inst->operands, str_new(va_arg(list, char*)));
+    }
+    va_end(list);
+    return inst;
+}
+
+AsmInst* asm_inst_new_empty(AsmInstType type, char* opcode) {
+    AsmInst* inst = (AsmInst*)safe_malloc(sizeof(AsmInst));
+    inst->type = type;
+    inst->opcode = opcode;
+    inst->operands = vector_new();
+    return inst;
+}
+
+void split_operands(AsmInst* inst, char* text) {
+    int depth = 0;
+    char* begin = text;
+    char* p = text;
+    for (p = text; ; p++) {
+        if (*p == '(') depth++;
+        if (*p == ')') depth--;
+        if (*p != '\0' && (*p != ',' || depth > 0)) continue;
+
+        while (*begin == ' ') begin++;
+        size_t len = p - begin;
+        char* operand = (char*)safe_malloc((len + 1) * sizeof(char));
+        strncpy(operand, begin, len);
+        operand[len] = '\0';
+        vector_push_back(inst->operands, operand);
+
+        if (*p == '\0') break;
+        begin = p + 1;
+    }
+}
+
+char* asm_inst_render(AsmInst* inst) {
+    if (inst->type == ASM_INST_DIRECTIVE) return str_new(inst->opcode);
+
+    size_t len = strlen(inst->opcode) + 4;
+    size_t i = 0, size = inst->operands->size;
+    for (i = 0; i < size; i++) {
+        len += strlen(asm_inst_nth_operand(inst, i)) + 2;
+    }
+
+    char* code = (char*)safe_malloc(len * sizeof(char));
+    if (inst->type == ASM_INST_LABEL) {
+        sprintf(code, "%s:\n", inst->opcode);
+        return code;
+    }
+    sprintf(code, "\t%s", inst->opcode);
+    for (i = 0; i < size; i++) {
+        strcat(code, i == 0 ? " " : ", ");
+        strcat(code, asm_inst_nth_operand(inst, i));
+    }
+    strcat(code, "\n");
+    return code;
+}
+
+char* asm_inst_nth_operand(AsmInst* inst, size_t n) {
+    return (char*)vector_at(inst->operands, n);
+}
+
+void asm_inst_set_nth_operand(AsmInst* inst, size_t n, char* operand) {
+    free(vector_at(inst->operands, n));
+    vector_assign_at(inst->operands, n, operand);
+}
+
+int asm_inst_is(AsmInst* inst, char* opcode, size_t num_operands) {
+    return (
+        inst->type == ASM_INST_OP &&
+        strcmp(inst->opcode, opcode) == 0 &&
+        inst->operands->size == num_operands
+    );
+}
+
+void asm_inst_delete(AsmInst* inst) {
+    if (inst == NULL) return;
+
+    free(inst->opcode);
+    vector_delete(inst->operands);
+    free(inst);
+}
+
+// asm-operand
+int asm_operand_register(char* operand, int* width) {
+    if (operand[0] != '%') return -1;
+    AsmRegister* reg = find_register(operand + 1, strlen(operand + 1));
+    if (reg == NULL) return -1;
+    if (width != NULL) *width = reg->width;
+    return reg->reg;
+}
+
+int asm_operand_register_mask(char* operand) {
+    int mask = 0;
+    char* p = operand;
+    while ((p = strchr(p, '%')) != NULL) {
+        p++;
+        size_t len = 0;
+        while (('a' <= p[len] && p[len] <= 'z') || ('0' <= p[len] && p[len] <= '9')) len++;
+        AsmRegister* reg = find_register(p, len);
+        if (reg != NULL) mask |= 1 << reg->reg;
+        p += len;
+    }
+    return mask;
+}
+
+int asm_operand_is_imm(char* operand) {
+    return operand[0] == '$';
+}
+
+int asm_operand_is_memory(char* operand) {
+    return strchr(operand, '(') != NULL;
+}
+
+char* asm_register_name(int reg, int width) {
+    AsmRegister* p = asm_registers;
+    for (p = asm_registers; p->name != NULL; p++) {
+        if (p->reg == reg && p->width == width) return p->name;
+    }
+    return NULL;
+}
+
+AsmRegister* find_register(char* name, size_t len) {
+    AsmRegister* p = asm_registers;
+    for (p = asm_registers; p->name != NULL; p++) {
+        if (strlen(p->name) == len && strncmp(p->name, name, len) == 0) return p;
+    }
+    return NULL;
+}
@@ -0,0 +1,41 @@
+#ifndef _ASMINST_H_
+#define _ASMINST_H_
+
+
+#include "../common/vector.h"
+
+
+#define ASM_NUM_REGISTERS 16
+#define ASM_FLAGS_MASK (1 << ASM_NUM_REGISTERS)
+
+typedef enum {
+    ASM_INST_OP,
+    ASM_INST_LABEL,
+    ASM_INST_DIRECTIVE
+} AsmInstType;
+
+typedef struct {
+    AsmInstType type;
+    char* opcode;
+    Vector* operands;
+} AsmInst;
+
+
+// asm-inst
+AsmInst* asm_inst_parse(char* code);
+AsmInst* asm_inst_new(char* opcode, size_t num_operands, ...);
+char* asm_inst_render(AsmInst* inst);
+char* asm_inst_nth_operand(AsmInst* inst, size_t n);
+void asm_inst_set_nth_operand(AsmInst* inst, size_t n, char* operand);
+int asm_inst_is(AsmInst* inst, char* opcode, size_t num_operands);
+void asm_inst_delete(AsmInst* inst);
+
+// asm-operand
+int asm_operand_register(char* operand, int* width);
+int asm_operand_register_mask(char* operand);
+int asm_operand_is_imm(char* operand);
+int asm_operand_is_memory(char* operand);
+char* asm_register_name(int reg, int width);
+
+
+#endif  // _ASMINST_H_
@@ -10,16 +10,24 @@
 // assertion
 void code_limit_error();
 void label_limit_error();
+void temp_limit_error();
 
 
 // code-environment
-CodeEnv* codenv_new(char* funcname) {
+CodeEnv* codenv_new(char* funcname, Option* option) {
     CodeEnv* env = (CodeEnv*)safe_malloc(sizeof(CodeEnv));
     env->funcname = funcname;
     env->num_labels = 0;
+    env->num_temps = 0;
     env->continue_label = NULL;
     env->break_label = NULL;
+    env->entry_label = NULL;
+    env->tail_call_enabled = 0;
+    env->frame_pointer_omitted = 0;
+    env->temps = vector_new();
     env->codes = vector_new();
+    env->promoted_locals = NULL;
+    env->option = option;
     return env;
 }
 
@@ -34,13 +42,27 @@ char* codenv_create_label(CodeEnv* env) {
     return label;
 }
 
+char* codenv_create_temp(CodeEnv* env) {
+    if (env->num_temps == 1 << 30) {
+        temp_limit_error();
+        return NULL;
+    }
+    char* temp = safe_malloc(sizeof(char) * (2 + 11 + 1));
+    sprintf(temp, "%%v%d", env->num_temps);
+    env->num_temps++;
+    return temp;
+}
+
 void codenv_delete(CodeEnv* env) {
     if (env == NULL) return;
 
     free(env->funcname);
     free(env->continue_label);
     free(env->break_label);
+    free(env->entry_label);
+    vector_delete(env->temps);
     vector_delete(env->codes);
+    map_delete(env->promoted_locals);
     free(env);
 }
 
@@ -67,3 +89,8 @@ void label_limit_error() {
     fprintf(stderr, "Error: cannot create new label\n");
     exit(1);
 }
+
+void temp_limit_error() {
+    fprintf(stderr, "Error: cannot create new temporary\n");
+    exit(1);
+}
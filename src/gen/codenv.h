@@ -2,21 +2,31 @@
 #define _CODENV_H_
 
 
+#include "../common/map.h"
+#include "../common/option.h"
 #include "../common/vector.h"
 
 
 typedef struct {
     char* funcname;
     int num_labels;
+    int num_temps;
     char* continue_label;
     char* break_label;
+    char* entry_label;
+    int tail_call_enabled;
+    int frame_pointer_omitted;
+    Vector* temps;
     Vector* codes;
+    Map* promoted_locals;
+    Option* option;
 } CodeEnv;
 
 
 // code-environment
-CodeEnv* codenv_new(char* funcname);
+CodeEnv* codenv_new(char* funcname, Option* option);
 char* codenv_create_label(CodeEnv* env);
+char* codenv_create_temp(CodeEnv* env);
 void codenv_delete(CodeEnv* env);
 void append_code(Vector* codes, char* format, ...);
 
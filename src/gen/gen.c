@@ -3,13 +3,23 @@
 #include <stdlib.h>
 #include <string.h>
 #include "codenv.h"
+#include "genutil.h"
+#include "irgen.h"
+#include "peephole.h"
+#include "promote.h"
+#include "regalloc.h"
+#include "../ir/lower.h"
+#include "../ir/optimize.h"
+#include "../ir/strength.h"
 #include "../parser/localtable.h"
 #include "../common/memory.h"
 
 
-char* arg_register1[] = { "%dil", "%sil", "%dl",  "%cl",  "%r8b", "%r9b" };
-char *arg_register4[] = { "%edi", "%esi", "%edx", "%ecx", "%r8d", "%r9d" };
-char* arg_register8[] = { "%rdi", "%rsi", "%rdx", "%rcx", "%r8",  "%r9"  };
+#define TEMPLATE_ALIGNMENT 16
+#define ARRAY_ALIGNMENT 16
+#define CACHE_LINE_SIZE 64
+#define MIN_ZERO_RUN 16
+#define QUADS_PER_LINE 8
 
 
 void put_code(FILE* file_ptr, Vector* codes);
@@ -29,6 +39,11 @@ void gen_logical_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
 void gen_assignment_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
 void gen_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
 
+// branch-code-generator
+void gen_branch_code(Ast* ast, int jump_if_true, char* label, LocalTable* local_table, CodeEnv* env);
+void gen_comparison_branch_code(Ast* ast, int jump_if_true, char* label, LocalTable* local_table, CodeEnv* env);
+char* condition_code_of(AstType type, int jump_if_true);
+
 // statement-code-generator
 void gen_compound_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
 void gen_expr_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
@@ -37,6 +52,11 @@ void gen_iteration_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
 void gen_jump_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
 void gen_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
 
+// tail-call-code-generator
+void gen_tail_call_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
+int has_escaping_locals(Ast* ast, LocalTable* local_table);
+int has_self_tail_call(Ast* ast, char* funcname);
+
 // declaration-code-generator
 void gen_declaration_list_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
 void gen_declaration_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
@@ -61,22 +81,42 @@ void gen_array_initializer_code(
 // external-declaration-generator
 void gen_global_variable_code(GlobalVariable* gloval_variable, Vector* codes);
 void gen_global_data_code(GlobalData* global_data, Vector* codes);
-void gen_function_definition_code(Ast* ast, Vector* codes);
+void gen_global_bytes_code(GlobalData* global_data, Vector* codes);
+void gen_function_definition_code(Ast* ast, Vector* codes, Option* option);
 
 // utils
 void gen_address_code(Ast* ast, LocalTable* local_table, CodeEnv* env);
+void gen_call_args_code(Ast* arg_list, LocalTable* local_table, CodeEnv* env);
+void gen_push_temp_code(char* src, CodeEnv* env);
+void gen_push_imm_code(int value, CodeEnv* env);
+void gen_pop_temp_code(char* dest, CodeEnv* env);
+void gen_discard_temp_code(CodeEnv* env);
 void gen_load_code(CType* ctype, CodeEnv* env);
 void gen_store_code(CType* ctype, CodeEnv* env);
 void gen_store_arg_code(int arg_index, CType* ctype, CodeEnv* env);
+void gen_truncate_code(CType* ctype, CodeEnv* env);
 void gen_inc_code(CType* ctype, CodeEnv* env);
 void gen_dec_code(CType* ctype, CodeEnv* env);
+void gen_read_modify_write_code(AstType type, CType* ctype, char* dest, CodeEnv* env);
+void gen_pointer_offset_code(char* reg4, char* reg, int size, CodeEnv* env);
+void gen_constant_multiplication_code(int value, CodeEnv* env);
 char* create_size_label(int size);
-
-// assertion
-void assert_code_gen(int condition);
-
-
-void print_code(FILE* file_ptr, AstList* astlist) {
+int is_string_literal_data(GlobalData* global_data);
+int is_zero_data(GlobalData* global_data);
+int zero_run_length(unsigned char* bytes, int offset, int size);
+int global_alignment_of(CType* ctype);
+
+// promoted-local
+int find_promoted_register(Ast* ast, LocalTable* local_table, CodeEnv* env);
+void gen_promoted_assignment_code(AstType type, CType* ctype, int reg_index, CodeEnv* env);
+void gen_promoted_store_code(CType* ctype, int reg_index, CodeEnv* env);
+void gen_promoted_store_arg_code(int arg_index, CType* ctype, int reg_index, CodeEnv* env);
+void gen_promoted_step_code(AstType type, CType* ctype, int reg_index, CodeEnv* env);
+void gen_promoted_truncate_code(CType* ctype, int reg_index, CodeEnv* env);
+char* sized_promoted_register(int size, int reg_index);
+
+
+void print_code(FILE* file_ptr, AstList* astlist, Option* option) {
     Vector* codes = vector_new();
 
     while (1) {
@@ -85,13 +125,24 @@ void print_code(FILE* file_ptr, AstList* astlist) {
         gen_global_variable_code(global_variable, codes);
         global_list_pop(astlist->global_list);
     }
-    while (1) {
-        Ast* ast = astlist_top(astlist);
-        if (ast == NULL) break;
-        gen_function_definition_code(ast, codes);
-        astlist_pop(astlist);
+    if (option->opt_level >= 2) {
+        IrModule* module = lower_astlist(astlist, option->vector_width);
+        optimize_ir_module(module, option);
+        size_t i = 0, size = module->functions->size;
+        for (i = 0; i < size; i++) {
+            gen_ir_function_code((IrFunction*)vector_at(module->functions, i), codes, option);
+        }
+        ir_module_delete(module);
+    } else {
+        while (1) {
+            Ast* ast = astlist_top(astlist);
+            if (ast == NULL) break;
+            gen_function_definition_code(ast, codes, option);
+            astlist_pop(astlist);
+        }
     }
 
+    if (option->opt_level >= 1) optimize_peephole(codes, option);
     put_code(file_ptr, codes);
     vector_delete(codes);
     astlist->global_list->pos = 0;
@@ -108,14 +159,21 @@ void put_code(FILE* file_ptr, Vector* codes) {
 
 // expression-code-generator
 void gen_primary_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
+    int reg_index = -1;
+
     switch (ast->type) {
         case AST_IMM_INT:
-            append_code(env->codes, "\tpush $%d\n", ast->value_int);
+            gen_push_imm_code(ast->value_int, env);
             break;
         case AST_IDENT:
+            reg_index = find_promoted_register(ast, local_table, env);
+            if (reg_index >= 0) {
+                gen_push_temp_code(callee_saved_register8[reg_index], env);
+                break;
+            }
             gen_address_code(ast, local_table, env);
             gen_load_code(ast->ctype, env);
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             break;
         default:
             assert_code_gen(0);
@@ -130,26 +188,24 @@ void gen_postfix_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
             // TODO: callable object not only an ident
             assert_code_gen(callable->type == AST_IDENT);
 
-            size_t i = 0, num_args = arg_list->children->size;
-            // TODO: more than six arguments
-            assert_code_gen(num_args <= 6);
-            for (i = 0; i < num_args; i++) {
-                gen_expr_code(ast_nth_child(arg_list, i), local_table, env);
-            }
-            for (i = 0; i < num_args; i++) {
-                append_code(env->codes, "\tpop %s\n", arg_register8[num_args - i - 1]);
-            }
+            gen_call_args_code(arg_list, local_table, env);
             append_code(env->codes, "\tcall _%s\n", callable->value_ident);
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             break;
         }
         case AST_POST_INCR:
         case AST_POST_DECR: {
             Ast* child = ast_nth_child(ast, 0);
+            int reg_index = find_promoted_register(child, local_table, env);
+            if (reg_index >= 0) {
+                gen_push_temp_code(callee_saved_register8[reg_index], env);
+                gen_promoted_step_code(ast->type, child->ctype, reg_index, env);
+                break;
+            }
             gen_address_code(child, local_table, env);
             append_code(env->codes, "\tmov %%rax, %%rdi\n");
             gen_load_code(child->ctype, env);
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             if (ast->type == AST_POST_INCR) gen_inc_code(child->ctype, env);
             else                            gen_dec_code(child->ctype, env);
             gen_store_code(ast->ctype, env);
@@ -162,50 +218,57 @@ void gen_postfix_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
 
 void gen_unary_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     Ast* child = ast_nth_child(ast, 0);
+    int reg_index = -1;
 
     switch (ast->type) {
         case AST_PRE_INCR:
         case AST_PRE_DECR:
+            reg_index = find_promoted_register(child, local_table, env);
+            if (reg_index >= 0) {
+                gen_promoted_step_code(ast->type, child->ctype, reg_index, env);
+                gen_push_temp_code(callee_saved_register8[reg_index], env);
+                break;
+            }
             gen_address_code(child, local_table, env);
             append_code(env->codes, "\tmov %%rax, %%rdi\n");
             gen_load_code(child->ctype, env);
             if (ast->type == AST_PRE_INCR) gen_inc_code(child->ctype, env);
             else                           gen_dec_code(child->ctype, env);
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             gen_store_code(ast->ctype, env);
             break;
         case AST_ADDR:
             gen_address_code(child, local_table, env);
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             break;
         case AST_DEREF:
             gen_expr_code(child, local_table, env);
-            append_code(env->codes, "\tpop %%rax\n");
+            gen_pop_temp_code("%rax", env);
             gen_load_code(ast->ctype, env);
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             break;
         case AST_POSI:
             gen_expr_code(child, local_table, env);
             break;
         case AST_NEGA:
             gen_expr_code(child, local_table, env);
-            append_code(env->codes, "\tpop %%rax\n");
+            gen_pop_temp_code("%rax", env);
             append_code(env->codes, "\tneg %%eax\n");
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             break;
         case AST_NOT:
             gen_expr_code(child, local_table, env);
-            append_code(env->codes, "\tpop %%rax\n");
+            gen_pop_temp_code("%rax", env);
             append_code(env->codes, "\tnot %%eax\n");
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             break;
         case AST_LNOT:
             gen_expr_code(child, local_table, env);
-            append_code(env->codes, "\tpop %%rax\n");
+            gen_pop_temp_code("%rax", env);
             append_code(env->codes, "\tcmp $0, %%eax\n");
             append_code(env->codes, "\tsete %%al\n");
             append_code(env->codes, "\tmovzb %%al, %%eax\n");
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             break;
         default:
             assert_code_gen(0);
@@ -218,7 +281,7 @@ void gen_cast_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     switch (ast->type) {
         case AST_ARRAY_TO_PTR:
             gen_address_code(child, local_table, env);
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             break;
         default:
             assert_code_gen(0);  
@@ -226,25 +289,44 @@ void gen_cast_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
 }
 
 void gen_multiplicative_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
-    gen_expr_code(ast_nth_child(ast, 0), local_table, env);
-    gen_expr_code(ast_nth_child(ast, 1), local_table, env);
+    Ast* lhs = ast_nth_child(ast, 0);
+    Ast* rhs = ast_nth_child(ast, 1);
+    int reduce_constants = env->option->opt_level >= 1;
+    if (reduce_constants && ast->type == AST_MUL && (lhs->type == AST_IMM_INT || rhs->type == AST_IMM_INT)) {
+        Ast* constant = rhs->type == AST_IMM_INT ? rhs : lhs;
+        gen_expr_code(constant == rhs ? lhs : rhs, local_table, env);
+        gen_pop_temp_code("%rax", env);
+        gen_constant_multiplication_code(constant->value_int, env);
+        gen_push_temp_code("%rax", env);
+        return;
+    }
+    if (reduce_constants && (ast->type == AST_DIV || ast->type == AST_MOD) && rhs->type == AST_IMM_INT) {
+        gen_expr_code(lhs, local_table, env);
+        gen_pop_temp_code("%rax", env);
+        gen_constant_division_code(rhs->value_int, ast->type == AST_MOD, env);
+        gen_push_temp_code("%rax", env);
+        return;
+    }
+
+    gen_expr_code(lhs, local_table, env);
+    gen_expr_code(rhs, local_table, env);
 
-    append_code(env->codes, "\tpop %%rdi\n");
-    append_code(env->codes, "\tpop %%rax\n");
+    gen_pop_temp_code("%rdi", env);
+    gen_pop_temp_code("%rax", env);
     switch (ast->type) {
         case AST_MUL:
             append_code(env->codes, "\timul %%edi, %%eax\n");
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             break;
         case AST_DIV:
             append_code(env->codes, "\tcdq\n");
             append_code(env->codes, "\tidiv %%edi\n");
-            append_code(env->codes, "\tpush %%rax\n");
+            gen_push_temp_code("%rax", env);
             break;
         case AST_MOD:
             append_code(env->codes, "\tcltd\n");
             append_code(env->codes, "\tidiv %%edi\n");
-            append_code(env->codes, "\tpush %%rdx\n");
+            gen_push_temp_code("%rdx", env);
             break;
         default:
             assert_code_gen(0);
@@ -259,8 +341,8 @@ void gen_additive_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     BasicCType lhs_basic_ctype = lhs->ctype->basic_ctype;
     BasicCType rhs_basic_ctype = rhs->ctype->basic_ctype;
 
-    append_code(env->codes, "\tpop %%rdi\n");
-    append_code(env->codes, "\tpop %%rax\n");
+    gen_pop_temp_code("%rdi", env);
+    gen_pop_temp_code("%rax", env);
     switch (ast->type) {
         case AST_ADD:
             if (
@@ -268,21 +350,21 @@ void gen_additive_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
                 rhs_basic_ctype == CTYPE_INT
             ) {
                 append_code(env->codes, "\tadd %%edi, %%eax\n");
-                append_code(env->codes, "\tpush %%rax\n");
+                gen_push_temp_code("%rax", env);
             } else if (
                 lhs_basic_ctype == CTYPE_PTR &&
                 rhs_basic_ctype == CTYPE_INT
             ) {
-                append_code(env->codes, "\timul $%d, %%rdi\n", lhs->ctype->ptr_to->size);
+                gen_pointer_offset_code("%edi", "%rdi", lhs->ctype->ptr_to->size, env);
                 append_code(env->codes, "\tadd %%rdi, %%rax\n");
-                append_code(env->codes, "\tpush %%rax\n");
+                gen_push_temp_code("%rax", env);
             } else if (
                 lhs_basic_ctype == CTYPE_INT &&
                 rhs_basic_ctype == CTYPE_PTR
             ) {
-                append_code(env->codes, "\timul $%d, %%rax\n", rhs->ctype->ptr_to->size);
+                gen_pointer_offset_code("%eax", "%rax", rhs->ctype->ptr_to->size, env);
                 append_code(env->codes, "\tadd %%rdi, %%rax\n");
-                append_code(env->codes, "\tpush %%rax\n");
+                gen_push_temp_code("%rax", env);
             } else {
                 assert_code_gen(0);
             }
@@ -293,24 +375,30 @@ void gen_additive_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
                 rhs_basic_ctype == CTYPE_INT
             ) {
                 append_code(env->codes, "\tsub %%edi, %%eax\n");
-                append_code(env->codes, "\tpush %%rax\n");
+                gen_push_temp_code("%rax", env);
             } else if (
                 lhs_basic_ctype == CTYPE_PTR &&
                 rhs_basic_ctype == CTYPE_INT
             ) {
-                append_code(env->codes, "\timul $%d, %%rdi\n", lhs->ctype->ptr_to->size);
+                gen_pointer_offset_code("%edi", "%rdi", lhs->ctype->ptr_to->size, env);
                 append_code(env->codes, "\tsub %%rdi, %%rax\n");
-                append_code(env->codes, "\tpush %%rax\n");
+                gen_push_temp_code("%rax", env);
             } else if (
                 lhs_basic_ctype == CTYPE_PTR &&
                 rhs_basic_ctype == CTYPE_PTR &&
                 ctype_equals(lhs->ctype->ptr_to, rhs->ctype->ptr_to)
             ) {
+                int size = lhs->ctype->ptr_to->size;
+                int shift = exact_log2(size);
                 append_code(env->codes, "\tsub %%rdi, %%rax\n");
-                append_code(env->codes, "\tmov $%d, %%rdi\n", lhs->ctype->ptr_to->size);
-                append_code(env->codes, "\tcqo\n");
-                append_code(env->codes, "\tidiv %%rdi\n");
-                append_code(env->codes, "\tpush %%rax\n");
+                if (shift > 0) {
+                    append_code(env->codes, "\tsar $%d, %%rax\n", shift);
+                } else if (shift < 0) {
+                    append_code(env->codes, "\tmov $%d, %%rdi\n", size);
+                    append_code(env->codes, "\tcqo\n");
+                    append_code(env->codes, "\tidiv %%rdi\n");
+                }
+                gen_push_temp_code("%rax", env);
             } else {
                 assert_code_gen(0);
             }
@@ -324,8 +412,8 @@ void gen_shift_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     gen_expr_code(ast_nth_child(ast, 0), local_table, env);
     gen_expr_code(ast_nth_child(ast, 1), local_table, env);
 
-    append_code(env->codes, "\tpop %%rcx\n");
-    append_code(env->codes, "\tpop %%rax\n");
+    gen_pop_temp_code("%rcx", env);
+    gen_pop_temp_code("%rax", env);
     switch (ast->type) {
         case AST_LSHIFT:
             append_code(env->codes, "\tsal %%cl, %%eax\n");
@@ -336,15 +424,15 @@ void gen_shift_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
         default:
             assert_code_gen(0);
     }
-    append_code(env->codes, "\tpush %%rax\n");
+    gen_push_temp_code("%rax", env);
 }
 
 void gen_equality_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     gen_expr_code(ast_nth_child(ast, 0), local_table, env);
     gen_expr_code(ast_nth_child(ast, 1), local_table, env);
 
-    append_code(env->codes, "\tpop %%rdi\n");
-    append_code(env->codes, "\tpop %%rax\n");
+    gen_pop_temp_code("%rdi", env);
+    gen_pop_temp_code("%rax", env);
     switch (ast->ctype->size) {
         case 4:
             append_code(env->codes, "\tcmp %%edi, %%eax\n");
@@ -366,15 +454,15 @@ void gen_equality_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
             assert_code_gen(0);
     }
     append_code(env->codes, "\tmovzb %%al, %%eax\n");
-    append_code(env->codes, "\tpush %%rax\n");
+    gen_push_temp_code("%rax", env);
 }
 
 void gen_relational_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     gen_expr_code(ast_nth_child(ast, 0), local_table, env);
     gen_expr_code(ast_nth_child(ast, 1), local_table, env);
 
-    append_code(env->codes, "\tpop %%rdi\n");
-    append_code(env->codes, "\tpop %%rax\n");
+    gen_pop_temp_code("%rdi", env);
+    gen_pop_temp_code("%rax", env);
     switch (ast->ctype->size) {
         case 4:
             append_code(env->codes, "\tcmp %%edi, %%eax\n");
@@ -402,15 +490,15 @@ void gen_relational_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
             assert_code_gen(0);
     }
     append_code(env->codes, "\tmovzb %%al, %%eax\n");
-    append_code(env->codes, "\tpush %%rax\n");
+    gen_push_temp_code("%rax", env);
 }
 
 void gen_bitwise_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     gen_expr_code(ast_nth_child(ast, 0), local_table, env);
     gen_expr_code(ast_nth_child(ast, 1), local_table, env);
 
-    append_code(env->codes, "\tpop %%rdi\n");
-    append_code(env->codes, "\tpop %%rax\n");
+    gen_pop_temp_code("%rdi", env);
+    gen_pop_temp_code("%rax", env);
     switch (ast->type) {
         case AST_OR:
             append_code(env->codes, "\tor %%edi, %%eax\n");
@@ -424,36 +512,22 @@ void gen_bitwise_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
         default:
             assert_code_gen(0);
     }
-    append_code(env->codes, "\tpush %%rax\n");
+    gen_push_temp_code("%rax", env);
 }
 
 void gen_logical_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
+    char* false_label = codenv_create_label(env);
     char* exit_label = codenv_create_label(env);
 
-    gen_expr_code(ast_nth_child(ast, 0), local_table, env);
-    append_code(env->codes, "\tpop %%rax\n");
-    append_code(env->codes, "\tcmp $0, %%rax\n");
-
-    switch (ast->type) {
-        case AST_LOR:
-            append_code(env->codes, "\tjne .L%s\n", exit_label);
-            break;
-        case AST_LAND:
-            append_code(env->codes, "\tje .L%s\n", exit_label);
-            break;
-        default:
-            assert_code_gen(0);
-    }
-
-    gen_expr_code(ast_nth_child(ast, 1), local_table, env);
-    append_code(env->codes, "\tpop %%rax\n");
-    append_code(env->codes, "\tcmp $0, %%rax\n");
-
+    gen_branch_code(ast, 0, false_label, local_table, env);
+    append_code(env->codes, "\tmov $1, %%eax\n");
+    append_code(env->codes, "\tjmp .L%s\n", exit_label);
+    append_code(env->codes, ".L%s:\n", false_label);
+    append_code(env->codes, "\tmov $0, %%eax\n");
     append_code(env->codes, ".L%s:\n", exit_label);
-    append_code(env->codes, "\tsetne %%al\n");
-    append_code(env->codes, "\tmovzb %%al, %%eax\n");
-    append_code(env->codes, "\tpush %%rax\n");
+    gen_push_temp_code("%rax", env);
 
+    free(false_label);
     free(exit_label);
 }
 
@@ -461,20 +535,57 @@ void gen_assignment_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     Ast* ident = ast_nth_child(ast, 0);
     Ast* expr = ast_nth_child(ast, 1);
     gen_expr_code(expr, local_table, env);
+
+    int reg_index = find_promoted_register(ident, local_table, env);
+    if (reg_index >= 0) {
+        gen_pop_temp_code("%rax", env);
+        gen_promoted_assignment_code(ast->type, ident->ctype, reg_index, env);
+        gen_push_temp_code("%rax", env);
+        return;
+    }
+
     gen_address_code(ident, local_table, env);
 
     append_code(env->codes, "\tmov %%rax, %%rdi\n");
-    append_code(env->codes, "\tpop %%rax\n");
+    gen_pop_temp_code("%rax", env);
 
     switch (ast->type) {
         case AST_ASSIGN:
+            gen_store_code(ident->ctype, env);
+            gen_truncate_code(ident->ctype, env);
+            break;
+        case AST_ADD_ASSIGN:
+        case AST_SUB_ASSIGN:
+        case AST_LSHIFT_ASSIGN:
+        case AST_RSHIFT_ASSIGN:
+        case AST_AND_ASSIGN:
+        case AST_XOR_ASSIGN:
+        case AST_OR_ASSIGN:
+            gen_read_modify_write_code(ast->type, ident->ctype, "(%rdi)", env);
+            append_code(env->codes, "\tmov %%rdi, %%rax\n");
+            gen_load_code(ident->ctype, env);
+            break;
+        case AST_MUL_ASSIGN:
+        case AST_DIV_ASSIGN:
+        case AST_MOD_ASSIGN:
+            append_code(env->codes, "\tmov %%eax, %%esi\n");
+            append_code(env->codes, "\tmov %%rdi, %%rax\n");
+            gen_load_code(ident->ctype, env);
+            if (ast->type == AST_MUL_ASSIGN) {
+                append_code(env->codes, "\timul %%esi, %%eax\n");
+            } else {
+                append_code(env->codes, "\tcltd\n");
+                append_code(env->codes, "\tidiv %%esi\n");
+                if (ast->type == AST_MOD_ASSIGN) append_code(env->codes, "\tmov %%edx, %%eax\n");
+            }
+            gen_store_code(ident->ctype, env);
+            gen_truncate_code(ident->ctype, env);
             break;
         default:
             assert_code_gen(0);
     }
 
-    gen_store_code(ident->ctype, env);
-    append_code(env->codes, "\tpush %%rax\n");
+    gen_push_temp_code("%rax", env);
 }
 
 void gen_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
@@ -494,6 +605,87 @@ void gen_expr_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     else if (!is_null_expr(type))          assert_code_gen(0);  
 }
 
+// branch-code-generator
+void gen_branch_code(Ast* ast, int jump_if_true, char* label, LocalTable* local_table, CodeEnv* env) {
+    switch (ast->type) {
+        case AST_IMM_INT:
+            if ((ast->value_int != 0) == jump_if_true) append_code(env->codes, "\tjmp .L%s\n", label);
+            break;
+        case AST_LNOT:
+            gen_branch_code(ast_nth_child(ast, 0), !jump_if_true, label, local_table, env);
+            break;
+        case AST_LAND:
+        case AST_LOR:
+            if (jump_if_true == (ast->type == AST_LOR)) {
+                gen_branch_code(ast_nth_child(ast, 0), jump_if_true, label, local_table, env);
+                gen_branch_code(ast_nth_child(ast, 1), jump_if_true, label, local_table, env);
+            } else {
+                char* skip_label = codenv_create_label(env);
+                gen_branch_code(ast_nth_child(ast, 0), !jump_if_true, skip_label, local_table, env);
+                gen_branch_code(ast_nth_child(ast, 1), jump_if_true, label, local_table, env);
+                append_code(env->codes, ".L%s:\n", skip_label);
+                free(skip_label);
+            }
+            break;
+        case AST_LT:
+        case AST_GT:
+        case AST_LEQ:
+        case AST_GEQ:
+        case AST_EQ:
+        case AST_NEQ:
+            gen_comparison_branch_code(ast, jump_if_true, label, local_table, env);
+            break;
+        default:
+            gen_expr_code(ast, local_table, env);
+            gen_pop_temp_code("%rax", env);
+            append_code(env->codes, "\tcmp $0, %%rax\n");
+            append_code(env->codes, "\t%s .L%s\n", jump_if_true ? "jne" : "je", label);
+            break;
+    }
+}
+
+void gen_comparison_branch_code(Ast* ast, int jump_if_true, char* label, LocalTable* local_table, CodeEnv* env) {
+    Ast* lhs = ast_nth_child(ast, 0);
+    Ast* rhs = ast_nth_child(ast, 1);
+    gen_expr_code(lhs, local_table, env);
+    gen_expr_code(rhs, local_table, env);
+
+    gen_pop_temp_code("%rdi", env);
+    gen_pop_temp_code("%rax", env);
+    int size = lhs->ctype->size > rhs->ctype->size ? lhs->ctype->size : rhs->ctype->size;
+    switch (size < ast->ctype->size ? ast->ctype->size : size) {
+        case 4:
+            append_code(env->codes, "\tcmp %%edi, %%eax\n");
+            break;
+        case 8:
+            append_code(env->codes, "\tcmp %%rdi, %%rax\n");
+            break;
+        default:
+            assert_code_gen(0);
+    }
+    append_code(env->codes, "\tj%s .L%s\n", condition_code_of(ast->type, jump_if_true), label);
+}
+
+char* condition_code_of(AstType type, int jump_if_true) {
+    switch (type) {
+        case AST_LT:
+            return jump_if_true ? "l" : "ge";
+        case AST_GT:
+            return jump_if_true ? "g" : "le";
+        case AST_LEQ:
+            return jump_if_true ? "le" : "g";
+        case AST_GEQ:
+            return jump_if_true ? "ge" : "l";
+        case AST_EQ:
+            return jump_if_true ? "e" : "ne";
+        case AST_NEQ:
+            return jump_if_true ? "ne" : "e";
+        default:
+            assert_code_gen(0);
+    }
+    return NULL;
+}
+
 // statement-code-generator
 void gen_compound_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     size_t i = 0, size = ast->children->size;
@@ -522,7 +714,7 @@ void gen_expr_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
             child = ast_nth_child(ast, 0);
             gen_expr_code(child, local_table, env);
             if (!is_null_expr(child->type)) {
-                append_code(env->codes, "\tadd $8, %%rsp\n");
+                gen_discard_temp_code(env);
             }
             break;
         default:
@@ -534,19 +726,16 @@ void gen_expr_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
 void gen_selection_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     switch (ast->type) {
         case AST_IF_STMT:
-            gen_expr_code(ast_nth_child(ast, 0), local_table, env);
-            append_code(env->codes, "\tpop %%rax\n");
-            append_code(env->codes, "\tcmp $0, %%rax\n");
             if (ast->children->size == 2) {
                 char* exit_label = codenv_create_label(env);
-                append_code(env->codes, "\tje .L%s\n", exit_label);
+                gen_branch_code(ast_nth_child(ast, 0), 0, exit_label, local_table, env);
                 gen_stmt_code(ast_nth_child(ast, 1), local_table, env);
                 append_code(env->codes, ".L%s:\n",   exit_label);
                 free(exit_label);
             } else {
                 char* else_label = codenv_create_label(env);
                 char* exit_label = codenv_create_label(env);
-                append_code(env->codes, "\tje .L%s\n", else_label);
+                gen_branch_code(ast_nth_child(ast, 0), 0, else_label, local_table, env);
                 gen_stmt_code(ast_nth_child(ast, 1), local_table, env);
                 append_code(env->codes, "\tjmp .L%s\n", exit_label);
                 append_code(env->codes, ".L%s:\n",   else_label);
@@ -577,48 +766,44 @@ void gen_iteration_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
 
     switch (ast->type) {
         case AST_WHILE_STMT: 
+            gen_branch_code(ast_nth_child(ast, 0), 0, exit_label, local_table, env);
             append_code(env->codes, ".L%s:\n", entry_label);
-            append_code(env->codes, ".L%s:\n", continue_label);
-            gen_expr_code(ast_nth_child(ast, 0), local_table, env);
-            append_code(env->codes, "\tpop %%rax\n");
-            append_code(env->codes, "\tcmp $0, %%rax\n");
-            append_code(env->codes, "\tje .L%s\n", exit_label);
             gen_stmt_code(ast_nth_child(ast, 1), local_table, env);
-            append_code(env->codes, "\tjmp .L%s\n", entry_label);
+            append_code(env->codes, ".L%s:\n", continue_label);
+            gen_branch_code(ast_nth_child(ast, 0), 1, entry_label, local_table, env);
             append_code(env->codes, ".L%s:\n", exit_label);
             break;
         case AST_DOWHILE_STMT:
             append_code(env->codes, ".L%s:\n", entry_label);
             gen_stmt_code(ast_nth_child(ast, 0), local_table, env);
             append_code(env->codes, ".L%s:\n", continue_label);
-            gen_expr_code(ast_nth_child(ast, 1), local_table, env);
-            append_code(env->codes, "\tpop %%rax\n");
-            append_code(env->codes, "\tcmp $0, %%rax\n");
-            append_code(env->codes, "\tjne .L%s\n", entry_label);
+            gen_branch_code(ast_nth_child(ast, 1), 1, entry_label, local_table, env);
             append_code(env->codes, ".L%s:\n", exit_label);
             break;
         case AST_FOR_STMT:
             child = ast_nth_child(ast, 0);
             gen_expr_code(child, local_table, env);
             if (!is_null_expr(child->type)) {
-                append_code(env->codes, "\tadd $8, %%rsp\n");
+                gen_discard_temp_code(env);
             }
-            append_code(env->codes, ".L%s:\n", entry_label);
             child = ast_nth_child(ast, 1);
-            gen_expr_code(child, local_table, env);
             if (!is_null_expr(child->type)) {
-                append_code(env->codes, "\tpop %%rax\n");
-                append_code(env->codes, "\tcmp $0, %%rax\n");
-                append_code(env->codes, "\tje .L%s\n", exit_label);
+                gen_branch_code(child, 0, exit_label, local_table, env);
             }
+            append_code(env->codes, ".L%s:\n", entry_label);
             gen_stmt_code(ast_nth_child(ast, 3), local_table, env);
             append_code(env->codes, ".L%s:\n", continue_label);
             child = ast_nth_child(ast, 2);
             gen_expr_code(child, local_table, env);
             if (!is_null_expr(child->type)) {
-                append_code(env->codes, "\tadd $8, %%rsp\n");
+                gen_discard_temp_code(env);
+            }
+            child = ast_nth_child(ast, 1);
+            if (!is_null_expr(child->type)) {
+                gen_branch_code(child, 1, entry_label, local_table, env);
+            } else {
+                append_code(env->codes, "\tjmp .L%s\n", entry_label);
             }
-            append_code(env->codes, "\tjmp .L%s\n", entry_label);
             append_code(env->codes, ".L%s:\n", exit_label);
             break;
         default:
@@ -645,8 +830,12 @@ void gen_jump_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
             append_code(env->codes, "\tjmp .L%s\n", env->break_label);
             break;
         case AST_RETURN_STMT:
+            if (env->tail_call_enabled && ast_nth_child(ast, 0)->type == AST_FUNC_CALL) {
+                gen_tail_call_code(ast_nth_child(ast, 0), local_table, env);
+                break;
+            }
             gen_expr_code(ast_nth_child(ast, 0), local_table, env);
-            append_code(env->codes, "\tpop %%rax\n");
+            gen_pop_temp_code("%rax", env);
             append_code(env->codes, "\tjmp .L_%s_return\n", env->funcname);
             break;
         default:
@@ -665,6 +854,57 @@ void gen_stmt_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     else                              assert_code_gen(0);  
 }
 
+// tail-call-code-generator
+void gen_tail_call_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
+    Ast* callable = ast_nth_child(ast, 0);
+    Ast* arg_list = ast_nth_child(ast, 1);
+    assert_code_gen(callable->type == AST_IDENT);
+
+    gen_call_args_code(arg_list, local_table, env);
+    if (strcmp(callable->value_ident, env->funcname) == 0) {
+        append_code(env->codes, "\tjmp .L%s\n", env->entry_label);
+    } else {
+        gen_tail_jump_code(callable->value_ident, env);
+    }
+}
+
+int has_escaping_locals(Ast* ast, LocalTable* local_table) {
+    if (ast == NULL) return 0;
+    if (ast->type == AST_COMP_STMT) local_table = ast->local_table;
+
+    if (ast->type == AST_ADDR || ast->type == AST_ARRAY_TO_PTR) {
+        Ast* child = ast_nth_child(ast, 0);
+        if (child->type == AST_IDENT && local_table_get_stack_index(local_table, child->value_ident) >= 0) {
+            return 1;
+        }
+    }
+
+    size_t i = 0, size = ast->children->size;
+    for (i = 0; i < size; i++) {
+        if (has_escaping_locals(ast_nth_child(ast, i), local_table)) return 1;
+    }
+    return 0;
+}
+
+int has_self_tail_call(Ast* ast, char* funcname) {
+    if (ast == NULL) return 0;
+
+    if (ast->type == AST_RETURN_STMT) {
+        Ast* child = ast_nth_child(ast, 0);
+        return child->type == AST_FUNC_CALL &&
+            strcmp(ast_nth_child(child, 0)->value_ident, funcname) == 0;
+    }
+    if (!is_compound_stmt(ast->type) && !is_selection_stmt(ast->type) && !is_iteration_stmt(ast->type)) {
+        return 0;
+    }
+
+    size_t i = 0, size = ast->children->size;
+    for (i = 0; i < size; i++) {
+        if (has_self_tail_call(ast_nth_child(ast, i), funcname)) return 1;
+    }
+    return 0;
+}
+
 // declaration-code-generator
 void gen_declaration_list_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     size_t i = 0, size = ast->children->size;
@@ -692,6 +932,14 @@ void gen_declaration_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
     }
     if (init == NULL) return;
 
+    int reg_index = find_promoted_register(ident, local_table, env);
+    if (reg_index >= 0) {
+        gen_expr_code(init, local_table, env);
+        gen_pop_temp_code("%rax", env);
+        gen_promoted_store_code(ident->ctype, reg_index, env);
+        return;
+    }
+
     int stack_index = local_table_get_stack_index(local_table, ident->value_ident);
     gen_initializer_code(init, ident->ctype, &stack_index, local_table, env);
 }
@@ -723,7 +971,7 @@ void gen_ident_initializer_code(
     LocalTable* local_table, CodeEnv* env
 ) {
     gen_expr_code(init, local_table, env);
-    append_code(env->codes, "\tpop %%rax\n");
+    gen_pop_temp_code("%rax", env);
     append_code(env->codes, "\tlea -%d(%%rbp), %%rdi\n", *stack_index);
     gen_store_code(ctype, env);
 
@@ -735,11 +983,25 @@ void gen_array_initializer_code(
     CType* ctype, int* stack_index,
     LocalTable* local_table, CodeEnv* env
 ) {
+    int end_index = *stack_index - ctype->size;
+    if (init->type == AST_IDENT) {
+        append_code(env->codes, "\tlea _%s(%%rip), %%rsi\n", init->value_ident);
+        append_code(env->codes, "\tlea -%d(%%rbp), %%rdi\n", *stack_index);
+        gen_block_copy_code(ctype->size, env);
+        *stack_index = end_index;
+        return;
+    }
+
     size_t i = 0, size = init->children->size;
     for (i = 0; i < size; i++) {
         Ast* child = ast_nth_child(init, i);
         gen_initializer_code(child, ctype->array_of, stack_index, local_table, env);
     }
+    if (*stack_index > end_index) {
+        append_code(env->codes, "\tlea -%d(%%rbp), %%rdi\n", *stack_index);
+        gen_block_zero_code(*stack_index - end_index, env);
+        *stack_index = end_index;
+    }
 }
 
 // external-declaration-generator
@@ -751,11 +1013,30 @@ void gen_global_variable_code(GlobalVariable* gloval_variable, Vector* codes) {
         return;
 
     char* variable_name = gloval_variable->symbol_name;
-    int align = 2;
+    if (gloval_variable->readonly) {
+        if (is_string_literal_data(gloval_variable->global_data)) {
+            append_code(codes, "\t.cstring\n");
+        } else {
+            append_code(codes, "\t.const\n");
+            append_code(codes, "\t.p2align %d\n", exact_log2(TEMPLATE_ALIGNMENT));
+        }
+        append_code(codes, "_%s:\n", variable_name);
+        gen_global_data_code(gloval_variable->global_data, codes);
+        return;
+    }
+
+    int align = global_alignment_of(gloval_variable->ctype);
     append_code(codes, "\t.text\n");
     append_code(codes, "\t.global _%s\n", variable_name);
+    if (is_zero_data(gloval_variable->global_data)) {
+        append_code(codes, "\t.bss\n");
+        append_code(codes, "\t.p2align %d\n", exact_log2(align));
+        append_code(codes, "_%s:\n", variable_name);
+        append_code(codes, "\t.zero %d\n", gloval_variable->ctype->size);
+        return;
+    }
     append_code(codes, "\t.data\n");
-    append_code(codes, "\t.align %d\n", align);
+    append_code(codes, "\t.p2align %d\n", exact_log2(align));
     append_code(codes, "_%s:\n", variable_name);
     gen_global_data_code(gloval_variable->global_data, codes);
 }
@@ -770,13 +1051,22 @@ void gen_global_data_code(GlobalData* global_data, Vector* codes) {
         }
         case GBL_TYPE_ADDR: {
             char* size_label = create_size_label(global_data->size);
-            append_code(codes, "\t%s _%s\n", size_label, global_data->address_of);
+            if (global_data->address_offset == 0) {
+                append_code(codes, "\t%s _%s\n", size_label, global_data->address_of);
+            } else {
+                append_code(
+                    codes, "\t%s _%s%+d\n", size_label, global_data->address_of, global_data->address_offset
+                );
+            }
             free(size_label);
             break;
         }
         case GBL_TYPE_STR:
             append_code(codes, "\t.ascii \"%s\\0\"\n", global_data->value_str);
             break;
+        case GBL_TYPE_BYTES:
+            gen_global_bytes_code(global_data, codes);
+            break;
         case GBL_TYPE_LIST: {
             size_t i = 0, size = global_data->children->size - 1;
             for (i = 0; i < size; i++) {
@@ -791,13 +1081,57 @@ void gen_global_data_code(GlobalData* global_data, Vector* codes) {
     }
 }
 
-void gen_function_definition_code(Ast* ast, Vector* codes) {
+void gen_global_bytes_code(GlobalData* global_data, Vector* codes) {
+    unsigned char* bytes = global_data->value_bytes;
+    int offset = 0, size = global_data->size;
+    char line[256];
+    while (offset < size) {
+        int num_zeros = zero_run_length(bytes, offset, size);
+        if (num_zeros >= MIN_ZERO_RUN || offset + num_zeros == size) {
+            append_code(codes, "\t.zero %d\n", num_zeros);
+            offset += num_zeros;
+            continue;
+        }
+
+        if (size - offset < 8) {
+            strcpy(line, "\t.byte ");
+            for (; offset < size; offset++) {
+                sprintf(line + strlen(line), "%d%s", bytes[offset], offset + 1 < size ? ", " : "");
+            }
+            append_code(codes, "%s\n", line);
+            break;
+        }
+
+        strcpy(line, "\t.quad ");
+        int i = 0, j = 0;
+        for (i = 0; i < QUADS_PER_LINE && size - offset >= 8; i++) {
+            if (i > 0 && zero_run_length(bytes, offset, size) >= MIN_ZERO_RUN) break;
+            unsigned long long value = 0;
+            for (j = 7; j >= 0; j--) {
+                value = (value << 8) | bytes[offset + j];
+            }
+            sprintf(line + strlen(line), "%s%llu", i > 0 ? ", " : "", value);
+            offset += 8;
+        }
+        append_code(codes, "%s\n", line);
+    }
+}
+
+void gen_function_definition_code(Ast* ast, Vector* codes, Option* option) {
     Ast* func_decl = ast_nth_child(ast, 0);
     Ast* param_list = ast_nth_child(func_decl, 1);
     Ast* block = ast_nth_child(ast, 1);
 
     Ast* func_ident = ast_nth_child(func_decl, 0);
-    CodeEnv* env = codenv_new(str_new(func_ident->value_ident));
+    CodeEnv* env = codenv_new(str_new(func_ident->value_ident), option);
+    if (option->opt_level >= 1) env->promoted_locals = promote_locals(ast, NUM_CALLEE_SAVED_REGISTERS);
+    if (option->opt_level >= 1 && !has_escaping_locals(block, block->local_table)) {
+        env->tail_call_enabled = 1;
+        if (has_self_tail_call(block, env->funcname)) {
+            env->entry_label = codenv_create_label(env);
+            append_code(env->codes, ".L%s:\n", env->entry_label);
+        }
+    }
 
     size_t i = 0, size = param_list->children->size;
     // TODO: more than six arguments
@@ -805,6 +1139,11 @@ void gen_function_definition_code(Ast* ast, Vector* codes) {
 
     for (i = 0; i < size; i++) {
         Ast* param_ident = ast_nth_child(ast_nth_child(param_list, i), 0);
+        int reg_index = find_promoted_register(param_ident, block->local_table, env);
+        if (reg_index >= 0) {
+            gen_promoted_store_arg_code(i, param_ident->ctype, reg_index, env);
+            continue;
+        }
         gen_address_code(param_ident, block->local_table, env);
         gen_store_arg_code(i, param_ident->ctype, env);
     }
@@ -819,18 +1158,24 @@ void gen_function_definition_code(Ast* ast, Vector* codes) {
         }
     }
 
-    append_code(codes, "\t.text\n");
-    append_code(codes, "\t.global _%s\n", env->funcname);
-    append_code(codes, "_%s:\n", env->funcname);
-    append_code(codes, "\tpush %%rbp\n");
-    append_code(codes, "\tmov %%rsp, %%rbp\n");
-    append_code(codes, "\tsub $%d, %%rsp\n", (block->local_table->stack_offset + 15) / 16 * 16);
-    vector_join(codes, env->codes);
-    append_code(codes, ".L_%s_return:\n", env->funcname);
-    append_code(codes, "\tmov %%rbp, %%rsp\n");
-    append_code(codes, "\tpop %%rbp\n");
-    append_code(codes, "\tret\n");
+    int stack_offset = block->local_table->stack_offset;
+    Vector* save_codes = vector_new();
+    Vector* restore_codes = vector_new();
+    if (option->opt_level >= 1) {
+        Vector* reserved_registers = vector_new();
+        for (i = 0; i < env->promoted_locals->size; i++) {
+            vector_push_back(reserved_registers, str_new(callee_saved_register8[i]));
+        }
+        allocate_registers(
+            env->codes, env->num_temps, NULL, reserved_registers, 0, &stack_offset, save_codes, restore_codes
+        );
+        vector_delete(reserved_registers);
+    }
+
+    gen_function_frame_code(codes, env, stack_offset, save_codes, restore_codes);
 
+    vector_delete(save_codes);
+    vector_delete(restore_codes);
     codenv_delete(env);
 }
 
@@ -849,55 +1194,95 @@ void gen_address_code(Ast* ast, LocalTable* local_table, CodeEnv* env) {
             break;
         case AST_DEREF:
             gen_expr_code(ast_nth_child(ast, 0), local_table, env);
-            append_code(env->codes, "\tpop %%rax\n");
+            gen_pop_temp_code("%rax", env);
             break;
         default:
             assert_code_gen(0);
     }
 }
 
-void gen_load_code(CType* ctype, CodeEnv* env) {
-    switch (ctype->size) {
-        case 1:
-            append_code(env->codes, "\tmovsbl (%%rax), %%eax\n");
-            break;
-        case 4:
-            append_code(env->codes, "\tmov (%%rax), %%eax\n");
-            break;
-        case 8:
-            append_code(env->codes, "\tmov (%%rax), %%rax\n");
-            break;
-        default:
-            assert_code_gen(0);
+void gen_call_args_code(Ast* arg_list, LocalTable* local_table, CodeEnv* env) {
+    size_t i = 0, num_args = arg_list->children->size;
+    // TODO: more than six arguments
+    assert_code_gen(num_args <= 6);
+    for (i = 0; i < num_args; i++) {
+        gen_expr_code(ast_nth_child(arg_list, i), local_table, env);
+    }
+    for (i = 0; i < num_args; i++) {
+        gen_pop_temp_code(arg_register8[num_args - i - 1], env);
+    }
+}
+
+void gen_push_temp_code(char* src, CodeEnv* env) {
+    if (env->option->opt_level == 0) {
+        append_code(env->codes, "\tpush %s\n", src);
+        return;
+    }
+    char* temp = codenv_create_temp(env);
+    append_code(env->codes, "\tmovq %s, %s\n", src, temp);
+    vector_push_back(env->temps, temp);
+}
+
+void gen_push_imm_code(int value, CodeEnv* env) {
+    char imm[13];
+    sprintf(imm, "$%d", value);
+    gen_push_temp_code(imm, env);
+}
+
+void gen_pop_temp_code(char* dest, CodeEnv* env) {
+    if (env->option->opt_level == 0) {
+        append_code(env->codes, "\tpop %s\n", dest);
+        return;
+    }
+    size_t top = env->temps->size - 1;
+    char* temp = (char*)vector_at(env->temps, top);
+    append_code(env->codes, "\tmovq %s, %s\n", temp, dest);
+    vector_erase(env->temps, top);
+    free(temp);
+}
+
+void gen_discard_temp_code(CodeEnv* env) {
+    if (env->option->opt_level == 0) {
+        append_code(env->codes, "\tadd $8, %%rsp\n");
+        return;
     }
+    size_t top = env->temps->size - 1;
+    char* temp = (char*)vector_at(env->temps, top);
+    vector_erase(env->temps, top);
+    free(temp);
+}
+
+void gen_load_code(CType* ctype, CodeEnv* env) {
+    gen_sized_load_code(ctype->size, env);
 }
 
 void gen_store_code(CType* ctype, CodeEnv* env) {
+    gen_sized_store_code(ctype->size, env);
+}
+
+void gen_store_arg_code(int arg_index, CType* ctype, CodeEnv* env) {
     switch (ctype->size) {
         case 1:
-            append_code(env->codes, "\tmov %%al, (%%rdi)\n");
+            append_code(env->codes, "\tmov %s, (%%rax)\n", arg_register1[arg_index]);
             break;
         case 4:
-            append_code(env->codes, "\tmov %%eax, (%%rdi)\n");
+            append_code(env->codes, "\tmov %s, (%%rax)\n", arg_register4[arg_index]);
             break;
         case 8:
-            append_code(env->codes, "\tmov %%rax, (%%rdi)\n");
+            append_code(env->codes, "\tmov %s, (%%rax)\n", arg_register8[arg_index]);
             break;
         default:
             assert_code_gen(0);
     }
 }
 
-void gen_store_arg_code(int arg_index, CType* ctype, CodeEnv* env) {
+void gen_truncate_code(CType* ctype, CodeEnv* env) {
     switch (ctype->size) {
         case 1:
-            append_code(env->codes, "\tmov %s, (%%rax)\n", arg_register1[arg_index]);
+            append_code(env->codes, "\tmovsbl %%al, %%eax\n");
             break;
         case 4:
-            append_code(env->codes, "\tmov %s, (%%rax)\n", arg_register4[arg_index]);
-            break;
         case 8:
-            append_code(env->codes, "\tmov %s, (%%rax)\n", arg_register8[arg_index]);
             break;
         default:
             assert_code_gen(0);
@@ -924,6 +1309,97 @@ void gen_dec_code(CType* ctype, CodeEnv* env) {
     }
 }
 
+void gen_read_modify_write_code(AstType type, CType* ctype, char* dest, CodeEnv* env) {
+    char* reg = NULL;
+    char suffix = 0;
+    switch (ctype->size) {
+        case 1:
+            reg = "%al";
+            suffix = 'b';
+            break;
+        case 4:
+            reg = "%eax";
+            suffix = 'l';
+            break;
+        case 8:
+            reg = "%rax";
+            suffix = 'q';
+            break;
+        default:
+            assert_code_gen(0);
+    }
+
+    if (ctype->basic_ctype == CTYPE_PTR) {
+        assert_code_gen(type == AST_ADD_ASSIGN || type == AST_SUB_ASSIGN);
+        gen_pointer_offset_code("%eax", "%rax", ctype->ptr_to->size, env);
+    }
+
+    switch (type) {
+        case AST_ADD_ASSIGN:
+            append_code(env->codes, "\tadd%c %s, %s\n", suffix, reg, dest);
+            break;
+        case AST_SUB_ASSIGN:
+            append_code(env->codes, "\tsub%c %s, %s\n", suffix, reg, dest);
+            break;
+        case AST_LSHIFT_ASSIGN:
+            append_code(env->codes, "\tmov %%eax, %%ecx\n");
+            append_code(env->codes, "\tsal%c %%cl, %s\n", suffix, dest);
+            break;
+        case AST_RSHIFT_ASSIGN:
+            append_code(env->codes, "\tmov %%eax, %%ecx\n");
+            append_code(env->codes, "\tsar%c %%cl, %s\n", suffix, dest);
+            break;
+        case AST_AND_ASSIGN:
+            append_code(env->codes, "\tand%c %s, %s\n", suffix, reg, dest);
+            break;
+        case AST_XOR_ASSIGN:
+            append_code(env->codes, "\txor%c %s, %s\n", suffix, reg, dest);
+            break;
+        case AST_OR_ASSIGN:
+            append_code(env->codes, "\tor%c %s, %s\n", suffix, reg, dest);
+            break;
+        default:
+            assert_code_gen(0);
+    }
+}
+
+void gen_pointer_offset_code(char* reg4, char* reg, int size, CodeEnv* env) {
+    append_code(env->codes, "\tmovslq %s, %s\n", reg4, reg);
+
+    int shift = exact_log2(size);
+    if (shift > 0) {
+        append_code(env->codes, "\tsal $%d, %s\n", shift, reg);
+    } else if (shift < 0) {
+        append_code(env->codes, "\timul $%d, %s\n", size, reg);
+    }
+}
+
+void gen_constant_multiplication_code(int value, CodeEnv* env) {
+    int shift = exact_log2(value);
+    switch (value) {
+        case 0:
+            append_code(env->codes, "\tmov $0, %%eax\n");
+            return;
+        case 1:
+            return;
+        case -1:
+            append_code(env->codes, "\tneg %%eax\n");
+            return;
+        case 3:
+        case 5:
+        case 9:
+            append_code(env->codes, "\tlea (%%rax,%%rax,%d), %%eax\n", value - 1);
+            return;
+        default:
+            break;
+    }
+    if (shift > 0) {
+        append_code(env->codes, "\tsal $%d, %%eax\n", shift);
+    } else {
+        append_code(env->codes, "\timul $%d, %%eax\n", value);
+    }
+}
+
 char* create_size_label(int size) {
     char* size_label = (char*)safe_malloc(7 * sizeof(char));
     switch (size) {
@@ -945,9 +1421,156 @@ char* create_size_label(int size) {
     return size_label;
 }
 
-// assertion
-void assert_code_gen(int condition) {
-    if (condition) return;
-    fprintf(stderr, "Error: fail to generate code\n");
-    exit(1);
+int is_string_literal_data(GlobalData* global_data) {
+    if (global_data->type != GBL_TYPE_LIST || global_data->children->size != 2) return 0;
+    GlobalData* zero = global_data_nth_child(global_data, 1);
+    return global_data_nth_child(global_data, 0)->type == GBL_TYPE_STR && zero->size == 0;
+}
+
+int is_zero_data(GlobalData* global_data) {
+    switch (global_data->type) {
+        case GBL_TYPE_INTEGER:
+            return global_data->value_int == 0;
+        case GBL_TYPE_ADDR:
+            return 0;
+        case GBL_TYPE_STR:
+            return global_data->value_str[0] == '\0';
+        case GBL_TYPE_BYTES:
+            return zero_run_length(global_data->value_bytes, 0, global_data->size) == global_data->size;
+        case GBL_TYPE_LIST: {
+            size_t i = 0, size = global_data->children->size;
+            for (i = 0; i < size; i++) {
+                if (!is_zero_data(global_data_nth_child(global_data, i))) return 0;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int zero_run_length(unsigned char* bytes, int offset, int size) {
+    int end = offset;
+    while (end < size && bytes[end] == 0) end++;
+    return end - offset;
+}
+
+int global_alignment_of(CType* ctype) {
+    if (ctype->basic_ctype != CTYPE_ARRAY) return ctype->size;
+    if (ctype->size >= CACHE_LINE_SIZE) return CACHE_LINE_SIZE;
+    if (ctype->size >= ARRAY_ALIGNMENT) return ARRAY_ALIGNMENT;
+    return global_alignment_of(ctype->array_of);
+}
+
+// promoted-local
+int find_promoted_register(Ast* ast, LocalTable* local_table, CodeEnv* env) {
+    if (env->promoted_locals == NULL || ast->type != AST_IDENT) return -1;
+    int stack_index = local_table_get_stack_index(local_table, ast->value_ident);
+    return promoted_register_of(env->promoted_locals, stack_index);
+}
+
+void gen_promoted_assignment_code(AstType type, CType* ctype, int reg_index, CodeEnv* env) {
+    switch (type) {
+        case AST_ASSIGN:
+            gen_promoted_store_code(ctype, reg_index, env);
+            gen_truncate_code(ctype, env);
+            break;
+        case AST_ADD_ASSIGN:
+        case AST_SUB_ASSIGN:
+        case AST_LSHIFT_ASSIGN:
+        case AST_RSHIFT_ASSIGN:
+        case AST_AND_ASSIGN:
+        case AST_XOR_ASSIGN:
+        case AST_OR_ASSIGN:
+            gen_read_modify_write_code(type, ctype, sized_promoted_register(ctype->size, reg_index), env);
+            gen_promoted_truncate_code(ctype, reg_index, env);
+            append_code(env->codes, "\tmov %s, %%rax\n", callee_saved_register8[reg_index]);
+            break;
+        case AST_MUL_ASSIGN:
+        case AST_DIV_ASSIGN:
+        case AST_MOD_ASSIGN:
+            append_code(env->codes, "\tmov %%eax, %%esi\n");
+            append_code(env->codes, "\tmov %s, %%rax\n", callee_saved_register8[reg_index]);
+            if (type == AST_MUL_ASSIGN) {
+                append_code(env->codes, "\timul %%esi, %%eax\n");
+            } else {
+                append_code(env->codes, "\tcltd\n");
+                append_code(env->codes, "\tidiv %%esi\n");
+                if (type == AST_MOD_ASSIGN) append_code(env->codes, "\tmov %%edx, %%eax\n");
+            }
+            gen_promoted_store_code(ctype, reg_index, env);
+            gen_truncate_code(ctype, env);
+            break;
+        default:
+            assert_code_gen(0);
+    }
+}
+
+void gen_promoted_store_code(CType* ctype, int reg_index, CodeEnv* env) {
+    switch (ctype->size) {
+        case 1:
+            append_code(env->codes, "\tmovsbl %%al, %s\n", callee_saved_register4[reg_index]);
+            break;
+        case 4:
+            append_code(env->codes, "\tmov %%eax, %s\n", callee_saved_register4[reg_index]);
+            break;
+        case 8:
+            append_code(env->codes, "\tmov %%rax, %s\n", callee_saved_register8[reg_index]);
+            break;
+        default:
+            assert_code_gen(0);
+    }
+}
+
+void gen_promoted_store_arg_code(int arg_index, CType* ctype, int reg_index, CodeEnv* env) {
+    switch (ctype->size) {
+        case 1:
+            append_code(
+                env->codes, "\tmovsbl %s, %s\n", arg_register1[arg_index], callee_saved_register4[reg_index]
+            );
+            break;
+        case 4:
+            append_code(env->codes, "\tmov %s, %s\n", arg_register4[arg_index], callee_saved_register4[reg_index]);
+            break;
+        case 8:
+            append_code(env->codes, "\tmov %s, %s\n", arg_register8[arg_index], callee_saved_register8[reg_index]);
+            break;
+        default:
+            assert_code_gen(0);
+    }
+}
+
+void gen_promoted_step_code(AstType type, CType* ctype, int reg_index, CodeEnv* env) {
+    int is_incr = type == AST_PRE_INCR || type == AST_POST_INCR;
+    if (ctype_is_integer_ctype(ctype)) {
+        append_code(env->codes, "\t%s %s\n", is_incr ? "inc" : "dec", callee_saved_register4[reg_index]);
+        gen_promoted_truncate_code(ctype, reg_index, env);
+    } else if (ctype->basic_ctype == CTYPE_PTR) {
+        append_code(
+            env->codes, "\t%s $%d, %s\n",
+            is_incr ? "add" : "sub", ctype->ptr_to->size, callee_saved_register8[reg_index]
+        );
+    } else {
+        assert_code_gen(0);
+    }
+}
+
+void gen_promoted_truncate_code(CType* ctype, int reg_index, CodeEnv* env) {
+    if (ctype->size != 1) return;
+    append_code(
+        env->codes, "\tmovsbl %s, %s\n", callee_saved_register1[reg_index], callee_saved_register4[reg_index]
+    );
+}
+
+char* sized_promoted_register(int size, int reg_index) {
+    switch (size) {
+        case 1:
+            return callee_saved_register1[reg_index];
+        case 4:
+            return callee_saved_register4[reg_index];
+        case 8:
+            return callee_saved_register8[reg_index];
+        default:
+            assert_code_gen(0);
+    }
+    return NULL;
 }
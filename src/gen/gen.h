@@ -3,10 +3,11 @@
 
 
 #include <stdio.h>
+#include "../common/option.h"
 #include "../parser/ast.h"
 
 
-void print_code(FILE* file_ptr, AstList* astlist);
+void print_code(FILE* file_ptr, AstList* astlist, Option* option);
 
 
 #endif  // _GEN_H_
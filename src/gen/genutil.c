@@ -0,0 +1,343 @@
+#include "genutil.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../ir/strength.h"
+#include "../common/memory.h"
+
+
+#define TAIL_JUMP_PREFIX "\ttailjmp "
+#define RED_ZONE_SIZE 128
+#define MAX_INLINE_BLOCK_SIZE 128
+
+
+char* arg_register1[] = { "%dil", "%sil", "%dl",  "%cl",  "%r8b", "%r9b" };
+char* arg_register4[] = { "%edi", "%esi", "%edx", "%ecx", "%r8d", "%r9d" };
+char* arg_register8[] = { "%rdi", "%rsi", "%rdx", "%rcx", "%r8",  "%r9"  };
+
+char* callee_saved_register1[] = { "%bl",  "%r12b", "%r13b", "%r14b", "%r15b" };
+char* callee_saved_register4[] = { "%ebx", "%r12d", "%r13d", "%r14d", "%r15d" };
+char* callee_saved_register8[] = { "%rbx", "%r12",  "%r13",  "%r14",  "%r15"  };
+
+
+// block-memory
+void gen_block_tail_code(int size, int offset, int is_copy, CodeEnv* env);
+
+// function-frame
+void gen_leaf_function_frame_code(Vector* codes, CodeEnv* env, Vector* save_codes, Vector* restore_codes);
+void gen_function_epilogue_code(Vector* codes, CodeEnv* env, int frame_size, Vector* restore_codes);
+int can_use_red_zone(CodeEnv* env, int stack_offset);
+void rewrite_frame_base(Vector* codes);
+void rewrite_frame_offsets(Vector* codes, int frame_size);
+char* rewrite_frame_offset_code(char* code, int displacement);
+int stack_adjustment(char* code);
+
+
+// load-store
+void gen_sized_load_code(int size, CodeEnv* env) {
+    switch (size) {
+        case 1:
+            append_code(env->codes, "\tmovsbl (%%rax), %%eax\n");
+            break;
+        case 4:
+            append_code(env->codes, "\tmov (%%rax), %%eax\n");
+            break;
+        case 8:
+            append_code(env->codes, "\tmov (%%rax), %%rax\n");
+            break;
+        default:
+            assert_code_gen(0);
+    }
+}
+
+void gen_sized_store_code(int size, CodeEnv* env) {
+    switch (size) {
+        case 1:
+            append_code(env->codes, "\tmov %%al, (%%rdi)\n");
+            break;
+        case 4:
+            append_code(env->codes, "\tmov %%eax, (%%rdi)\n");
+            break;
+        case 8:
+            append_code(env->codes, "\tmov %%rax, (%%rdi)\n");
+            break;
+        default:
+            assert_code_gen(0);
+    }
+}
+
+// block-memory
+void gen_block_zero_code(int size, CodeEnv* env) {
+    int offset = 0;
+    if (size > MAX_INLINE_BLOCK_SIZE) {
+        append_code(env->codes, "\txor %%eax, %%eax\n");
+        append_code(env->codes, "\tmov $%d, %%ecx\n", size / 8);
+        append_code(env->codes, "\trep stosq\n");
+        gen_block_tail_code(size % 8, 0, 0, env);
+        return;
+    }
+
+    if (size >= 16) append_code(env->codes, "\tpxor %%xmm0, %%xmm0\n");
+    for (offset = 0; size - offset >= 16; offset += 16) {
+        append_code(env->codes, "\tmovdqu %%xmm0, %d(%%rdi)\n", offset);
+    }
+    gen_block_tail_code(size, offset, 0, env);
+}
+
+void gen_block_copy_code(int size, CodeEnv* env) {
+    int offset = 0;
+    if (size > MAX_INLINE_BLOCK_SIZE) {
+        append_code(env->codes, "\tmov $%d, %%ecx\n", size / 8);
+        append_code(env->codes, "\trep movsq\n");
+        gen_block_tail_code(size % 8, 0, 1, env);
+        return;
+    }
+
+    for (offset = 0; size - offset >= 16; offset += 16) {
+        append_code(env->codes, "\tmovdqu %d(%%rsi), %%xmm0\n", offset);
+        append_code(env->codes, "\tmovdqu %%xmm0, %d(%%rdi)\n", offset);
+    }
+    gen_block_tail_code(size, offset, 1, env);
+}
+
+void gen_block_tail_code(int size, int offset, int is_copy, CodeEnv* env) {
+    char* suffixes[] = { "q", "l", "w", "b" };
+    char* registers[] = { "%rax", "%eax", "%ax", "%al" };
+    int widths[] = { 8, 4, 2, 1 };
+
+    int i = 0;
+    for (i = 0; i < 4; i++) {
+        for (; size - offset >= widths[i]; offset += widths[i]) {
+            if (!is_copy) {
+                append_code(env->codes, "\tmov%s $0, %d(%%rdi)\n", suffixes[i], offset);
+                continue;
+            }
+            append_code(env->codes, "\tmov%s %d(%%rsi), %s\n", suffixes[i], offset, registers[i]);
+            append_code(env->codes, "\tmov%s %s, %d(%%rdi)\n", suffixes[i], registers[i], offset);
+        }
+    }
+}
+
+// arithmetic
+void gen_constant_division_code(int divisor, int is_modulo, CodeEnv* env) {
+    if (divisor == 0 || divisor == INT_MIN) {
+        append_code(env->codes, "\tmov $%d, %%ecx\n", divisor);
+        append_code(env->codes, "\tcltd\n");
+        append_code(env->codes, "\tidiv %%ecx\n");
+        if (is_modulo) append_code(env->codes, "\tmov %%edx, %%eax\n");
+        return;
+    }
+
+    int abs_divisor = divisor < 0 ? -divisor : divisor;
+    int shift = exact_log2(abs_divisor);
+    int magic = 0;
+    if (shift == 0) {
+        if (is_modulo) {
+            append_code(env->codes, "\tmov $0, %%eax\n");
+        } else if (divisor < 0) {
+            append_code(env->codes, "\tneg %%eax\n");
+        }
+        return;
+    } else if (shift > 0) {
+        append_code(env->codes, "\tmov %%eax, %%ecx\n");
+        if (shift > 1) append_code(env->codes, "\tsar $31, %%ecx\n");
+        append_code(env->codes, "\tshr $%d, %%ecx\n", 32 - shift);
+        append_code(env->codes, "\tadd %%eax, %%ecx\n");
+        if (is_modulo) {
+            append_code(env->codes, "\tand $%d, %%ecx\n", -abs_divisor);
+            append_code(env->codes, "\tsub %%ecx, %%eax\n");
+            return;
+        }
+        append_code(env->codes, "\tsar $%d, %%ecx\n", shift);
+        append_code(env->codes, "\tmov %%ecx, %%eax\n");
+    } else {
+        compute_division_magic(abs_divisor, &magic, &shift);
+        append_code(env->codes, "\tmov %%eax, %%ecx\n");
+        append_code(env->codes, "\tmov $%d, %%edx\n", magic);
+        append_code(env->codes, "\timul %%edx\n");
+        if (magic < 0) append_code(env->codes, "\tadd %%ecx, %%edx\n");
+        if (shift > 0) append_code(env->codes, "\tsar $%d, %%edx\n", shift);
+        append_code(env->codes, "\tmov %%edx, %%eax\n");
+        append_code(env->codes, "\tshr $31, %%eax\n");
+        append_code(env->codes, "\tadd %%edx, %%eax\n");
+        if (is_modulo) {
+            append_code(env->codes, "\timul $%d, %%eax\n", abs_divisor);
+            append_code(env->codes, "\tsub %%eax, %%ecx\n");
+            append_code(env->codes, "\tmov %%ecx, %%eax\n");
+            return;
+        }
+    }
+    if (divisor < 0) append_code(env->codes, "\tneg %%eax\n");
+}
+
+// function-frame
+void gen_function_frame_code(
+    Vector* codes, CodeEnv* env, int stack_offset,
+    Vector* save_codes, Vector* restore_codes
+) {
+    if (can_use_red_zone(env, stack_offset)) {
+        gen_leaf_function_frame_code(codes, env, save_codes, restore_codes);
+        return;
+    }
+
+    int frame_size = (stack_offset + 15) / 16 * 16;
+    append_code(codes, "\t.text\n");
+    append_code(codes, "\t.global _%s\n", env->funcname);
+    append_code(codes, "_%s:\n", env->funcname);
+    if (env->frame_pointer_omitted) {
+        rewrite_frame_offsets(save_codes, frame_size);
+        rewrite_frame_offsets(env->codes, frame_size);
+        rewrite_frame_offsets(restore_codes, frame_size);
+        append_code(codes, "\tsub $%d, %%rsp\n", frame_size + 8);
+    } else {
+        append_code(codes, "\tpush %%rbp\n");
+        append_code(codes, "\tmov %%rsp, %%rbp\n");
+        append_code(codes, "\tsub $%d, %%rsp\n", frame_size);
+    }
+    vector_join(codes, save_codes);
+
+    size_t i = 0, size = env->codes->size;
+    for (i = 0; i < size; i++) {
+        char* code = (char*)vector_at(env->codes, i);
+        if (strncmp(code, TAIL_JUMP_PREFIX, strlen(TAIL_JUMP_PREFIX)) != 0) {
+            vector_push_back(codes, code);
+            continue;
+        }
+        gen_function_epilogue_code(codes, env, frame_size, restore_codes);
+        append_code(codes, "\tjmp %s", code + strlen(TAIL_JUMP_PREFIX));
+        free(code);
+    }
+    env->codes->size = 0;
+
+    append_code(codes, ".L_%s_return:\n", env->funcname);
+    gen_function_epilogue_code(codes, env, frame_size, restore_codes);
+    append_code(codes, "\tret\n");
+}
+
+void gen_leaf_function_frame_code(Vector* codes, CodeEnv* env, Vector* save_codes, Vector* restore_codes) {
+    rewrite_frame_base(save_codes);
+    rewrite_frame_base(env->codes);
+    rewrite_frame_base(restore_codes);
+
+    append_code(codes, "\t.text\n");
+    append_code(codes, "\t.global _%s\n", env->funcname);
+    append_code(codes, "_%s:\n", env->funcname);
+    vector_join(codes, save_codes);
+
+    Vector* return_codes = vector_new();
+    vector_join(return_codes, restore_codes);
+    append_code(return_codes, "\tret\n");
+
+    char return_jump[256];
+    snprintf(return_jump, sizeof(return_jump), "\tjmp .L_%s_return\n", env->funcname);
+    size_t i = 0, j = 0, size = env->codes->size;
+    for (i = 0; i < size; i++) {
+        char* code = (char*)vector_at(env->codes, i);
+        if (strcmp(code, return_jump) != 0) {
+            vector_push_back(codes, code);
+            continue;
+        }
+        for (j = 0; j < return_codes->size; j++) {
+            vector_push_back(codes, str_new((char*)vector_at(return_codes, j)));
+        }
+        free(code);
+    }
+    env->codes->size = 0;
+
+    char* last_code = codes->size > 0 ? (char*)vector_at(codes, codes->size - 1) : NULL;
+    if (last_code == NULL || strcmp(last_code, "\tret\n") != 0) vector_join(codes, return_codes);
+    vector_delete(return_codes);
+}
+
+void gen_function_epilogue_code(Vector* codes, CodeEnv* env, int frame_size, Vector* restore_codes) {
+    size_t i = 0, size = restore_codes->size;
+    for (i = 0; i < size; i++) {
+        vector_push_back(codes, str_new((char*)vector_at(restore_codes, i)));
+    }
+    if (env->frame_pointer_omitted) {
+        append_code(codes, "\tadd $%d, %%rsp\n", frame_size + 8);
+        return;
+    }
+    append_code(codes, "\tmov %%rbp, %%rsp\n");
+    append_code(codes, "\tpop %%rbp\n");
+}
+
+int can_use_red_zone(CodeEnv* env, int stack_offset) {
+    if (env->option->opt_level < 1 || stack_offset > RED_ZONE_SIZE) return 0;
+
+    size_t i = 0, size = env->codes->size;
+    for (i = 0; i < size; i++) {
+        char* code = (char*)vector_at(env->codes, i);
+        if (
+            strncmp(code, "\tcall ", 6) == 0 || strncmp(code, TAIL_JUMP_PREFIX, strlen(TAIL_JUMP_PREFIX)) == 0 ||
+            strncmp(code, "\tpush", 5) == 0 || strncmp(code, "\tpop", 4) == 0 || strstr(code, "%rsp") != NULL
+        )
+            return 0;
+    }
+    return 1;
+}
+
+void rewrite_frame_base(Vector* codes) {
+    size_t i = 0, size = codes->size;
+    for (i = 0; i < size; i++) {
+        char* p = (char*)vector_at(codes, i);
+        while ((p = strstr(p, "(%rbp)")) != NULL) {
+            memcpy(p, "(%rsp)", 6);
+            p += 6;
+        }
+    }
+}
+
+void rewrite_frame_offsets(Vector* codes, int frame_size) {
+    int displacement = frame_size;
+    size_t i = 0, size = codes->size;
+    for (i = 0; i < size; i++) {
+        char* code = (char*)vector_at(codes, i);
+        if (strstr(code, "(%rbp)") != NULL) {
+            codes->data[i] = rewrite_frame_offset_code(code, displacement);
+            free(code);
+            code = (char*)vector_at(codes, i);
+        }
+        displacement += stack_adjustment(code);
+    }
+}
+
+char* rewrite_frame_offset_code(char* code, int displacement) {
+    char* rewritten = (char*)safe_malloc((strlen(code) + 16) * sizeof(char));
+    char* base = strstr(code, "(%rbp)");
+    char* offset_begin = base;
+    while (offset_begin > code && isdigit(offset_begin[-1])) offset_begin--;
+    if (offset_begin > code && offset_begin[-1] == '-') offset_begin--;
+
+    size_t prefix_len = offset_begin - code;
+    strncpy(rewritten, code, prefix_len);
+    sprintf(rewritten + prefix_len, "%d(%%rsp)", displacement + atoi(offset_begin));
+    strcat(rewritten, base + 6);
+    return rewritten;
+}
+
+int stack_adjustment(char* code) {
+    if (strncmp(code, "\tpush ", 6) == 0) return 8;
+    if (strncmp(code, "\tpop ", 5) == 0)  return -8;
+
+    int size = 0, matched = 0;
+    sscanf(code, "\tsub $%d, %%rsp\n%n", &size, &matched);
+    if (matched > 0) return size;
+    sscanf(code, "\tadd $%d, %%rsp\n%n", &size, &matched);
+    if (matched > 0) return -size;
+    return 0;
+}
+
+void gen_tail_jump_code(char* funcname, CodeEnv* env) {
+    append_code(env->codes, TAIL_JUMP_PREFIX "_%s\n", funcname);
+}
+
+// assertion
+void assert_code_gen(int condition) {
+    if (condition) return;
+    fprintf(stderr, "Error: fail to generate code\n");
+    exit(1);
+}
@@ -0,0 +1,41 @@
+#ifndef _GENUTIL_H_
+#define _GENUTIL_H_
+
+
+#include "codenv.h"
+#include "../common/vector.h"
+
+
+#define NUM_CALLEE_SAVED_REGISTERS 5
+
+extern char* arg_register1[];
+extern char* arg_register4[];
+extern char* arg_register8[];
+extern char* callee_saved_register1[];
+extern char* callee_saved_register4[];
+extern char* callee_saved_register8[];
+
+
+// load-store
+void gen_sized_load_code(int size, CodeEnv* env);
+void gen_sized_store_code(int size, CodeEnv* env);
+
+// block-memory
+void gen_block_zero_code(int size, CodeEnv* env);
+void gen_block_copy_code(int size, CodeEnv* env);
+
+// arithmetic
+void gen_constant_division_code(int divisor, int is_modulo, CodeEnv* env);
+
+// function-frame
+void gen_function_frame_code(
+    Vector* codes, CodeEnv* env, int stack_offset,
+    Vector* save_codes, Vector* restore_codes
+);
+void gen_tail_jump_code(char* funcname, CodeEnv* env);
+
+// assertion
+void assert_code_gen(int condition);
+
+
+#endif  // _GENUTIL_H_
@@ -0,0 +1,575 @@
+#include "irgen.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "codenv.h"
+#include "genutil.h"
+#include "regalloc.h"
+#include "../ir/liveness.h"
+#include "../common/memory.h"
+
+
+// instruction-code-generator
+void gen_ir_inst_code(IrInst* inst, IrBlock* next_block, char** block_labels, CodeEnv* env);
+void gen_ir_unary_op_code(IrInst* inst, CodeEnv* env);
+void gen_ir_binary_op_code(IrInst* inst, CodeEnv* env);
+void gen_ir_comparison_code(IrInst* inst, CodeEnv* env);
+void gen_ir_vector_op_code(IrInst* inst, CodeEnv* env);
+void gen_ir_vector_splat_code(IrInst* inst, char* reg, int avx, CodeEnv* env);
+void gen_ir_vector_reduce_code(IrInst* inst, char* reg, int avx, CodeEnv* env);
+void gen_ir_compare_code(IrInst* inst, CodeEnv* env);
+void gen_ir_call_code(IrInst* inst, CodeEnv* env);
+void gen_ir_call_args_code(IrInst* inst, CodeEnv* env);
+void gen_ir_tail_call_code(IrInst* inst, CodeEnv* env);
+int is_ir_tail_call(IrBlock* block, size_t index);
+void gen_ir_branch_code(IrInst* inst, IrBlock* next_block, char** block_labels, CodeEnv* env);
+void gen_ir_fused_branch_code(IrInst* compare, IrInst* branch, IrBlock* next_block, char** block_labels, CodeEnv* env);
+void gen_ir_conditional_jump_code(
+    char* condition, char* negated_condition,
+    IrInst* branch, IrBlock* next_block, char** block_labels, CodeEnv* env
+);
+
+// branch-fusion
+int* count_vreg_uses(IrFunction* func);
+IrInst* find_fusible_comparison(IrBlock* block, int* use_counts);
+char* ir_condition_code(IrOpcode opcode, int negate);
+
+// live-point
+Vector* create_live_points(IrFunction* func, int* block_begins, int* block_ends);
+
+// utils
+void gen_ir_operand_code(IrOperand* operand, char* reg, CodeEnv* env);
+void gen_ir_result_code(int dst, char* reg, CodeEnv* env);
+char* ir_register_a(int width);
+char* ir_register_di(int width);
+
+
+void gen_ir_function_code(IrFunction* func, Vector* codes, Option* option) {
+    CodeEnv* env = codenv_new(str_new(func->funcname), option);
+    env->num_temps = func->num_vregs;
+    env->tail_call_enabled = !ir_function_has_escaping_locals(func);
+    env->frame_pointer_omitted = option->omit_frame_pointer;
+
+    int num_blocks = func->num_blocks;
+    char** block_labels = (char**)safe_malloc(num_blocks * sizeof(char*));
+    int* block_begins = (int*)safe_malloc(num_blocks * sizeof(int));
+    int* block_ends = (int*)safe_malloc(num_blocks * sizeof(int));
+
+    int* use_counts = count_vreg_uses(func);
+
+    size_t i = 0, j = 0, size = func->blocks->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        block_labels[block->id] = codenv_create_label(env);
+    }
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        IrBlock* next_block = (IrBlock*)vector_at(func->blocks, i + 1);
+        IrInst* fused_comparison = find_fusible_comparison(block, use_counts);
+        block_begins[block->id] = env->codes->size;
+        append_code(env->codes, ".L%s:\n", block_labels[block->id]);
+        size_t num_insts = block->insts->size;
+        for (j = 0; j < num_insts; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            if (inst == fused_comparison) continue;
+            if (env->tail_call_enabled && is_ir_tail_call(block, j)) {
+                gen_ir_tail_call_code(inst, env);
+                break;
+            }
+            if (fused_comparison != NULL && inst->opcode == IR_BR) {
+                gen_ir_fused_branch_code(fused_comparison, inst, next_block, block_labels, env);
+                continue;
+            }
+            gen_ir_inst_code(inst, next_block, block_labels, env);
+        }
+        block_ends[block->id] = env->codes->size - 1;
+    }
+
+    int stack_offset = func->stack_offset;
+    Vector* live_points = create_live_points(func, block_begins, block_ends);
+    Vector* save_codes = vector_new();
+    Vector* restore_codes = vector_new();
+    allocate_registers(
+        env->codes, env->num_temps, live_points, NULL, env->frame_pointer_omitted,
+        &stack_offset, save_codes, restore_codes
+    );
+    gen_function_frame_code(codes, env, stack_offset, save_codes, restore_codes);
+
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        free(block_labels[block->id]);
+    }
+    free(block_labels);
+    free(block_begins);
+    free(block_ends);
+    free(use_counts);
+    vector_delete(live_points);
+    vector_delete(save_codes);
+    vector_delete(restore_codes);
+    codenv_delete(env);
+}
+
+// instruction-code-generator
+void gen_ir_inst_code(IrInst* inst, IrBlock* next_block, char** block_labels, CodeEnv* env) {
+    IrOpcode opcode = inst->opcode;
+    if (ir_is_unary_op(opcode)) {
+        gen_ir_unary_op_code(inst, env);
+        return;
+    } else if (ir_is_binary_op(opcode)) {
+        gen_ir_binary_op_code(inst, env);
+        return;
+    } else if (ir_is_comparison(opcode)) {
+        gen_ir_comparison_code(inst, env);
+        return;
+    } else if (ir_is_vector_op(opcode)) {
+        gen_ir_vector_op_code(inst, env);
+        return;
+    }
+
+    switch (opcode) {
+        case IR_MOV:
+            gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rax", env);
+            gen_ir_result_code(inst->dst, "%rax", env);
+            break;
+        case IR_ARG:
+            gen_ir_result_code(inst->dst, arg_register8[ir_inst_nth_src(inst, 0)->value], env);
+            break;
+        case IR_LOCAL_ADDR:
+            append_code(env->codes, "\tlea -%d(%%rbp), %%rax\n", inst->stack_index);
+            gen_ir_result_code(inst->dst, "%rax", env);
+            break;
+        case IR_GLOBAL_ADDR:
+            append_code(env->codes, "\tlea _%s(%%rip), %%rax\n", inst->symbol);
+            gen_ir_result_code(inst->dst, "%rax", env);
+            break;
+        case IR_LOAD:
+            gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rax", env);
+            gen_sized_load_code(inst->width, env);
+            gen_ir_result_code(inst->dst, "%rax", env);
+            break;
+        case IR_STORE:
+            gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rdi", env);
+            gen_ir_operand_code(ir_inst_nth_src(inst, 1), "%rax", env);
+            gen_sized_store_code(inst->width, env);
+            break;
+        case IR_MEMZERO:
+            gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rdi", env);
+            gen_block_zero_code(ir_inst_nth_src(inst, 1)->value, env);
+            break;
+        case IR_MEMCOPY:
+            gen_ir_operand_code(ir_inst_nth_src(inst, 1), "%rsi", env);
+            gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rdi", env);
+            gen_block_copy_code(ir_inst_nth_src(inst, 2)->value, env);
+            break;
+        case IR_CALL:
+            gen_ir_call_code(inst, env);
+            break;
+        case IR_JMP:
+            if (inst->targets[0] == next_block) break;
+            append_code(env->codes, "\tjmp .L%s\n", block_labels[inst->targets[0]->id]);
+            break;
+        case IR_BR:
+            gen_ir_branch_code(inst, next_block, block_labels, env);
+            break;
+        case IR_RET:
+            if (inst->srcs->size > 0) gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rax", env);
+            append_code(env->codes, "\tjmp .L_%s_return\n", env->funcname);
+            break;
+        default:
+            assert_code_gen(0);
+    }
+}
+
+void gen_ir_unary_op_code(IrInst* inst, CodeEnv* env) {
+    gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rax", env);
+    switch (inst->opcode) {
+        case IR_NEG:
+            append_code(env->codes, "\tneg %s\n", ir_register_a(inst->width));
+            break;
+        case IR_NOT:
+            append_code(env->codes, "\tnot %s\n", ir_register_a(inst->width));
+            break;
+        case IR_SEXT8:
+            append_code(env->codes, "\tmovsbl %%al, %%eax\n");
+            break;
+        case IR_SEXT32:
+            append_code(env->codes, "\tmovslq %%eax, %%rax\n");
+            break;
+        default:
+            assert_code_gen(0);
+    }
+    gen_ir_result_code(inst->dst, "%rax", env);
+}
+
+void gen_ir_binary_op_code(IrInst* inst, CodeEnv* env) {
+    IrOperand* rhs = ir_inst_nth_src(inst, 1);
+    if ((inst->opcode == IR_DIV || inst->opcode == IR_MOD) && inst->width == 4 && rhs->type == IR_OPERAND_IMM) {
+        gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rax", env);
+        gen_constant_division_code(rhs->value, inst->opcode == IR_MOD, env);
+        gen_ir_result_code(inst->dst, "%rax", env);
+        return;
+    }
+
+    char* reg_a = ir_register_a(inst->width);
+    char* reg_di = ir_register_di(inst->width);
+    char src[16];
+    if (rhs->type == IR_OPERAND_IMM) {
+        sprintf(src, "$%d", rhs->value);
+    } else {
+        sprintf(src, "%s", reg_di);
+    }
+
+    gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rax", env);
+    switch (inst->opcode) {
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_AND:
+        case IR_XOR:
+        case IR_OR:
+            if (rhs->type == IR_OPERAND_VREG) gen_ir_operand_code(rhs, "%rdi", env);
+            break;
+        case IR_DIV:
+        case IR_MOD:
+            gen_ir_operand_code(rhs, "%rdi", env);
+            break;
+        case IR_SHL:
+        case IR_SAR:
+            if (rhs->type == IR_OPERAND_VREG) {
+                gen_ir_operand_code(rhs, "%rcx", env);
+                sprintf(src, "%%cl");
+            } else {
+                sprintf(src, "$%d", rhs->value & (inst->width * 8 - 1));
+            }
+            break;
+        default:
+            assert_code_gen(0);
+    }
+
+    switch (inst->opcode) {
+        case IR_ADD:
+            append_code(env->codes, "\tadd %s, %s\n", src, reg_a);
+            break;
+        case IR_SUB:
+            append_code(env->codes, "\tsub %s, %s\n", src, reg_a);
+            break;
+        case IR_MUL:
+            append_code(env->codes, "\timul %s, %s\n", src, reg_a);
+            break;
+        case IR_DIV:
+        case IR_MOD:
+            append_code(env->codes, inst->width == 8 ? "\tcqo\n" : "\tcltd\n");
+            append_code(env->codes, "\tidiv %s\n", reg_di);
+            if (inst->opcode == IR_MOD) append_code(env->codes, "\tmov %%rdx, %%rax\n");
+            break;
+        case IR_SHL:
+            append_code(env->codes, "\tsal %s, %s\n", src, reg_a);
+            break;
+        case IR_SAR:
+            append_code(env->codes, "\tsar %s, %s\n", src, reg_a);
+            break;
+        case IR_AND:
+            append_code(env->codes, "\tand %s, %s\n", src, reg_a);
+            break;
+        case IR_XOR:
+            append_code(env->codes, "\txor %s, %s\n", src, reg_a);
+            break;
+        case IR_OR:
+            append_code(env->codes, "\tor %s, %s\n", src, reg_a);
+            break;
+        default:
+            assert_code_gen(0);
+    }
+    gen_ir_result_code(inst->dst, "%rax", env);
+}
+
+void gen_ir_comparison_code(IrInst* inst, CodeEnv* env) {
+    gen_ir_compare_code(inst, env);
+    append_code(env->codes, "\tset%s %%al\n", ir_condition_code(inst->opcode, 0));
+    append_code(env->codes, "\tmovzb %%al, %%eax\n");
+    gen_ir_result_code(inst->dst, "%rax", env);
+}
+
+void gen_ir_compare_code(IrInst* inst, CodeEnv* env) {
+    IrOperand* rhs = ir_inst_nth_src(inst, 1);
+    gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rax", env);
+    if (rhs->type == IR_OPERAND_IMM) {
+        append_code(env->codes, "\tcmp $%d, %s\n", rhs->value, ir_register_a(inst->width));
+    } else {
+        gen_ir_operand_code(rhs, "%rdi", env);
+        append_code(env->codes, "\tcmp %s, %s\n", ir_register_di(inst->width), ir_register_a(inst->width));
+    }
+}
+
+void gen_ir_vector_op_code(IrInst* inst, CodeEnv* env) {
+    int avx = env->option->vector_width == 32;
+    char reg[8];
+    char src[8];
+    if (inst->srcs->size > 0 && ir_inst_nth_src(inst, 0)->type == IR_OPERAND_IMM) {
+        sprintf(reg, "%%%s%d", avx ? "ymm" : "xmm", ir_inst_nth_src(inst, 0)->value);
+    }
+    if (inst->srcs->size > 1 && ir_inst_nth_src(inst, 1)->type == IR_OPERAND_IMM) {
+        sprintf(src, "%%%s%d", avx ? "ymm" : "xmm", ir_inst_nth_src(inst, 1)->value);
+    }
+
+    char* prefix = avx ? "v" : "";
+    char* suffix = inst->width == 1 ? "b" : "d";
+    switch (inst->opcode) {
+        case IR_VLOAD:
+            gen_ir_operand_code(ir_inst_nth_src(inst, 1), "%rax", env);
+            append_code(env->codes, "\t%smovdqu (%%rax), %s\n", prefix, reg);
+            return;
+        case IR_VSTORE:
+            sprintf(src, "%%%s%d", avx ? "ymm" : "xmm", ir_inst_nth_src(inst, 1)->value);
+            gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rax", env);
+            append_code(env->codes, "\t%smovdqu %s, (%%rax)\n", prefix, src);
+            return;
+        case IR_VSPLAT:
+            gen_ir_vector_splat_code(inst, reg, avx, env);
+            return;
+        case IR_VZERO:
+            if (avx) append_code(env->codes, "\tvpxor %s, %s, %s\n", reg, reg, reg);
+            else     append_code(env->codes, "\tpxor %s, %s\n", reg, reg);
+            return;
+        case IR_VADD:
+        case IR_VSUB:
+        case IR_VAND:
+        case IR_VXOR:
+        case IR_VOR: {
+            char mnemonic[16];
+            switch (inst->opcode) {
+                case IR_VADD: sprintf(mnemonic, "padd%s", suffix); break;
+                case IR_VSUB: sprintf(mnemonic, "psub%s", suffix); break;
+                case IR_VAND: sprintf(mnemonic, "pand");           break;
+                case IR_VXOR: sprintf(mnemonic, "pxor");           break;
+                default:      sprintf(mnemonic, "por");            break;
+            }
+            if (avx) append_code(env->codes, "\tv%s %s, %s, %s\n", mnemonic, src, reg, reg);
+            else     append_code(env->codes, "\t%s %s, %s\n", mnemonic, src, reg);
+            return;
+        }
+        case IR_VREDUCE:
+            gen_ir_vector_reduce_code(inst, reg, avx, env);
+            return;
+        case IR_VEND:
+            if (avx) append_code(env->codes, "\tvzeroupper\n");
+            return;
+        default:
+            assert_code_gen(0);
+    }
+}
+
+void gen_ir_vector_splat_code(IrInst* inst, char* reg, int avx, CodeEnv* env) {
+    char xmm[8];
+    sprintf(xmm, "%%xmm%d", ir_inst_nth_src(inst, 0)->value);
+    gen_ir_operand_code(ir_inst_nth_src(inst, 1), "%rax", env);
+    if (avx) {
+        append_code(env->codes, "\tvmovd %%eax, %s\n", xmm);
+        append_code(env->codes, "\tvpbroadcast%s %s, %s\n", inst->width == 1 ? "b" : "d", xmm, reg);
+        return;
+    }
+    append_code(env->codes, "\tmovd %%eax, %s\n", xmm);
+    if (inst->width == 1) {
+        append_code(env->codes, "\tpunpcklbw %s, %s\n", xmm, xmm);
+        append_code(env->codes, "\tpunpcklwd %s, %s\n", xmm, xmm);
+    }
+    append_code(env->codes, "\tpshufd $0, %s, %s\n", xmm, xmm);
+}
+
+void gen_ir_vector_reduce_code(IrInst* inst, char* reg, int avx, CodeEnv* env) {
+    char xmm[8];
+    sprintf(xmm, "%%xmm%d", ir_inst_nth_src(inst, 0)->value);
+    if (avx) {
+        append_code(env->codes, "\tvextracti128 $1, %s, %%xmm0\n", reg);
+        append_code(env->codes, "\tvpaddd %%xmm0, %s, %s\n", xmm, xmm);
+        append_code(env->codes, "\tvpshufd $0x4e, %s, %%xmm0\n", xmm);
+        append_code(env->codes, "\tvpaddd %%xmm0, %s, %s\n", xmm, xmm);
+        append_code(env->codes, "\tvpshufd $0xb1, %s, %%xmm0\n", xmm);
+        append_code(env->codes, "\tvpaddd %%xmm0, %s, %s\n", xmm, xmm);
+        append_code(env->codes, "\tvmovd %s, %%eax\n", xmm);
+    } else {
+        append_code(env->codes, "\tpshufd $0x4e, %s, %%xmm0\n", xmm);
+        append_code(env->codes, "\tpaddd %%xmm0, %s\n", xmm);
+        append_code(env->codes, "\tpshufd $0xb1, %s, %%xmm0\n", xmm);
+        append_code(env->codes, "\tpaddd %%xmm0, %s\n", xmm);
+        append_code(env->codes, "\tmovd %s, %%eax\n", xmm);
+    }
+    gen_ir_result_code(inst->dst, "%rax", env);
+}
+
+void gen_ir_call_code(IrInst* inst, CodeEnv* env) {
+    gen_ir_call_args_code(inst, env);
+    append_code(env->codes, "\tcall _%s\n", inst->symbol);
+    if (inst->dst >= 0) gen_ir_result_code(inst->dst, "%rax", env);
+}
+
+void gen_ir_call_args_code(IrInst* inst, CodeEnv* env) {
+    size_t i = 0, num_args = inst->srcs->size;
+    // TODO: more than six arguments
+    assert_code_gen(num_args <= 6);
+    for (i = 0; i < num_args; i++) {
+        gen_ir_operand_code(ir_inst_nth_src(inst, i), arg_register8[i], env);
+    }
+}
+
+void gen_ir_tail_call_code(IrInst* inst, CodeEnv* env) {
+    gen_ir_call_args_code(inst, env);
+    gen_tail_jump_code(inst->symbol, env);
+}
+
+int is_ir_tail_call(IrBlock* block, size_t index) {
+    size_t size = block->insts->size;
+    if (index + 2 != size) return 0;
+
+    IrInst* call = (IrInst*)vector_at(block->insts, index);
+    IrInst* ret = (IrInst*)vector_at(block->insts, index + 1);
+    if (call->opcode != IR_CALL || call->dst < 0 || ret->opcode != IR_RET || ret->srcs->size != 1) return 0;
+
+    IrOperand* value = ir_inst_nth_src(ret, 0);
+    return value->type == IR_OPERAND_VREG && value->value == call->dst;
+}
+
+void gen_ir_branch_code(IrInst* inst, IrBlock* next_block, char** block_labels, CodeEnv* env) {
+    gen_ir_operand_code(ir_inst_nth_src(inst, 0), "%rax", env);
+    append_code(env->codes, "\tcmp $0, %s\n", ir_register_a(inst->width));
+    gen_ir_conditional_jump_code("ne", "e", inst, next_block, block_labels, env);
+}
+
+void gen_ir_fused_branch_code(IrInst* compare, IrInst* branch, IrBlock* next_block, char** block_labels, CodeEnv* env) {
+    gen_ir_compare_code(compare, env);
+    gen_ir_conditional_jump_code(
+        ir_condition_code(compare->opcode, 0), ir_condition_code(compare->opcode, 1),
+        branch, next_block, block_labels, env
+    );
+}
+
+void gen_ir_conditional_jump_code(
+    char* condition, char* negated_condition,
+    IrInst* branch, IrBlock* next_block, char** block_labels, CodeEnv* env
+) {
+    IrBlock* true_block = branch->targets[0];
+    IrBlock* false_block = branch->targets[1];
+    if (true_block == next_block) {
+        append_code(env->codes, "\tj%s .L%s\n", negated_condition, block_labels[false_block->id]);
+        return;
+    }
+    append_code(env->codes, "\tj%s .L%s\n", condition, block_labels[true_block->id]);
+    if (false_block != next_block) {
+        append_code(env->codes, "\tjmp .L%s\n", block_labels[false_block->id]);
+    }
+}
+
+// branch-fusion
+int* count_vreg_uses(IrFunction* func) {
+    int* use_counts = (int*)safe_malloc(func->num_vregs * sizeof(int));
+    memset(use_counts, 0, func->num_vregs * sizeof(int));
+
+    size_t i = 0, j = 0, k = 0, num_blocks = func->blocks->size;
+    for (i = 0; i < num_blocks; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        size_t num_insts = block->insts->size;
+        for (j = 0; j < num_insts; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            size_t num_srcs = inst->srcs->size;
+            for (k = 0; k < num_srcs; k++) {
+                IrOperand* src = ir_inst_nth_src(inst, k);
+                if (src->type == IR_OPERAND_VREG) use_counts[src->value]++;
+            }
+        }
+    }
+    return use_counts;
+}
+
+IrInst* find_fusible_comparison(IrBlock* block, int* use_counts) {
+    IrInst* branch = ir_block_terminator(block);
+    if (branch == NULL || branch->opcode != IR_BR) return NULL;
+    IrOperand* cond = ir_inst_nth_src(branch, 0);
+    if (cond->type != IR_OPERAND_VREG || use_counts[cond->value] != 1) return NULL;
+
+    size_t i = block->insts->size - 1, j = 0, k = 0;
+    while (i > 0) {
+        i--;
+        IrInst* inst = (IrInst*)vector_at(block->insts, i);
+        if (inst->dst == cond->value) break;
+        if (inst->opcode != IR_MOV) return NULL;
+    }
+    IrInst* compare = (IrInst*)vector_at(block->insts, i);
+    if (compare->dst != cond->value || !ir_is_comparison(compare->opcode)) return NULL;
+
+    size_t num_insts = block->insts->size - 1;
+    for (j = i + 1; j < num_insts; j++) {
+        IrInst* inst = (IrInst*)vector_at(block->insts, j);
+        for (k = 0; k < 2; k++) {
+            IrOperand* src = ir_inst_nth_src(compare, k);
+            if (src->type == IR_OPERAND_VREG && src->value == inst->dst) return NULL;
+        }
+    }
+    return compare;
+}
+
+char* ir_condition_code(IrOpcode opcode, int negate) {
+    switch (opcode) {
+        case IR_EQ:
+            return negate ? "ne" : "e";
+        case IR_NE:
+            return negate ? "e" : "ne";
+        case IR_LT:
+            return negate ? "ge" : "l";
+        case IR_GT:
+            return negate ? "le" : "g";
+        case IR_LE:
+            return negate ? "g" : "le";
+        case IR_GE:
+            return negate ? "l" : "ge";
+        default:
+            assert_code_gen(0);
+    }
+    return NULL;
+}
+
+// live-point
+Vector* create_live_points(IrFunction* func, int* block_begins, int* block_ends) {
+    Vector* live_points = vector_new();
+    Liveness* liveness = liveness_new(func);
+
+    size_t i = 0, size = func->blocks->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        int vreg = 0;
+        for (vreg = 0; vreg < func->num_vregs; vreg++) {
+            if (liveness_is_live_in(liveness, block, vreg)) {
+                vector_push_back(live_points, live_point_new(vreg, block_begins[block->id]));
+            }
+            if (liveness_is_live_out(liveness, block, vreg)) {
+                vector_push_back(live_points, live_point_new(vreg, block_ends[block->id]));
+            }
+        }
+    }
+
+    liveness_delete(liveness);
+    return live_points;
+}
+
+// utils
+void gen_ir_operand_code(IrOperand* operand, char* reg, CodeEnv* env) {
+    switch (operand->type) {
+        case IR_OPERAND_VREG:
+            append_code(env->codes, "\tmovq %%v%d, %s\n", operand->value, reg);
+            break;
+        case IR_OPERAND_IMM:
+            append_code(env->codes, "\tmovq $%d, %s\n", operand->value, reg);
+            break;
+    }
+}
+
+void gen_ir_result_code(int dst, char* reg, CodeEnv* env) {
+    append_code(env->codes, "\tmovq %s, %%v%d\n", reg, dst);
+}
+
+char* ir_register_a(int width) {
+    return width == 8 ? "%rax" : "%eax";
+}
+
+char* ir_register_di(int width) {
+    return width == 8 ? "%rdi" : "%edi";
+}
@@ -0,0 +1,13 @@
+#ifndef _IRGEN_H_
+#define _IRGEN_H_
+
+
+#include "../common/option.h"
+#include "../common/vector.h"
+#include "../ir/ir.h"
+
+
+void gen_ir_function_code(IrFunction* func, Vector* codes, Option* option);
+
+
+#endif  // _IRGEN_H_
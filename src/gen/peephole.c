@@ -0,0 +1,625 @@
+#include "peephole.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "asminst.h"
+#include "../common/memory.h"
+
+
+#define MAX_PEEPHOLE_PASSES 8
+#define MAX_SCAN_STEPS 64
+#define MAX_PUSH_POP_DISTANCE 8
+
+#define REG_BIT(reg) (1 << (reg))
+#define RAX_BIT REG_BIT(0)
+#define RSP_BIT REG_BIT(7)
+#define FRAME_MASK (REG_BIT(6) | REG_BIT(7))
+#define ARG_MASK (REG_BIT(5) | REG_BIT(4) | REG_BIT(3) | REG_BIT(2) | REG_BIT(8) | REG_BIT(9))
+#define CALLEE_SAVED_MASK (REG_BIT(1) | REG_BIT(12) | REG_BIT(13) | REG_BIT(14) | REG_BIT(15))
+#define RET_LIVE_MASK (RAX_BIT | FRAME_MASK | CALLEE_SAVED_MASK)
+
+typedef enum {
+    PEEPHOLE_PUSH_POP,
+    PEEPHOLE_PUSH_DISCARD,
+    PEEPHOLE_SELF_MOVE,
+    PEEPHOLE_JUMP_TO_NEXT,
+    PEEPHOLE_COMPARE_ZERO,
+    PEEPHOLE_COPY_PROPAGATION,
+    PEEPHOLE_ADDRESS_FOLDING,
+    PEEPHOLE_DEAD_MOVE,
+    PEEPHOLE_SETCC_BRANCH,
+    PEEPHOLE_SCALED_INDEX,
+    PEEPHOLE_ACCUMULATOR_FOLDING,
+    PEEPHOLE_OPERAND_FORWARDING,
+    NUM_PEEPHOLE_PATTERNS
+} PeepholePattern;
+
+char* peephole_pattern_name[] = {
+    "push-pop", "push-discard", "self-move", "jump-to-next", "compare-zero",
+    "copy-propagation", "address-folding", "dead-move", "setcc-branch",
+    "scaled-index", "accumulator-folding", "operand-forwarding"
+};
+
+typedef struct {
+    int reads;
+    int kills;
+    int barrier;
+} AsmEffect;
+
+typedef int (*PeepholeRule)(Vector* insts, size_t index);
+
+
+// peephole
+void optimize_peephole_chunk(Vector* insts, int* hits);
+
+// rule
+int apply_push_pop(Vector* insts, size_t index);
+int apply_push_discard(Vector* insts, size_t index);
+int apply_self_move(Vector* insts, size_t index);
+int apply_jump_to_next(Vector* insts, size_t index);
+int apply_compare_zero(Vector* insts, size_t index);
+int apply_copy_propagation(Vector* insts, size_t index);
+int apply_address_folding(Vector* insts, size_t index);
+int apply_dead_move(Vector* insts, size_t index);
+int apply_setcc_branch(Vector* insts, size_t index);
+int apply_scaled_index(Vector* insts, size_t index);
+int apply_accumulator_folding(Vector* insts, size_t index);
+int apply_operand_forwarding(Vector* insts, size_t index);
+
+// liveness
+int is_dead_after(Vector* insts, size_t index, int mask);
+int scan_dead(Vector* insts, size_t index, int mask, int* budget);
+AsmEffect analyze_effect(AsmInst* inst);
+void analyze_move_effect(AsmInst* inst, AsmEffect* effect);
+
+// classifier
+int is_move(AsmInst* inst);
+int is_accumulator_op(AsmInst* inst);
+int is_opcode(AsmInst* inst, char* base);
+int is_conditional_jump(AsmInst* inst);
+int is_setcc(AsmInst* inst);
+int find_label(Vector* insts, char* label);
+int register_dst_width(AsmInst* inst);
+char* negate_condition(char* condition);
+
+// utils
+AsmInst* inst_at(Vector* insts, size_t index);
+void erase_inst(Vector* insts, size_t index);
+void replace_inst(Vector* insts, size_t index, AsmInst* inst);
+char* register_operand(int reg, int width);
+
+
+PeepholeRule peephole_rules[] = {
+    apply_push_pop, apply_push_discard, apply_self_move, apply_jump_to_next, apply_compare_zero,
+    apply_copy_propagation, apply_address_folding, apply_dead_move, apply_setcc_branch,
+    apply_scaled_index, apply_accumulator_folding, apply_operand_forwarding
+};
+
+
+void optimize_peephole(Vector* codes, Option* option) {
+    int hits[NUM_PEEPHOLE_PATTERNS] = { 0 };
+    Vector* optimized = vector_new();
+    Vector* chunk = vector_new();
+
+    size_t i = 0, j = 0, size = codes->size;
+    for (i = 0; i <= size; i++) {
+        char* code = i < size ? (char*)vector_at(codes, i) : NULL;
+        if (code == NULL || strcmp(code, "\t.text\n") == 0) {
+            optimize_peephole_chunk(chunk, hits);
+            for (j = 0; j < chunk->size; j++) {
+                AsmInst* inst = inst_at(chunk, j);
+                vector_push_back(optimized, asm_inst_render(inst));
+                asm_inst_delete(inst);
+            }
+            chunk->size = 0;
+        }
+        if (code != NULL) vector_push_back(chunk, asm_inst_parse(code));
+    }
+    vector_delete(chunk);
+
+    for (i = 0; i < size; i++) {
+        free(codes->data[i]);
+    }
+    free(codes->data);
+    *codes = *optimized;
+    free(optimized);
+
+    if (!option->peephole_stats) return;
+    for (i = 0; i < NUM_PEEPHOLE_PATTERNS; i++) {
+        fprintf(stderr, "peephole: %-20s %d\n", peephole_pattern_name[i], hits[i]);
+    }
+}
+
+// peephole
+void optimize_peephole_chunk(Vector* insts, int* hits) {
+    int pass = 0, changed = 1;
+    for (pass = 0; changed && pass < MAX_PEEPHOLE_PASSES; pass++) {
+        changed = 0;
+        size_t i = 0;
+        while (i < insts->size) {
+            int pattern = 0;
+            for (pattern = 0; pattern < NUM_PEEPHOLE_PATTERNS; pattern++) {
+                if (peephole_rules[pattern](insts, i)) break;
+            }
+            if (pattern == NUM_PEEPHOLE_PATTERNS) {
+                i++;
+                continue;
+            }
+            hits[pattern]++;
+            changed = 1;
+            i = i >= 2 ? i - 2 : 0;
+        }
+    }
+}
+
+// rule
+int apply_push_pop(Vector* insts, size_t index) {
+    AsmInst* push = inst_at(insts, index);
+    if (!asm_inst_is(push, "push", 1)) return 0;
+    char* value = asm_inst_nth_operand(push, 0);
+    if (asm_operand_is_memory(value)) return 0;
+    int value_mask = asm_operand_register_mask(value);
+
+    size_t i = 0;
+    for (i = index + 1; i < insts->size && i <= index + MAX_PUSH_POP_DISTANCE; i++) {
+        AsmInst* inst = inst_at(insts, i);
+        if (asm_inst_is(inst, "pop", 1)) {
+            char* dst = asm_inst_nth_operand(inst, 0);
+            if (strcmp(value, dst) == 0) {
+                erase_inst(insts, i);
+            } else {
+                replace_inst(insts, i, asm_inst_new("mov", 2, value, dst));
+            }
+            erase_inst(insts, index);
+            return 1;
+        }
+
+        AsmEffect effect = analyze_effect(inst);
+        if (inst->type != ASM_INST_OP || effect.barrier || is_opcode(inst, "push")) return 0;
+        if (is_opcode(inst, "call") || is_opcode(inst, "jmp") || is_conditional_jump(inst)) return 0;
+        if ((effect.reads | effect.kills) & RSP_BIT) return 0;
+
+        int mask = 0;
+        size_t j = 0;
+        for (j = 0; j < inst->operands->size; j++) {
+            mask |= asm_operand_register_mask(asm_inst_nth_operand(inst, j));
+        }
+        if ((mask | effect.kills) & value_mask) return 0;
+    }
+    return 0;
+}
+
+int apply_push_discard(Vector* insts, size_t index) {
+    if (index + 1 >= insts->size) return 0;
+    AsmInst* push = inst_at(insts, index);
+    AsmInst* add = inst_at(insts, index + 1);
+    if (!asm_inst_is(push, "push", 1) || !asm_inst_is(add, "add", 2)) return 0;
+    if (strcmp(asm_inst_nth_operand(add, 0), "$8") != 0) return 0;
+    if (strcmp(asm_inst_nth_operand(add, 1), "%rsp") != 0) return 0;
+
+    erase_inst(insts, index + 1);
+    erase_inst(insts, index);
+    return 1;
+}
+
+int apply_self_move(Vector* insts, size_t index) {
+    AsmInst* inst = inst_at(insts, index);
+    if (!asm_inst_is(inst, "mov", 2) && !asm_inst_is(inst, "movq", 2)) return 0;
+
+    int width = 0;
+    if (asm_operand_register(asm_inst_nth_operand(inst, 0), &width) < 0 || width != 8) return 0;
+    if (strcmp(asm_inst_nth_operand(inst, 0), asm_inst_nth_operand(inst, 1)) != 0) return 0;
+
+    erase_inst(insts, index);
+    return 1;
+}
+
+int apply_jump_to_next(Vector* insts, size_t index) {
+    AsmInst* jump = inst_at(insts, index);
+    if (!asm_inst_is(jump, "jmp", 1)) return 0;
+
+    char* target = asm_inst_nth_operand(jump, 0);
+    size_t i = 0;
+    for (i = index + 1; i < insts->size; i++) {
+        AsmInst* inst = inst_at(insts, i);
+        if (inst->type != ASM_INST_LABEL) return 0;
+        if (strcmp(inst->opcode, target) != 0) continue;
+        erase_inst(insts, index);
+        return 1;
+    }
+    return 0;
+}
+
+int apply_compare_zero(Vector* insts, size_t index) {
+    AsmInst* cmp = inst_at(insts, index);
+    if (!asm_inst_is(cmp, "cmp", 2) || strcmp(asm_inst_nth_operand(cmp, 0), "$0") != 0) return 0;
+
+    char* reg = asm_inst_nth_operand(cmp, 1);
+    if (asm_operand_register(reg, NULL) < 0) return 0;
+
+    replace_inst(insts, index, asm_inst_new("test", 2, reg, reg));
+    return 1;
+}
+
+int apply_copy_propagation(Vector* insts, size_t index) {
+    if (index + 1 >= insts->size) return 0;
+    AsmInst* def = inst_at(insts, index);
+    AsmInst* copy = inst_at(insts, index + 1);
+    if (!is_move(def) || (!asm_inst_is(copy, "mov", 2) && !asm_inst_is(copy, "movq", 2))) return 0;
+
+    int def_width = register_dst_width(def);
+    if (def_width < 4) return 0;
+    int src_width = 0, dst_width = 0;
+    int def_reg = asm_operand_register(asm_inst_nth_operand(def, 1), NULL);
+    int src_reg = asm_operand_register(asm_inst_nth_operand(copy, 0), &src_width);
+    int dst_reg = asm_operand_register(asm_inst_nth_operand(copy, 1), &dst_width);
+    if (src_reg != def_reg || dst_reg < 0 || dst_reg == def_reg || src_width != dst_width) return 0;
+    if (src_width != 8 && src_width != def_width) return 0;
+    if (REG_BIT(def_reg) & FRAME_MASK) return 0;
+    if (!is_dead_after(insts, index + 1, REG_BIT(def_reg))) return 0;
+
+    asm_inst_set_nth_operand(def, 1, str_new(asm_inst_nth_operand(copy, 1)));
+    if (def_width != dst_width) asm_inst_set_nth_operand(def, 1, register_operand(dst_reg, def_width));
+    erase_inst(insts, index + 1);
+    return 1;
+}
+
+int apply_address_folding(Vector* insts, size_t index) {
+    if (index + 1 >= insts->size) return 0;
+    AsmInst* lea = inst_at(insts, index);
+    AsmInst* user = inst_at(insts, index + 1);
+    if (!asm_inst_is(lea, "lea", 2) || user->type != ASM_INST_OP) return 0;
+    if (is_opcode(user, "push") || is_opcode(user, "pop") || is_opcode(user, "call")) return 0;
+
+    int width = 0;
+    int reg = asm_operand_register(asm_inst_nth_operand(lea, 1), &width);
+    if (reg < 0 || width != 8 || (REG_BIT(reg) & FRAME_MASK)) return 0;
+
+    char indirect[16];
+    sprintf(indirect, "(%s)", asm_inst_nth_operand(lea, 1));
+    int found = -1;
+    size_t i = 0, size = user->operands->size;
+    for (i = 0; i < size; i++) {
+        char* operand = asm_inst_nth_operand(user, i);
+        if (strcmp(operand, indirect) == 0 && found < 0) {
+            found = i;
+        } else if (asm_operand_register_mask(operand) & REG_BIT(reg)) {
+            if (is_move(user) && i + 1 == size && register_dst_width(user) >= 4) continue;
+            return 0;
+        }
+    }
+    if (found < 0) return 0;
+    if (!(analyze_effect(user).kills & REG_BIT(reg)) && !is_dead_after(insts, index + 1, REG_BIT(reg))) return 0;
+
+    asm_inst_set_nth_operand(user, found, str_new(asm_inst_nth_operand(lea, 0)));
+    erase_inst(insts, index);
+    return 1;
+}
+
+int apply_dead_move(Vector* insts, size_t index) {
+    AsmInst* inst = inst_at(insts, index);
+    if (!is_move(inst) || register_dst_width(inst) < 4) return 0;
+
+    int reg = asm_operand_register(asm_inst_nth_operand(inst, 1), NULL);
+    if (REG_BIT(reg) & FRAME_MASK) return 0;
+    if (!is_dead_after(insts, index, REG_BIT(reg))) return 0;
+
+    erase_inst(insts, index);
+    return 1;
+}
+
+int apply_setcc_branch(Vector* insts, size_t index) {
+    if (index + 3 >= insts->size) return 0;
+    AsmInst* setcc = inst_at(insts, index);
+    AsmInst* movzb = inst_at(insts, index + 1);
+    AsmInst* test = inst_at(insts, index + 2);
+    AsmInst* branch = inst_at(insts, index + 3);
+
+    if (!is_setcc(setcc) || strcmp(asm_inst_nth_operand(setcc, 0), "%al") != 0) return 0;
+    if (!asm_inst_is(movzb, "movzb", 2)) return 0;
+    if (strcmp(asm_inst_nth_operand(movzb, 0), "%al") != 0) return 0;
+    if (strcmp(asm_inst_nth_operand(movzb, 1), "%eax") != 0) return 0;
+    if (!asm_inst_is(test, "test", 2) && !asm_inst_is(test, "cmp", 2)) return 0;
+    char* lhs = asm_inst_nth_operand(test, 0);
+    char* rhs = asm_inst_nth_operand(test, 1);
+    if (strcmp(rhs, "%rax") != 0 && strcmp(rhs, "%eax") != 0) return 0;
+    if (asm_inst_is(test, "test", 2) ? strcmp(lhs, rhs) != 0 : strcmp(lhs, "$0") != 0) return 0;
+    if (!asm_inst_is(branch, "je", 1) && !asm_inst_is(branch, "jne", 1)) return 0;
+
+    char* target = asm_inst_nth_operand(branch, 0);
+    int label_index = find_label(insts, target);
+    if (label_index < 0) return 0;
+    if (!is_dead_after(insts, index + 3, RAX_BIT | ASM_FLAGS_MASK)) return 0;
+    if (!is_dead_after(insts, label_index, RAX_BIT | ASM_FLAGS_MASK)) return 0;
+
+    char* condition = setcc->opcode + 3;
+    if (strcmp(branch->opcode, "je") == 0) condition = negate_condition(condition);
+    if (condition == NULL) return 0;
+
+    char opcode[8];
+    sprintf(opcode, "j%s", condition);
+    AsmInst* jump = asm_inst_new(opcode, 1, target);
+    replace_inst(insts, index + 3, jump);
+    erase_inst(insts, index + 2);
+    erase_inst(insts, index + 1);
+    erase_inst(insts, index);
+    return 1;
+}
+
+int apply_scaled_index(Vector* insts, size_t index) {
+    if (index + 1 >= insts->size) return 0;
+    AsmInst* sal = inst_at(insts, index);
+    AsmInst* add = inst_at(insts, index + 1);
+    if (!asm_inst_is(sal, "sal", 2) || !asm_inst_is(add, "add", 2)) return 0;
+
+    char* amount = asm_inst_nth_operand(sal, 0);
+    if (strcmp(amount, "$1") != 0 && strcmp(amount, "$2") != 0 && strcmp(amount, "$3") != 0) return 0;
+    int scale = 1 << (amount[1] - '0');
+
+    int index_width = 0, src_width = 0, dst_width = 0;
+    char* index_reg = asm_inst_nth_operand(sal, 1);
+    char* src = asm_inst_nth_operand(add, 0);
+    char* dst = asm_inst_nth_operand(add, 1);
+    int index_num = asm_operand_register(index_reg, &index_width);
+    int src_num = asm_operand_register(src, &src_width);
+    int dst_num = asm_operand_register(dst, &dst_width);
+    if (index_num < 0 || src_num < 0 || dst_num < 0 || src_num == dst_num) return 0;
+    if (index_width != 8 || src_width != 8 || dst_width != 8) return 0;
+
+    char* base = NULL;
+    if (src_num == index_num) {
+        if (!is_dead_after(insts, index + 1, REG_BIT(index_num))) return 0;
+        base = dst;
+    } else if (dst_num == index_num) {
+        base = src;
+    } else {
+        return 0;
+    }
+    if (!is_dead_after(insts, index + 1, ASM_FLAGS_MASK)) return 0;
+
+    char address[32];
+    sprintf(address, "(%s,%s,%d)", base, index_reg, scale);
+    replace_inst(insts, index + 1, asm_inst_new("lea", 2, address, dst));
+    erase_inst(insts, index);
+    return 1;
+}
+
+int apply_accumulator_folding(Vector* insts, size_t index) {
+    if (index + 2 >= insts->size) return 0;
+    AsmInst* load = inst_at(insts, index);
+    AsmInst* op = inst_at(insts, index + 1);
+    AsmInst* store = inst_at(insts, index + 2);
+    if (!asm_inst_is(load, "mov", 2) && !asm_inst_is(load, "movq", 2)) return 0;
+    if (!asm_inst_is(store, "mov", 2) && !asm_inst_is(store, "movq", 2)) return 0;
+    if (strcmp(asm_inst_nth_operand(load, 1), "%rax") != 0) return 0;
+    if (strcmp(asm_inst_nth_operand(store, 0), "%rax") != 0) return 0;
+    if (!is_accumulator_op(op)) return 0;
+
+    int op_width = 0, dst_width = 0;
+    if (asm_operand_register(asm_inst_nth_operand(op, 1), &op_width) != 0 || op_width < 4) return 0;
+    int dst_reg = asm_operand_register(asm_inst_nth_operand(store, 1), &dst_width);
+    if (dst_reg <= 0 || dst_width != 8 || (REG_BIT(dst_reg) & FRAME_MASK)) return 0;
+
+    int src_mask = asm_operand_register_mask(asm_inst_nth_operand(op, 0));
+    int value_reg = asm_operand_register(asm_inst_nth_operand(load, 0), NULL);
+    if (src_mask & RAX_BIT) return 0;
+    if (value_reg != dst_reg && (src_mask & REG_BIT(dst_reg))) return 0;
+    if (!is_dead_after(insts, index + 2, RAX_BIT)) return 0;
+
+    asm_inst_set_nth_operand(op, 1, register_operand(dst_reg, op_width));
+    erase_inst(insts, index + 2);
+    if (value_reg == dst_reg) {
+        erase_inst(insts, index);
+    } else {
+        asm_inst_set_nth_operand(load, 1, register_operand(dst_reg, 8));
+    }
+    return 1;
+}
+
+int apply_operand_forwarding(Vector* insts, size_t index) {
+    if (index + 1 >= insts->size) return 0;
+    AsmInst* copy = inst_at(insts, index);
+    AsmInst* op = inst_at(insts, index + 1);
+    if (!asm_inst_is(copy, "mov", 2) && !asm_inst_is(copy, "movq", 2)) return 0;
+    if (!is_accumulator_op(op)) return 0;
+
+    int value_width = 0, copy_width = 0, src_width = 0;
+    char* value = asm_inst_nth_operand(copy, 0);
+    int value_reg = asm_operand_register(value, &value_width);
+    int copy_reg = asm_operand_register(asm_inst_nth_operand(copy, 1), &copy_width);
+    if (copy_width != 8 || value_reg == copy_reg || (REG_BIT(copy_reg) & FRAME_MASK)) return 0;
+    if (asm_operand_register(asm_inst_nth_operand(op, 0), &src_width) != copy_reg) return 0;
+    if (value_reg < 0 ? !asm_operand_is_imm(value) || src_width != 4 : value_width != 8) return 0;
+    if (asm_operand_register_mask(asm_inst_nth_operand(op, 1)) & REG_BIT(copy_reg)) return 0;
+    if (!is_dead_after(insts, index + 1, REG_BIT(copy_reg))) return 0;
+
+    asm_inst_set_nth_operand(op, 0, value_reg < 0 ? str_new(value) : register_operand(value_reg, src_width));
+    erase_inst(insts, index);
+    return 1;
+}
+
+// liveness
+int is_dead_after(Vector* insts, size_t index, int mask) {
+    if (mask & FRAME_MASK) return 0;
+    int budget = MAX_SCAN_STEPS;
+    return scan_dead(insts, index + 1, mask, &budget);
+}
+
+int scan_dead(Vector* insts, size_t index, int mask, int* budget) {
+    size_t i = 0;
+    for (i = index; i < insts->size; i++) {
+        if (--(*budget) < 0) return 0;
+        AsmInst* inst = inst_at(insts, i);
+        if (inst->type == ASM_INST_LABEL) continue;
+
+        AsmEffect effect = analyze_effect(inst);
+        if (effect.barrier || (effect.reads & mask)) return 0;
+        if (is_opcode(inst, "ret")) return !(mask & RET_LIVE_MASK);
+        if (is_opcode(inst, "jmp") || is_conditional_jump(inst)) {
+            int label_index = find_label(insts, asm_inst_nth_operand(inst, 0));
+            if (label_index < 0 || !scan_dead(insts, label_index, mask, budget)) return 0;
+            if (is_opcode(inst, "jmp")) return 1;
+            continue;
+        }
+
+        mask &= ~effect.kills;
+        if (mask == 0) return 1;
+    }
+    return 0;
+}
+
+AsmEffect analyze_effect(AsmInst* inst) {
+    AsmEffect effect = { 0, 0, 0 };
+    if (inst->type == ASM_INST_LABEL) return effect;
+    if (inst->type == ASM_INST_DIRECTIVE) {
+        effect.barrier = 1;
+        return effect;
+    }
+
+    size_t i = 0, size = inst->operands->size;
+    int mask = 0;
+    for (i = 0; i < size; i++) {
+        mask |= asm_operand_register_mask(asm_inst_nth_operand(inst, i));
+    }
+
+    if (is_move(inst)) {
+        analyze_move_effect(inst, &effect);
+    } else if ((is_opcode(inst, "imul") || is_opcode(inst, "mul")) && size == 1) {
+        effect.reads = mask | RAX_BIT;
+        effect.kills = REG_BIT(3) | ASM_FLAGS_MASK;
+    } else if (
+        is_opcode(inst, "add") || is_opcode(inst, "sub") || is_opcode(inst, "and") ||
+        is_opcode(inst, "or") || is_opcode(inst, "xor") || is_opcode(inst, "imul") ||
+        is_opcode(inst, "sal") || is_opcode(inst, "sar") || is_opcode(inst, "shl") ||
+        is_opcode(inst, "shr") || is_opcode(inst, "cmp") || is_opcode(inst, "test") ||
+        is_opcode(inst, "neg")
+    ) {
+        effect.reads = mask;
+        effect.kills = ASM_FLAGS_MASK;
+    } else if (is_opcode(inst, "inc") || is_opcode(inst, "dec") || is_opcode(inst, "not")) {
+        effect.reads = mask;
+    } else if (is_setcc(inst)) {
+        effect.reads = mask | ASM_FLAGS_MASK;
+    } else if (is_opcode(inst, "push")) {
+        effect.reads = mask | RSP_BIT;
+    } else if (is_opcode(inst, "pop")) {
+        effect.reads = RSP_BIT;
+        effect.kills = mask;
+    } else if (is_opcode(inst, "cqo") || is_opcode(inst, "cltd") || is_opcode(inst, "cdq")) {
+        effect.reads = RAX_BIT;
+        effect.kills = REG_BIT(3);
+    } else if (is_opcode(inst, "idiv") || is_opcode(inst, "div")) {
+        effect.reads = mask | RAX_BIT | REG_BIT(3);
+        effect.kills = ASM_FLAGS_MASK;
+    } else if (is_opcode(inst, "call")) {
+        effect.reads = ARG_MASK | RAX_BIT | RSP_BIT;
+        effect.kills = REG_BIT(10) | REG_BIT(11) | ASM_FLAGS_MASK;
+    } else if (is_conditional_jump(inst)) {
+        effect.reads = ASM_FLAGS_MASK;
+    } else if (!is_opcode(inst, "jmp") && !is_opcode(inst, "ret")) {
+        effect.barrier = 1;
+    }
+    return effect;
+}
+
+void analyze_move_effect(AsmInst* inst, AsmEffect* effect) {
+    char* src = asm_inst_nth_operand(inst, 0);
+    char* dst = asm_inst_nth_operand(inst, 1);
+    effect->reads = asm_operand_register_mask(src);
+
+    int width = 0;
+    int reg = asm_operand_register(dst, &width);
+    if (reg < 0) {
+        effect->reads |= asm_operand_register_mask(dst);
+    } else if (width >= 4) {
+        effect->kills = REG_BIT(reg);
+    } else {
+        effect->reads |= REG_BIT(reg);
+    }
+}
+
+// classifier
+int is_move(AsmInst* inst) {
+    char* moves[] = {
+        "mov", "movq", "movl", "movsbl", "movsbq", "movzb", "movzbl", "movzbq", "movslq", "lea", NULL
+    };
+    if (inst->type != ASM_INST_OP || inst->operands->size != 2) return 0;
+
+    char** p = moves;
+    for (p = moves; *p != NULL; p++) {
+        if (strcmp(inst->opcode, *p) == 0) return 1;
+    }
+    return 0;
+}
+
+int is_accumulator_op(AsmInst* inst) {
+    if (inst->type != ASM_INST_OP || inst->operands->size != 2) return 0;
+    return is_opcode(inst, "add") || is_opcode(inst, "sub") || is_opcode(inst, "and") ||
+           is_opcode(inst, "or") || is_opcode(inst, "xor") || is_opcode(inst, "imul");
+}
+
+int is_opcode(AsmInst* inst, char* base) {
+    if (inst->type != ASM_INST_OP) return 0;
+
+    size_t len = strlen(base);
+    if (strncmp(inst->opcode, base, len) != 0) return 0;
+    char suffix = inst->opcode[len];
+    return suffix == '\0' || (inst->opcode[len + 1] == '\0' && strchr("bwlq", suffix) != NULL);
+}
+
+int is_conditional_jump(AsmInst* inst) {
+    return inst->type == ASM_INST_OP && inst->opcode[0] == 'j' && strcmp(inst->opcode, "jmp") != 0;
+}
+
+int is_setcc(AsmInst* inst) {
+    return inst->type == ASM_INST_OP && strncmp(inst->opcode, "set", 3) == 0;
+}
+
+int find_label(Vector* insts, char* label) {
+    size_t i = 0, size = insts->size;
+    for (i = 0; i < size; i++) {
+        AsmInst* inst = inst_at(insts, i);
+        if (inst->type == ASM_INST_LABEL && strcmp(inst->opcode, label) == 0) return i;
+    }
+    return -1;
+}
+
+int register_dst_width(AsmInst* inst) {
+    int width = 0;
+    if (inst->operands->size == 0) return 0;
+    char* dst = asm_inst_nth_operand(inst, inst->operands->size - 1);
+    if (asm_operand_register(dst, &width) < 0) return 0;
+    return width;
+}
+
+char* negate_condition(char* condition) {
+    char* conditions[] = { "e", "ne", "l", "ge", "g", "le", "b", "ae", "a", "be", NULL };
+    int i = 0;
+    for (i = 0; conditions[i] != NULL; i++) {
+        if (strcmp(conditions[i], condition) == 0) return conditions[i ^ 1];
+    }
+    return NULL;
+}
+
+// utils
+AsmInst* inst_at(Vector* insts, size_t index) {
+    return (AsmInst*)vector_at(insts, index);
+}
+
+void erase_inst(Vector* insts, size_t index) {
+    asm_inst_delete(inst_at(insts, index));
+    vector_erase(insts, index);
+}
+
+void replace_inst(Vector* insts, size_t index, AsmInst* inst) {
+    asm_inst_delete(inst_at(insts, index));
+    vector_assign_at(insts, index, inst);
+}
+
+char* register_operand(int reg, int width) {
+    char* name = asm_register_name(reg, width);
+    char* operand = (char*)safe_malloc((strlen(name) + 2) * sizeof(char));
+    sprintf(operand, "%%%s", name);
+    return operand;
+}
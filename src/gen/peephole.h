@@ -0,0 +1,12 @@
+#ifndef _PEEPHOLE_H_
+#define _PEEPHOLE_H_
+
+
+#include "../common/option.h"
+#include "../common/vector.h"
+
+
+void optimize_peephole(Vector* codes, Option* option);
+
+
+#endif  // _PEEPHOLE_H_
@@ -0,0 +1,146 @@
+#include "promote.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../parser/localtable.h"
+#include "../common/memory.h"
+
+
+#define MIN_PROMOTION_WEIGHT 2
+#define MAX_LOOP_DEPTH 4
+#define MAX_PROMOTION_WEIGHT (1 << 24)
+
+typedef struct {
+    int stack_index;
+    int weight;
+} PromotionCandidate;
+
+
+// use-counter
+void count_local_uses(Ast* ast, LocalTable* local_table, int loop_depth, Map* weights);
+void count_local_use(Ast* ident, LocalTable* local_table, int weight, Map* weights);
+int is_promotable_ctype(CType* ctype);
+
+// utils
+int compare_promotion_candidates(const void* x, const void* y);
+void create_stack_index_key(char* key, int stack_index);
+
+
+Map* promote_locals(Ast* ast, int num_registers) {
+    Ast* block = ast_nth_child(ast, 1);
+    Map* weights = map_new();
+    count_local_uses(block, block->local_table, 0, weights);
+
+    PromotionCandidate* candidates =
+        (PromotionCandidate*)safe_malloc((weights->size + 1) * sizeof(PromotionCandidate));
+    size_t i = 0, num_candidates = 0;
+    for (i = 0; i < weights->capacity; i++) {
+        map_item_t item = weights->data[i];
+        if (item.state != Filled || *(int*)item.value < MIN_PROMOTION_WEIGHT) continue;
+        candidates[num_candidates].stack_index = atoi(item.key);
+        candidates[num_candidates].weight = *(int*)item.value;
+        num_candidates++;
+    }
+    qsort(candidates, num_candidates, sizeof(PromotionCandidate), compare_promotion_candidates);
+
+    Map* promoted_locals = map_new();
+    for (i = 0; i < num_candidates && i < (size_t)num_registers; i++) {
+        char key[12];
+        create_stack_index_key(key, candidates[i].stack_index);
+        map_insert(promoted_locals, key, int_new(i));
+    }
+
+    free(candidates);
+    map_delete(weights);
+    return promoted_locals;
+}
+
+int promoted_register_of(Map* promoted_locals, int stack_index) {
+    if (promoted_locals == NULL || stack_index < 0) return -1;
+
+    char key[12];
+    create_stack_index_key(key, stack_index);
+    int* reg_index = (int*)map_find(promoted_locals, key);
+    return reg_index != NULL ? *reg_index : -1;
+}
+
+// use-counter
+void count_local_uses(Ast* ast, LocalTable* local_table, int loop_depth, Map* weights) {
+    if (ast == NULL) return;
+
+    switch (ast->type) {
+        case AST_IDENT: {
+            int depth = loop_depth < MAX_LOOP_DEPTH ? loop_depth : MAX_LOOP_DEPTH;
+            count_local_use(ast, local_table, 1 << (3 * depth), weights);
+            return;
+        }
+        case AST_ADDR: {
+            Ast* child = ast_nth_child(ast, 0);
+            if (child->type == AST_IDENT) {
+                count_local_use(child, local_table, -1, weights);
+                return;
+            }
+            break;
+        }
+        case AST_COMP_STMT:
+            local_table = ast->local_table;
+            break;
+        case AST_WHILE_STMT:
+        case AST_DOWHILE_STMT:
+        case AST_FOR_STMT:
+            loop_depth++;
+            break;
+        default:
+            break;
+    }
+
+    size_t i = 0, size = ast->children->size;
+    for (i = 0; i < size; i++) {
+        count_local_uses(ast_nth_child(ast, i), local_table, loop_depth, weights);
+    }
+}
+
+void count_local_use(Ast* ident, LocalTable* local_table, int weight, Map* weights) {
+    if (!is_promotable_ctype(ident->ctype)) return;
+    int stack_index = local_table_get_stack_index(local_table, ident->value_ident);
+    if (stack_index < 0) return;
+
+    char key[12];
+    create_stack_index_key(key, stack_index);
+    int* current = (int*)map_find(weights, key);
+    if (current == NULL) {
+        current = int_new(0);
+        map_insert(weights, key, current);
+    }
+    if (*current < 0) return;
+
+    if (weight < 0) {
+        *current = -1;
+    } else if (*current < MAX_PROMOTION_WEIGHT) {
+        *current += weight;
+    }
+}
+
+int is_promotable_ctype(CType* ctype) {
+    if (ctype == NULL) return 0;
+    switch (ctype->basic_ctype) {
+        case CTYPE_CHAR:
+        case CTYPE_INT:
+        case CTYPE_PTR:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// utils
+int compare_promotion_candidates(const void* x, const void* y) {
+    PromotionCandidate* candidate_x = (PromotionCandidate*)x;
+    PromotionCandidate* candidate_y = (PromotionCandidate*)y;
+    if (candidate_x->weight != candidate_y->weight) return candidate_y->weight - candidate_x->weight;
+    return candidate_x->stack_index - candidate_y->stack_index;
+}
+
+void create_stack_index_key(char* key, int stack_index) {
+    sprintf(key, "%d", stack_index);
+}
@@ -0,0 +1,13 @@
+#ifndef _PROMOTE_H_
+#define _PROMOTE_H_
+
+
+#include "../common/map.h"
+#include "../parser/ast.h"
+
+
+Map* promote_locals(Ast* ast, int num_registers);
+int promoted_register_of(Map* promoted_locals, int stack_index);
+
+
+#endif  // _PROMOTE_H_
@@ -0,0 +1,318 @@
+#include "regalloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "codenv.h"
+#include "genutil.h"
+#include "../common/memory.h"
+
+
+#define NUM_ALLOCATABLE_REGISTERS 8
+#define FRAME_REGISTER_INDEX 7
+
+char* allocatable_register[] = { "%r10", "%r11", "%rbx", "%r12", "%r13", "%r14", "%r15", "%rbp" };
+int is_callee_saved_register[] = { 0, 0, 1, 1, 1, 1, 1, 1 };
+
+
+typedef struct {
+    int temp;
+    int start;
+    int end;
+    int across_call;
+    int reg_index;
+    int stack_index;
+} LiveInterval;
+
+
+// live-interval
+LiveInterval* live_interval_new(int temp);
+LiveInterval** compute_live_intervals(Vector* codes, int num_temps, Vector* live_points);
+void extend_live_interval(LiveInterval* interval, int line);
+int find_temp(char* code, char** temp_begin, char** temp_end);
+
+// linear-scan
+void reserve_registers(Vector* reserved_registers, int* reserved);
+void linear_scan(LiveInterval** intervals, int num_temps, int* stack_offset, int* reserved, int* used);
+int compare_live_intervals(const void* x, const void* y);
+int find_free_register(LiveInterval* interval, LiveInterval** active, int* reserved);
+void spill_interval(LiveInterval* interval, int* stack_offset);
+int allocate_stack_slot(int* stack_offset);
+
+// rewriter
+void rewrite_temps(Vector* codes, LiveInterval** intervals);
+int has_dead_temp(char* code, LiveInterval** intervals);
+int count_spilled_temps(char* code, LiveInterval** intervals);
+char* rewrite_line_temps(char* code, LiveInterval** intervals);
+char* create_temp_location(LiveInterval* interval);
+
+
+// register-allocator
+void allocate_registers(
+    Vector* codes, int num_temps, Vector* live_points, Vector* reserved_registers,
+    int omit_frame_pointer, int* stack_offset, Vector* save_codes, Vector* restore_codes
+) {
+    int reserved[NUM_ALLOCATABLE_REGISTERS] = { 0 };
+    int used[NUM_ALLOCATABLE_REGISTERS] = { 0 };
+    reserve_registers(reserved_registers, reserved);
+
+    int i = 0;
+    for (i = 0; i < NUM_ALLOCATABLE_REGISTERS; i++) {
+        used[i] = reserved[i];
+    }
+    if (!omit_frame_pointer) reserved[FRAME_REGISTER_INDEX] = 1;
+
+    LiveInterval** intervals = NULL;
+    if (num_temps > 0) {
+        intervals = compute_live_intervals(codes, num_temps, live_points);
+        linear_scan(intervals, num_temps, stack_offset, reserved, used);
+        rewrite_temps(codes, intervals);
+    }
+
+    for (i = 0; i < NUM_ALLOCATABLE_REGISTERS; i++) {
+        if (!used[i] || !is_callee_saved_register[i]) continue;
+        int stack_index = allocate_stack_slot(stack_offset);
+        append_code(save_codes, "\tmov %s, -%d(%%rbp)\n", allocatable_register[i], stack_index);
+        append_code(restore_codes, "\tmov -%d(%%rbp), %s\n", stack_index, allocatable_register[i]);
+    }
+
+    for (i = 0; i < num_temps; i++) {
+        free(intervals[i]);
+    }
+    free(intervals);
+}
+
+// live-point
+LivePoint* live_point_new(int temp, int line) {
+    LivePoint* live_point = (LivePoint*)safe_malloc(sizeof(LivePoint));
+    live_point->temp = temp;
+    live_point->line = line;
+    return live_point;
+}
+
+// live-interval
+LiveInterval* live_interval_new(int temp) {
+    LiveInterval* interval = (LiveInterval*)safe_malloc(sizeof(LiveInterval));
+    interval->temp = temp;
+    interval->start = -1;
+    interval->end = -1;
+    interval->across_call = 0;
+    interval->reg_index = -1;
+    interval->stack_index = -1;
+    return interval;
+}
+
+LiveInterval** compute_live_intervals(Vector* codes, int num_temps, Vector* live_points) {
+    LiveInterval** intervals = (LiveInterval**)safe_malloc(num_temps * sizeof(LiveInterval*));
+    int i = 0;
+    for (i = 0; i < num_temps; i++) {
+        intervals[i] = live_interval_new(i);
+    }
+
+    int size = codes->size;
+    int* num_calls_before = (int*)safe_malloc((size + 1) * sizeof(int));
+    num_calls_before[0] = 0;
+    for (i = 0; i < size; i++) {
+        char* code = (char*)vector_at(codes, i);
+        int is_call = strncmp(code, "\tcall ", 6) == 0;
+        num_calls_before[i + 1] = num_calls_before[i] + is_call;
+
+        char* temp_begin = NULL;
+        char* temp_end = code;
+        int temp = -1;
+        while ((temp = find_temp(temp_end, &temp_begin, &temp_end)) >= 0) {
+            extend_live_interval(intervals[temp], i);
+        }
+    }
+
+    int num_live_points = live_points != NULL ? live_points->size : 0;
+    for (i = 0; i < num_live_points; i++) {
+        LivePoint* live_point = (LivePoint*)vector_at(live_points, i);
+        extend_live_interval(intervals[live_point->temp], live_point->line);
+    }
+
+    for (i = 0; i < num_temps; i++) {
+        LiveInterval* interval = intervals[i];
+        if (interval->start < 0) continue;
+        interval->across_call = num_calls_before[interval->end] > num_calls_before[interval->start + 1];
+    }
+    free(num_calls_before);
+    return intervals;
+}
+
+void extend_live_interval(LiveInterval* interval, int line) {
+    if (interval->start < 0 || line < interval->start) interval->start = line;
+    if (interval->end < line) interval->end = line;
+}
+
+int find_temp(char* code, char** temp_begin, char** temp_end) {
+    char* p = code;
+    while (1) {
+        p = strstr(p, "%v");
+        if (p == NULL) return -1;
+        if (isdigit(p[2])) break;
+        p += 2;
+    }
+    *temp_begin = p;
+    *temp_end = p + 2;
+    int temp = 0;
+    while (isdigit(**temp_end)) {
+        temp = 10 * temp + (**temp_end - '0');
+        (*temp_end)++;
+    }
+    return temp;
+}
+
+// linear-scan
+void reserve_registers(Vector* reserved_registers, int* reserved) {
+    if (reserved_registers == NULL) return;
+
+    size_t i = 0, j = 0, size = reserved_registers->size;
+    for (i = 0; i < size; i++) {
+        char* reg_name = (char*)vector_at(reserved_registers, i);
+        for (j = 0; j < NUM_ALLOCATABLE_REGISTERS; j++) {
+            if (strcmp(reg_name, allocatable_register[j]) == 0) reserved[j] = 1;
+        }
+    }
+}
+
+void linear_scan(LiveInterval** intervals, int num_temps, int* stack_offset, int* reserved, int* used) {
+    LiveInterval* active[NUM_ALLOCATABLE_REGISTERS] = { NULL };
+
+    LiveInterval** sorted_intervals = (LiveInterval**)safe_malloc(num_temps * sizeof(LiveInterval*));
+    memcpy(sorted_intervals, intervals, num_temps * sizeof(LiveInterval*));
+    qsort(sorted_intervals, num_temps, sizeof(LiveInterval*), compare_live_intervals);
+
+    int i = 0, j = 0;
+    for (i = 0; i < num_temps; i++) {
+        LiveInterval* interval = sorted_intervals[i];
+        if (interval->start < 0 || interval->start == interval->end) continue;
+
+        for (j = 0; j < NUM_ALLOCATABLE_REGISTERS; j++) {
+            if (active[j] != NULL && active[j]->end < interval->start) active[j] = NULL;
+        }
+
+        int reg_index = find_free_register(interval, active, reserved);
+        if (reg_index >= 0) {
+            interval->reg_index = reg_index;
+            active[reg_index] = interval;
+            used[reg_index] = 1;
+            continue;
+        }
+
+        LiveInterval* victim = NULL;
+        for (j = 0; j < NUM_ALLOCATABLE_REGISTERS; j++) {
+            if (reserved[j] || (interval->across_call && !is_callee_saved_register[j])) continue;
+            if (victim == NULL || active[j]->end > victim->end) victim = active[j];
+        }
+        if (victim != NULL && victim->end > interval->end) {
+            interval->reg_index = victim->reg_index;
+            active[victim->reg_index] = interval;
+            victim->reg_index = -1;
+            spill_interval(victim, stack_offset);
+        } else {
+            spill_interval(interval, stack_offset);
+        }
+    }
+    free(sorted_intervals);
+}
+
+int compare_live_intervals(const void* x, const void* y) {
+    LiveInterval* interval_x = *(LiveInterval**)x;
+    LiveInterval* interval_y = *(LiveInterval**)y;
+    if (interval_x->start != interval_y->start) return interval_x->start - interval_y->start;
+    return interval_x->temp - interval_y->temp;
+}
+
+int find_free_register(LiveInterval* interval, LiveInterval** active, int* reserved) {
+    int i = 0;
+    for (i = 0; i < NUM_ALLOCATABLE_REGISTERS; i++) {
+        if (reserved[i]) continue;
+        if (interval->across_call && !is_callee_saved_register[i]) continue;
+        if (active[i] == NULL) return i;
+    }
+    return -1;
+}
+
+void spill_interval(LiveInterval* interval, int* stack_offset) {
+    interval->stack_index = allocate_stack_slot(stack_offset);
+}
+
+int allocate_stack_slot(int* stack_offset) {
+    *stack_offset = (*stack_offset + 7) / 8 * 8 + 8;
+    return *stack_offset;
+}
+
+// rewriter
+void rewrite_temps(Vector* codes, LiveInterval** intervals) {
+    size_t i = 0, j = 0, size = codes->size;
+    for (i = 0; i < size; i++) {
+        char* code = (char*)vector_at(codes, i);
+        char* temp_begin = NULL;
+        char* temp_end = NULL;
+        if (find_temp(code, &temp_begin, &temp_end) < 0) {
+            codes->data[j++] = code;
+            continue;
+        }
+        if (has_dead_temp(code, intervals)) {
+            free(code);
+            continue;
+        }
+
+        assert_code_gen(count_spilled_temps(code, intervals) <= 1);
+        char* rewritten = rewrite_line_temps(code, intervals);
+        assert_code_gen(find_temp(rewritten, &temp_begin, &temp_end) < 0);
+        codes->data[j++] = rewritten;
+        free(code);
+    }
+    codes->size = j;
+}
+
+int has_dead_temp(char* code, LiveInterval** intervals) {
+    char* temp_begin = NULL;
+    char* temp_end = code;
+    int temp = -1;
+    while ((temp = find_temp(temp_end, &temp_begin, &temp_end)) >= 0) {
+        if (intervals[temp]->start == intervals[temp]->end) return 1;
+    }
+    return 0;
+}
+
+int count_spilled_temps(char* code, LiveInterval** intervals) {
+    char* temp_begin = NULL;
+    char* temp_end = code;
+    int temp = -1, num_spilled = 0;
+    while ((temp = find_temp(temp_end, &temp_begin, &temp_end)) >= 0) {
+        if (intervals[temp]->reg_index < 0) num_spilled++;
+    }
+    return num_spilled;
+}
+
+char* rewrite_line_temps(char* code, LiveInterval** intervals) {
+    char* temp_begin = NULL;
+    char* temp_end = NULL;
+    int temp = find_temp(code, &temp_begin, &temp_end);
+    if (temp < 0) return str_new(code);
+
+    char* location = create_temp_location(intervals[temp]);
+    char* rest = rewrite_line_temps(temp_end, intervals);
+    size_t prefix_len = temp_begin - code;
+    char* rewritten = (char*)safe_malloc((prefix_len + strlen(location) + strlen(rest) + 1) * sizeof(char));
+    strncpy(rewritten, code, prefix_len);
+    strcpy(rewritten + prefix_len, location);
+    strcat(rewritten, rest);
+    free(rest);
+    free(location);
+    return rewritten;
+}
+
+char* create_temp_location(LiveInterval* interval) {
+    char* location = (char*)safe_malloc(16 * sizeof(char));
+    if (interval->reg_index >= 0) {
+        strcpy(location, allocatable_register[interval->reg_index]);
+    } else {
+        sprintf(location, "-%d(%%rbp)", interval->stack_index);
+    }
+    return location;
+}
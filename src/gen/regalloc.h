@@ -0,0 +1,24 @@
+#ifndef _REGALLOC_H_
+#define _REGALLOC_H_
+
+
+#include "../common/vector.h"
+
+
+typedef struct {
+    int temp;
+    int line;
+} LivePoint;
+
+
+// register-allocator
+void allocate_registers(
+    Vector* codes, int num_temps, Vector* live_points, Vector* reserved_registers,
+    int omit_frame_pointer, int* stack_offset, Vector* save_codes, Vector* restore_codes
+);
+
+// live-point
+LivePoint* live_point_new(int temp, int line);
+
+
+#endif  // _REGALLOC_H_
@@ -0,0 +1,178 @@
+#include "cse.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../common/map.h"
+#include "../common/memory.h"
+
+
+#define MAX_VALUE_KEY_LENGTH 64
+
+
+// value-numbering
+void number_block_values(IrBlock* block, int* replacements, char* single_def);
+int is_numbered_inst(IrInst* inst, char* single_def);
+char* create_value_key(IrInst* inst);
+int is_commutative(IrOpcode opcode);
+
+// utils
+char* count_single_defs(IrFunction* func);
+void replace_srcs(IrInst* inst, int* replacements);
+
+
+void eliminate_common_subexprs(IrFunction* func) {
+    int num_vregs = func->num_vregs;
+    int* replacements = (int*)safe_malloc((num_vregs + 1) * sizeof(int));
+    int i = 0;
+    for (i = 0; i <= num_vregs; i++) {
+        replacements[i] = -1;
+    }
+    char* single_def = count_single_defs(func);
+
+    size_t j = 0, k = 0, size = func->blocks->size;
+    for (j = 0; j < size; j++) {
+        number_block_values((IrBlock*)vector_at(func->blocks, j), replacements, single_def);
+    }
+    for (j = 0; j < size; j++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, j);
+        for (k = 0; k < block->insts->size; k++) {
+            replace_srcs((IrInst*)vector_at(block->insts, k), replacements);
+        }
+    }
+
+    free(single_def);
+    free(replacements);
+}
+
+// value-numbering
+void number_block_values(IrBlock* block, int* replacements, char* single_def) {
+    Map* values = map_new();
+    Map* loads = map_new();
+
+    size_t i = 0;
+    while (i < block->insts->size) {
+        IrInst* inst = (IrInst*)vector_at(block->insts, i);
+        replace_srcs(inst, replacements);
+        if (ir_writes_memory(inst->opcode) || inst->opcode == IR_CALL) {
+            map_delete(loads);
+            loads = map_new();
+        }
+        if (!is_numbered_inst(inst, single_def)) {
+            i++;
+            continue;
+        }
+
+        char* key = create_value_key(inst);
+        Map* table = inst->opcode == IR_LOAD ? loads : values;
+        int* value = (int*)map_find(table, key);
+        if (value != NULL) {
+            replacements[inst->dst] = *value;
+            ir_block_erase_inst(block, i);
+            free(key);
+            continue;
+        }
+        value = (int*)safe_malloc(sizeof(int));
+        *value = inst->dst;
+        map_insert(table, key, value);
+        free(key);
+        i++;
+    }
+
+    map_delete(loads);
+    map_delete(values);
+}
+
+int is_numbered_inst(IrInst* inst, char* single_def) {
+    IrOpcode opcode = inst->opcode;
+    if (inst->dst < 0 || !single_def[inst->dst]) return 0;
+    if (
+        !ir_is_unary_op(opcode) && !ir_is_binary_op(opcode) && !ir_is_comparison(opcode) &&
+        opcode != IR_LOCAL_ADDR && opcode != IR_GLOBAL_ADDR && opcode != IR_LOAD
+    )
+        return 0;
+
+    size_t i = 0, size = inst->srcs->size;
+    for (i = 0; i < size; i++) {
+        IrOperand* src = ir_inst_nth_src(inst, i);
+        if (src->type == IR_OPERAND_VREG && !single_def[src->value]) return 0;
+    }
+    return 1;
+}
+
+char* create_value_key(IrInst* inst) {
+    char* key = NULL;
+    if (inst->opcode == IR_GLOBAL_ADDR) {
+        key = (char*)safe_malloc((MAX_VALUE_KEY_LENGTH + strlen(inst->symbol)) * sizeof(char));
+        sprintf(key, "%d.%d %s", inst->opcode, inst->width, inst->symbol);
+        return key;
+    }
+    key = (char*)safe_malloc(MAX_VALUE_KEY_LENGTH * sizeof(char));
+    int length = sprintf(key, "%d.%d @%d", inst->opcode, inst->width, inst->stack_index);
+
+    IrOperand* srcs[2] = { NULL, NULL };
+    size_t i = 0, size = inst->srcs->size;
+    for (i = 0; i < size && i < 2; i++) {
+        srcs[i] = ir_inst_nth_src(inst, i);
+    }
+    if (
+        size == 2 && is_commutative(inst->opcode) &&
+        (srcs[0]->type > srcs[1]->type || (srcs[0]->type == srcs[1]->type && srcs[0]->value > srcs[1]->value))
+    ) {
+        srcs[0] = ir_inst_nth_src(inst, 1);
+        srcs[1] = ir_inst_nth_src(inst, 0);
+    }
+    for (i = 0; i < size && i < 2; i++) {
+        char prefix = srcs[i]->type == IR_OPERAND_VREG ? 'v' : '#';
+        length += sprintf(key + length, " %c%d", prefix, srcs[i]->value);
+    }
+    return key;
+}
+
+int is_commutative(IrOpcode opcode) {
+    switch (opcode) {
+        case IR_ADD:
+        case IR_MUL:
+        case IR_AND:
+        case IR_XOR:
+        case IR_OR:
+        case IR_EQ:
+        case IR_NE:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// utils
+char* count_single_defs(IrFunction* func) {
+    int num_vregs = func->num_vregs;
+    int* num_defs = (int*)safe_malloc((num_vregs + 1) * sizeof(int));
+    memset(num_defs, 0, (num_vregs + 1) * sizeof(int));
+
+    size_t i = 0, j = 0;
+    for (i = 0; i < func->blocks->size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            if (inst->dst >= 0) num_defs[inst->dst]++;
+        }
+    }
+
+    char* single_def = (char*)safe_malloc((num_vregs + 1) * sizeof(char));
+    int k = 0;
+    for (k = 0; k <= num_vregs; k++) {
+        single_def[k] = num_defs[k] == 1;
+    }
+    free(num_defs);
+    return single_def;
+}
+
+void replace_srcs(IrInst* inst, int* replacements) {
+    size_t i = 0, size = inst->srcs->size;
+    for (i = 0; i < size; i++) {
+        IrOperand* src = ir_inst_nth_src(inst, i);
+        if (src->type != IR_OPERAND_VREG || replacements[src->value] < 0) continue;
+        ir_inst_replace_nth_src(inst, i, ir_operand_new_vreg(replacements[src->value]));
+    }
+}
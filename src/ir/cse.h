@@ -0,0 +1,11 @@
+#ifndef _CSE_H_
+#define _CSE_H_
+
+
+#include "ir.h"
+
+
+void eliminate_common_subexprs(IrFunction* func);
+
+
+#endif  // _CSE_H_
@@ -0,0 +1,161 @@
+#include "dominance.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "../common/memory.h"
+
+
+// dominance
+void compute_reverse_postorder(Dominance* dominance, IrFunction* func);
+void visit_postorder(IrBlock* block, char* visited, Vector* postorder);
+void compute_idoms(Dominance* dominance);
+IrBlock* intersect_dominators(Dominance* dominance, IrBlock* x, IrBlock* y);
+void compute_frontiers(Dominance* dominance);
+
+// utils
+void push_back_unique(Vector* vector, IrBlock* block);
+
+
+// dominance
+Dominance* dominance_new(IrFunction* func) {
+    Dominance* dominance = (Dominance*)safe_malloc(sizeof(Dominance));
+    int i = 0, num_blocks = func->num_blocks;
+    dominance->num_blocks = num_blocks;
+    dominance->rpo = vector_new();
+    dominance->rpo_index = (int*)safe_malloc(num_blocks * sizeof(int));
+    dominance->idom = (IrBlock**)safe_malloc(num_blocks * sizeof(IrBlock*));
+    dominance->children = (Vector**)safe_malloc(num_blocks * sizeof(Vector*));
+    dominance->frontier = (Vector**)safe_malloc(num_blocks * sizeof(Vector*));
+    for (i = 0; i < num_blocks; i++) {
+        dominance->rpo_index[i] = -1;
+        dominance->idom[i] = NULL;
+        dominance->children[i] = vector_new();
+        dominance->frontier[i] = vector_new();
+    }
+
+    compute_reverse_postorder(dominance, func);
+    compute_idoms(dominance);
+    compute_frontiers(dominance);
+    return dominance;
+}
+
+int dominance_dominates(Dominance* dominance, IrBlock* x, IrBlock* y) {
+    if (dominance->rpo_index[y->id] < 0) return 0;
+    while (1) {
+        if (x == y) return 1;
+        IrBlock* idom = dominance->idom[y->id];
+        if (idom == y) return 0;
+        y = idom;
+    }
+}
+
+void dominance_delete(Dominance* dominance) {
+    if (dominance == NULL) return;
+
+    int i = 0;
+    for (i = 0; i < dominance->num_blocks; i++) {
+        free(dominance->children[i]->data);
+        free(dominance->children[i]);
+        free(dominance->frontier[i]->data);
+        free(dominance->frontier[i]);
+    }
+    free(dominance->rpo->data);
+    free(dominance->rpo);
+    free(dominance->rpo_index);
+    free(dominance->idom);
+    free(dominance->children);
+    free(dominance->frontier);
+    free(dominance);
+}
+
+void compute_reverse_postorder(Dominance* dominance, IrFunction* func) {
+    char* visited = (char*)safe_malloc(dominance->num_blocks * sizeof(char));
+    memset(visited, 0, dominance->num_blocks);
+    Vector* postorder = vector_new();
+    visit_postorder((IrBlock*)vector_at(func->blocks, 0), visited, postorder);
+
+    int i = 0, size = postorder->size;
+    for (i = size - 1; i >= 0; i--) {
+        IrBlock* block = (IrBlock*)vector_at(postorder, i);
+        dominance->rpo_index[block->id] = dominance->rpo->size;
+        vector_push_back(dominance->rpo, block);
+    }
+    free(postorder->data);
+    free(postorder);
+    free(visited);
+}
+
+void visit_postorder(IrBlock* block, char* visited, Vector* postorder) {
+    visited[block->id] = 1;
+    size_t i = 0, size = block->succs->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* succ = (IrBlock*)vector_at(block->succs, i);
+        if (!visited[succ->id]) visit_postorder(succ, visited, postorder);
+    }
+    vector_push_back(postorder, block);
+}
+
+void compute_idoms(Dominance* dominance) {
+    IrBlock* entry = (IrBlock*)vector_at(dominance->rpo, 0);
+    dominance->idom[entry->id] = entry;
+
+    size_t i = 0, j = 0, size = dominance->rpo->size;
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (i = 1; i < size; i++) {
+            IrBlock* block = (IrBlock*)vector_at(dominance->rpo, i);
+            IrBlock* new_idom = NULL;
+            size_t num_preds = block->preds->size;
+            for (j = 0; j < num_preds; j++) {
+                IrBlock* pred = (IrBlock*)vector_at(block->preds, j);
+                if (dominance->idom[pred->id] == NULL) continue;
+                if (new_idom == NULL) new_idom = pred;
+                else                  new_idom = intersect_dominators(dominance, pred, new_idom);
+            }
+            if (dominance->idom[block->id] != new_idom) {
+                dominance->idom[block->id] = new_idom;
+                changed = 1;
+            }
+        }
+    }
+
+    for (i = 1; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(dominance->rpo, i);
+        vector_push_back(dominance->children[dominance->idom[block->id]->id], block);
+    }
+}
+
+IrBlock* intersect_dominators(Dominance* dominance, IrBlock* x, IrBlock* y) {
+    while (x != y) {
+        while (dominance->rpo_index[x->id] > dominance->rpo_index[y->id]) x = dominance->idom[x->id];
+        while (dominance->rpo_index[y->id] > dominance->rpo_index[x->id]) y = dominance->idom[y->id];
+    }
+    return x;
+}
+
+void compute_frontiers(Dominance* dominance) {
+    size_t i = 0, j = 0, size = dominance->rpo->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(dominance->rpo, i);
+        size_t num_preds = block->preds->size;
+        if (num_preds < 2) continue;
+        for (j = 0; j < num_preds; j++) {
+            IrBlock* runner = (IrBlock*)vector_at(block->preds, j);
+            if (dominance->rpo_index[runner->id] < 0) continue;
+            while (runner != dominance->idom[block->id]) {
+                push_back_unique(dominance->frontier[runner->id], block);
+                runner = dominance->idom[runner->id];
+            }
+        }
+    }
+}
+
+// utils
+void push_back_unique(Vector* vector, IrBlock* block) {
+    size_t i = 0, size = vector->size;
+    for (i = 0; i < size; i++) {
+        if (vector_at(vector, i) == block) return;
+    }
+    vector_push_back(vector, block);
+}
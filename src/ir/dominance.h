@@ -0,0 +1,24 @@
+#ifndef _DOMINANCE_H_
+#define _DOMINANCE_H_
+
+
+#include "ir.h"
+
+
+typedef struct {
+    int num_blocks;
+    Vector* rpo;
+    int* rpo_index;
+    IrBlock** idom;
+    Vector** children;
+    Vector** frontier;
+} Dominance;
+
+
+// dominance
+Dominance* dominance_new(IrFunction* func);
+int dominance_dominates(Dominance* dominance, IrBlock* x, IrBlock* y);
+void dominance_delete(Dominance* dominance);
+
+
+#endif  // _DOMINANCE_H_
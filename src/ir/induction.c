@@ -0,0 +1,323 @@
+#include "induction.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "loop.h"
+#include "../common/memory.h"
+
+
+typedef struct {
+    IrInst* phi;
+    IrOperand* init;
+    int next;
+    int step;
+} InductionVariable;
+
+typedef struct {
+    IrFunction* func;
+    Loop* loop;
+    IrBlock* latch;
+    int num_vregs;
+    IrInst** def_insts;
+    IrBlock** def_blocks;
+} InductionEnv;
+
+
+// induction-variable
+void reduce_loop_induction_variables(IrFunction* func, Loop* loop);
+IrBlock* find_latch(Loop* loop);
+int find_induction_variable(InductionEnv* env, IrInst* phi, InductionVariable* iv);
+int compute_affine_scale(InductionEnv* env, InductionVariable* iv, IrOperand* operand, int* scale);
+
+// rewriter
+int reduce_address(InductionEnv* env, InductionVariable* iv, IrInst* address, char* used_as_address);
+void replace_exit_test(InductionEnv* env, InductionVariable* iv, IrInst* address, int pointer, int next_pointer);
+int has_wide_affine_chain(InductionEnv* env, InductionVariable* iv, IrOperand* operand);
+int is_counter_copy(InductionEnv* env, InductionVariable* iv, IrOperand* operand);
+IrOperand* clone_affine_chain(InductionEnv* env, InductionVariable* iv, IrOperand* operand, IrOperand* substitute);
+void replace_uses_in_loop(InductionEnv* env, int vreg, int new_vreg);
+int is_defined_in_loop(InductionEnv* env, IrOperand* operand);
+size_t first_non_phi_index(IrBlock* block);
+
+
+void reduce_induction_variables(IrFunction* func) {
+    ir_function_compute_cfg(func);
+    Dominance* dominance = dominance_new(func);
+    Vector* loops = find_loops(func, dominance);
+    size_t i = 0, size = loops->size;
+    for (i = 0; i < size; i++) {
+        Loop* loop = (Loop*)vector_at(loops, i);
+        if (loop->preheader != NULL) reduce_loop_induction_variables(func, loop);
+        loop_delete(loop);
+        loops->data[i] = NULL;
+    }
+    vector_delete(loops);
+    dominance_delete(dominance);
+}
+
+// induction-variable
+void reduce_loop_induction_variables(IrFunction* func, Loop* loop) {
+    IrBlock* latch = find_latch(loop);
+    if (latch == NULL) return;
+
+    InductionEnv env;
+    int num_vregs = func->num_vregs;
+    env.func = func;
+    env.loop = loop;
+    env.latch = latch;
+    env.num_vregs = num_vregs;
+    env.def_insts = (IrInst**)safe_malloc((num_vregs + 1) * sizeof(IrInst*));
+    env.def_blocks = (IrBlock**)safe_malloc((num_vregs + 1) * sizeof(IrBlock*));
+    memset(env.def_insts, 0, (num_vregs + 1) * sizeof(IrInst*));
+    memset(env.def_blocks, 0, (num_vregs + 1) * sizeof(IrBlock*));
+    char* used_as_address = (char*)safe_malloc((num_vregs + 1) * sizeof(char));
+    memset(used_as_address, 0, num_vregs + 1);
+
+    Vector* candidates = vector_new();
+    size_t i = 0, j = 0;
+    for (i = 0; i < func->blocks->size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            if (inst->dst >= 0) {
+                env.def_insts[inst->dst] = inst;
+                env.def_blocks[inst->dst] = block;
+            }
+            if (!loop->body[block->id]) continue;
+            if (inst->opcode == IR_ADD && inst->width == 8) vector_push_back(candidates, inst);
+            if (inst->opcode == IR_LOAD || inst->opcode == IR_STORE) {
+                IrOperand* address = ir_inst_nth_src(inst, 0);
+                if (address->type == IR_OPERAND_VREG) used_as_address[address->value] = 1;
+            }
+        }
+    }
+
+    Vector* phis = vector_new();
+    size_t num_phis = first_non_phi_index(loop->header);
+    for (i = 0; i < num_phis; i++) {
+        vector_push_back(phis, vector_at(loop->header->insts, i));
+    }
+    for (i = 0; i < num_phis; i++) {
+        InductionVariable iv;
+        if (!find_induction_variable(&env, (IrInst*)vector_at(phis, i), &iv)) continue;
+        for (j = 0; j < candidates->size; j++) {
+            IrInst* address = (IrInst*)vector_at(candidates, j);
+            if (address == NULL) continue;
+            if (reduce_address(&env, &iv, address, used_as_address)) candidates->data[j] = NULL;
+        }
+    }
+
+    free(phis->data);
+    free(phis);
+    free(candidates->data);
+    free(candidates);
+    free(used_as_address);
+    free(env.def_blocks);
+    free(env.def_insts);
+}
+
+IrBlock* find_latch(Loop* loop) {
+    IrBlock* header = loop->header;
+    if (header->preds->size != 2) return NULL;
+    size_t i = 0;
+    for (i = 0; i < 2; i++) {
+        IrBlock* pred = (IrBlock*)vector_at(header->preds, i);
+        if (pred != loop->preheader) return pred;
+    }
+    return NULL;
+}
+
+int find_induction_variable(InductionEnv* env, IrInst* phi, InductionVariable* iv) {
+    if (phi->srcs->size != 2) return 0;
+
+    IrOperand* next = NULL;
+    size_t i = 0;
+    iv->phi = phi;
+    iv->init = NULL;
+    for (i = 0; i < 2; i++) {
+        IrBlock* pred = (IrBlock*)vector_at(phi->phi_blocks, i);
+        if (pred == env->loop->preheader) iv->init = ir_inst_nth_src(phi, i);
+        if (pred == env->latch)           next = ir_inst_nth_src(phi, i);
+    }
+    if (iv->init == NULL || next == NULL || !is_defined_in_loop(env, next)) return 0;
+
+    IrInst* step_inst = env->def_insts[next->value];
+    IrOperand* lhs = ir_inst_nth_src(step_inst, 0);
+    IrOperand* rhs = step_inst->srcs->size > 1 ? ir_inst_nth_src(step_inst, 1) : NULL;
+    if (rhs == NULL || lhs->type != IR_OPERAND_VREG || lhs->value != phi->dst || rhs->type != IR_OPERAND_IMM) {
+        return 0;
+    }
+    switch (step_inst->opcode) {
+        case IR_ADD:
+            iv->step = rhs->value;
+            break;
+        case IR_SUB:
+            iv->step = -rhs->value;
+            break;
+        default:
+            return 0;
+    }
+    iv->next = next->value;
+    return 1;
+}
+
+int compute_affine_scale(InductionEnv* env, InductionVariable* iv, IrOperand* operand, int* scale) {
+    if (!is_defined_in_loop(env, operand)) {
+        *scale = 0;
+        return 1;
+    }
+    if (operand->value == iv->phi->dst) {
+        *scale = 1;
+        return 1;
+    }
+
+    if (operand->value >= env->num_vregs) return 0;
+    IrInst* inst = env->def_insts[operand->value];
+    int lhs_scale = 0, rhs_scale = 0;
+    switch (inst->opcode) {
+        case IR_MOV:
+        case IR_SEXT32:
+            return compute_affine_scale(env, iv, ir_inst_nth_src(inst, 0), scale);
+        case IR_ADD:
+        case IR_SUB:
+            if (!compute_affine_scale(env, iv, ir_inst_nth_src(inst, 0), &lhs_scale)) return 0;
+            if (!compute_affine_scale(env, iv, ir_inst_nth_src(inst, 1), &rhs_scale)) return 0;
+            *scale = inst->opcode == IR_ADD ? lhs_scale + rhs_scale : lhs_scale - rhs_scale;
+            return 1;
+        case IR_SHL:
+        case IR_MUL: {
+            IrOperand* factor = ir_inst_nth_src(inst, 1);
+            if (factor->type != IR_OPERAND_IMM) return 0;
+            if (!compute_affine_scale(env, iv, ir_inst_nth_src(inst, 0), &lhs_scale)) return 0;
+            *scale = inst->opcode == IR_SHL ? lhs_scale << factor->value : lhs_scale * factor->value;
+            return 1;
+        }
+        default:
+            return 0;
+    }
+}
+
+// rewriter
+int reduce_address(InductionEnv* env, InductionVariable* iv, IrInst* address, char* used_as_address) {
+    if (!used_as_address[address->dst]) return 0;
+    int scale = 0;
+    IrOperand address_operand = { IR_OPERAND_VREG, address->dst };
+    if (!compute_affine_scale(env, iv, &address_operand, &scale) || scale == 0) return 0;
+
+    IrFunction* func = env->func;
+    IrOperand* init = clone_affine_chain(env, iv, &address_operand, iv->init);
+    int pointer = ir_function_create_vreg(func);
+    int next_pointer = ir_function_create_vreg(func);
+
+    IrInst* phi = ir_inst_new(IR_PHI, 8, pointer, 0);
+    ir_inst_append_phi_src(phi, init, env->loop->preheader);
+    ir_inst_append_phi_src(phi, ir_operand_new_vreg(next_pointer), env->latch);
+    ir_block_insert_inst(env->loop->header, 0, phi);
+    ir_block_insert_inst(env->latch, first_non_phi_index(env->latch), ir_inst_new(
+        IR_ADD, 8, next_pointer, 2, ir_operand_new_vreg(pointer), ir_operand_new_imm(iv->step * scale)
+    ));
+
+    replace_uses_in_loop(env, address->dst, pointer);
+    if (scale > 0 && has_wide_affine_chain(env, iv, &address_operand)) {
+        replace_exit_test(env, iv, address, pointer, next_pointer);
+    }
+    return 1;
+}
+
+void replace_exit_test(InductionEnv* env, InductionVariable* iv, IrInst* address, int pointer, int next_pointer) {
+    IrInst* branch = ir_block_terminator(env->latch);
+    if (branch == NULL || branch->opcode != IR_BR) return;
+    IrOperand* cond = ir_inst_nth_src(branch, 0);
+    if (cond->type != IR_OPERAND_VREG || cond->value >= env->num_vregs) return;
+    if (env->def_blocks[cond->value] != env->latch) return;
+    IrInst* compare = env->def_insts[cond->value];
+    if (!ir_is_comparison(compare->opcode)) return;
+
+    int counter_index = -1;
+    size_t i = 0;
+    for (i = 0; i < 2; i++) {
+        IrOperand* src = ir_inst_nth_src(compare, i);
+        if (src->type != IR_OPERAND_VREG) continue;
+        if (src->value == iv->next || src->value == iv->phi->dst) counter_index = i;
+    }
+    if (counter_index < 0 || is_defined_in_loop(env, ir_inst_nth_src(compare, 1 - counter_index))) return;
+
+    IrOperand* counter = ir_inst_nth_src(compare, counter_index);
+    int new_counter = counter->value == iv->next ? next_pointer : pointer;
+    IrOperand address_operand = { IR_OPERAND_VREG, address->dst };
+    IrOperand* limit = clone_affine_chain(env, iv, &address_operand, ir_inst_nth_src(compare, 1 - counter_index));
+    ir_inst_replace_nth_src(compare, counter_index, ir_operand_new_vreg(new_counter));
+    ir_inst_replace_nth_src(compare, 1 - counter_index, limit);
+    compare->width = 8;
+}
+
+int has_wide_affine_chain(InductionEnv* env, InductionVariable* iv, IrOperand* operand) {
+    if (!is_defined_in_loop(env, operand) || operand->value == iv->phi->dst) return 1;
+    if (operand->value >= env->num_vregs) return 0;
+
+    IrInst* inst = env->def_insts[operand->value];
+    if (inst->opcode == IR_SEXT32) return is_counter_copy(env, iv, ir_inst_nth_src(inst, 0));
+    if (inst->width != 8) return 0;
+
+    size_t i = 0, size = inst->srcs->size;
+    for (i = 0; i < size; i++) {
+        if (!has_wide_affine_chain(env, iv, ir_inst_nth_src(inst, i))) return 0;
+    }
+    return 1;
+}
+
+int is_counter_copy(InductionEnv* env, InductionVariable* iv, IrOperand* operand) {
+    if (operand->type != IR_OPERAND_VREG) return 0;
+    if (operand->value == iv->phi->dst) return 1;
+    if (!is_defined_in_loop(env, operand) || operand->value >= env->num_vregs) return 0;
+
+    IrInst* inst = env->def_insts[operand->value];
+    return inst->opcode == IR_MOV && is_counter_copy(env, iv, ir_inst_nth_src(inst, 0));
+}
+
+IrOperand* clone_affine_chain(InductionEnv* env, InductionVariable* iv, IrOperand* operand, IrOperand* substitute) {
+    if (!is_defined_in_loop(env, operand)) return ir_operand_copy(operand);
+    if (operand->value == iv->phi->dst) return ir_operand_copy(substitute);
+
+    IrInst* inst = env->def_insts[operand->value];
+    IrOperand* lhs = clone_affine_chain(env, iv, ir_inst_nth_src(inst, 0), substitute);
+    IrOperand* rhs = NULL;
+    if (inst->srcs->size > 1) rhs = clone_affine_chain(env, iv, ir_inst_nth_src(inst, 1), substitute);
+
+    IrBlock* preheader = env->loop->preheader;
+    int dst = ir_function_create_vreg(env->func);
+    IrInst* clone = ir_inst_new(inst->opcode, inst->width, dst, inst->srcs->size, lhs, rhs);
+    ir_block_insert_inst(preheader, preheader->insts->size - 1, clone);
+    return ir_operand_new_vreg(dst);
+}
+
+void replace_uses_in_loop(InductionEnv* env, int vreg, int new_vreg) {
+    size_t i = 0, j = 0, k = 0;
+    for (i = 0; i < env->func->blocks->size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(env->func->blocks, i);
+        if (!env->loop->body[block->id]) continue;
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            for (k = 0; k < inst->srcs->size; k++) {
+                IrOperand* src = ir_inst_nth_src(inst, k);
+                if (src->type != IR_OPERAND_VREG || src->value != vreg) continue;
+                ir_inst_replace_nth_src(inst, k, ir_operand_new_vreg(new_vreg));
+            }
+        }
+    }
+}
+
+int is_defined_in_loop(InductionEnv* env, IrOperand* operand) {
+    if (operand->type != IR_OPERAND_VREG) return 0;
+    if (operand->value >= env->num_vregs) return 1;
+    IrBlock* def_block = env->def_blocks[operand->value];
+    return def_block != NULL && env->loop->body[def_block->id];
+}
+
+size_t first_non_phi_index(IrBlock* block) {
+    size_t i = 0, size = block->insts->size;
+    for (i = 0; i < size; i++) {
+        if (((IrInst*)vector_at(block->insts, i))->opcode != IR_PHI) break;
+    }
+    return i;
+}
@@ -0,0 +1,11 @@
+#ifndef _INDUCTION_H_
+#define _INDUCTION_H_
+
+
+#include "ir.h"
+
+
+void reduce_induction_variables(IrFunction* func);
+
+
+#endif  // _INDUCTION_H_
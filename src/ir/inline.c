@@ -0,0 +1,257 @@
+#include "inline.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "../common/memory.h"
+
+
+#define INLINE_CALLER_LIMIT 2000
+
+
+typedef struct {
+    IrModule* module;
+    int threshold;
+    int* num_call_sites;
+    char* recursive;
+} InlineEnv;
+
+
+// call-graph
+int function_index_of(IrModule* module, char* funcname);
+void count_call_sites(InlineEnv* env);
+void find_recursive_functions(InlineEnv* env);
+void mark_callees(char* calls, int num_functions, int index, char* reached);
+
+// inliner
+void inline_calls(InlineEnv* env, IrFunction* func, FILE* report_file);
+int should_inline(InlineEnv* env, IrFunction* caller, int callee_index);
+void inline_call(IrFunction* caller, IrBlock* block, size_t index, IrFunction* callee);
+IrInst* clone_inst(IrInst* inst, int vreg_base, int stack_base, IrBlock** block_map);
+IrOperand* clone_operand(IrOperand* operand, int vreg_base);
+IrInst* new_jump_inst(IrBlock* target);
+int count_insts(IrFunction* func);
+
+
+void inline_functions(IrModule* module, int threshold, FILE* report_file) {
+    int num_functions = module->functions->size;
+    InlineEnv env;
+    env.module = module;
+    env.threshold = threshold;
+    env.num_call_sites = (int*)safe_malloc((num_functions + 1) * sizeof(int));
+    env.recursive = (char*)safe_malloc((num_functions + 1) * sizeof(char));
+    count_call_sites(&env);
+    find_recursive_functions(&env);
+
+    int i = 0;
+    for (i = 0; i < num_functions; i++) {
+        inline_calls(&env, (IrFunction*)vector_at(module->functions, i), report_file);
+    }
+
+    free(env.num_call_sites);
+    free(env.recursive);
+}
+
+// call-graph
+int function_index_of(IrModule* module, char* funcname) {
+    size_t i = 0, size = module->functions->size;
+    for (i = 0; i < size; i++) {
+        IrFunction* func = (IrFunction*)vector_at(module->functions, i);
+        if (strcmp(func->funcname, funcname) == 0) return i;
+    }
+    return -1;
+}
+
+void count_call_sites(InlineEnv* env) {
+    Vector* functions = env->module->functions;
+    memset(env->num_call_sites, 0, (functions->size + 1) * sizeof(int));
+
+    size_t i = 0, j = 0, k = 0;
+    for (i = 0; i < functions->size; i++) {
+        IrFunction* func = (IrFunction*)vector_at(functions, i);
+        for (j = 0; j < func->blocks->size; j++) {
+            IrBlock* block = (IrBlock*)vector_at(func->blocks, j);
+            for (k = 0; k < block->insts->size; k++) {
+                IrInst* inst = (IrInst*)vector_at(block->insts, k);
+                if (inst->opcode != IR_CALL) continue;
+                int callee_index = function_index_of(env->module, inst->symbol);
+                if (callee_index >= 0) env->num_call_sites[callee_index]++;
+            }
+        }
+    }
+}
+
+void find_recursive_functions(InlineEnv* env) {
+    Vector* functions = env->module->functions;
+    int num_functions = functions->size;
+    char* calls = (char*)safe_malloc((num_functions * num_functions + 1) * sizeof(char));
+    char* reached = (char*)safe_malloc((num_functions + 1) * sizeof(char));
+    memset(calls, 0, num_functions * num_functions + 1);
+
+    int i = 0;
+    size_t j = 0, k = 0;
+    for (i = 0; i < num_functions; i++) {
+        IrFunction* func = (IrFunction*)vector_at(functions, i);
+        for (j = 0; j < func->blocks->size; j++) {
+            IrBlock* block = (IrBlock*)vector_at(func->blocks, j);
+            for (k = 0; k < block->insts->size; k++) {
+                IrInst* inst = (IrInst*)vector_at(block->insts, k);
+                if (inst->opcode != IR_CALL) continue;
+                int callee_index = function_index_of(env->module, inst->symbol);
+                if (callee_index >= 0) calls[i * num_functions + callee_index] = 1;
+            }
+        }
+    }
+
+    for (i = 0; i < num_functions; i++) {
+        memset(reached, 0, num_functions + 1);
+        mark_callees(calls, num_functions, i, reached);
+        env->recursive[i] = reached[i];
+    }
+    free(calls);
+    free(reached);
+}
+
+void mark_callees(char* calls, int num_functions, int index, char* reached) {
+    int i = 0;
+    for (i = 0; i < num_functions; i++) {
+        if (!calls[index * num_functions + i] || reached[i]) continue;
+        reached[i] = 1;
+        mark_callees(calls, num_functions, i, reached);
+    }
+}
+
+// inliner
+void inline_calls(InlineEnv* env, IrFunction* func, FILE* report_file) {
+    int inlined = 0;
+    size_t i = 0, j = 0;
+    for (i = 0; i < func->blocks->size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            if (inst->opcode != IR_CALL) continue;
+            int callee_index = function_index_of(env->module, inst->symbol);
+            if (!should_inline(env, func, callee_index)) continue;
+
+            IrFunction* callee = (IrFunction*)vector_at(env->module->functions, callee_index);
+            if (report_file != NULL) {
+                fprintf(
+                    report_file, "inline: %s B%d %s (%d insts)\n",
+                    func->funcname, block->id, callee->funcname, count_insts(callee)
+                );
+            }
+            inline_call(func, block, j, callee);
+            inlined = 1;
+            break;
+        }
+    }
+    if (inlined) ir_function_compute_cfg(func);
+}
+
+int should_inline(InlineEnv* env, IrFunction* caller, int callee_index) {
+    if (callee_index < 0 || env->recursive[callee_index]) return 0;
+
+    IrFunction* callee = (IrFunction*)vector_at(env->module->functions, callee_index);
+    int callee_size = count_insts(callee);
+    int limit = env->num_call_sites[callee_index] == 1 ? 4 * env->threshold : env->threshold;
+    return callee_size <= limit && count_insts(caller) + callee_size <= INLINE_CALLER_LIMIT;
+}
+
+void inline_call(IrFunction* caller, IrBlock* block, size_t index, IrFunction* callee) {
+    IrInst* call = (IrInst*)vector_at(block->insts, index);
+    int vreg_base = caller->num_vregs;
+    int stack_base = (caller->stack_offset + 7) / 8 * 8;
+    caller->num_vregs += callee->num_vregs;
+    caller->stack_offset = stack_base + callee->stack_offset;
+
+    IrBlock* exit_block = ir_function_create_block_after(caller, block);
+    size_t i = 0, j = 0;
+    for (i = index + 1; i < block->insts->size; i++) {
+        ir_block_append_inst(exit_block, (IrInst*)vector_at(block->insts, i));
+    }
+    block->insts->size = index;
+
+    size_t num_blocks = callee->blocks->size;
+    IrBlock** block_map = (IrBlock**)safe_malloc(callee->num_blocks * sizeof(IrBlock*));
+    IrBlock* last_block = block;
+    for (i = 0; i < num_blocks; i++) {
+        IrBlock* callee_block = (IrBlock*)vector_at(callee->blocks, i);
+        last_block = ir_function_create_block_after(caller, last_block);
+        block_map[callee_block->id] = last_block;
+    }
+
+    for (i = 0; i < num_blocks; i++) {
+        IrBlock* callee_block = (IrBlock*)vector_at(callee->blocks, i);
+        IrBlock* inlined_block = block_map[callee_block->id];
+        for (j = 0; j < callee_block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(callee_block->insts, j);
+            switch (inst->opcode) {
+                case IR_ARG: {
+                    IrOperand* arg = ir_inst_nth_src(call, ir_inst_nth_src(inst, 0)->value);
+                    ir_block_append_inst(
+                        inlined_block,
+                        ir_inst_new(IR_MOV, inst->width, inst->dst + vreg_base, 1, ir_operand_copy(arg))
+                    );
+                    break;
+                }
+                case IR_RET:
+                    if (inst->srcs->size > 0 && call->dst >= 0) {
+                        IrOperand* value = clone_operand(ir_inst_nth_src(inst, 0), vreg_base);
+                        ir_block_append_inst(inlined_block, ir_inst_new(IR_MOV, call->width, call->dst, 1, value));
+                    }
+                    ir_block_append_inst(inlined_block, new_jump_inst(exit_block));
+                    break;
+                default:
+                    ir_block_append_inst(inlined_block, clone_inst(inst, vreg_base, stack_base, block_map));
+                    break;
+            }
+        }
+        if (!ir_block_is_terminated(inlined_block)) {
+            IrBlock* next_block = i + 1 < num_blocks ? (IrBlock*)vector_at(callee->blocks, i + 1) : NULL;
+            ir_block_append_inst(
+                inlined_block, new_jump_inst(next_block != NULL ? block_map[next_block->id] : exit_block)
+            );
+        }
+    }
+
+    IrBlock* entry_block = (IrBlock*)vector_at(callee->blocks, 0);
+    ir_block_append_inst(block, new_jump_inst(block_map[entry_block->id]));
+    ir_inst_delete(call);
+    free(block_map);
+}
+
+IrInst* clone_inst(IrInst* inst, int vreg_base, int stack_base, IrBlock** block_map) {
+    int dst = inst->dst >= 0 ? inst->dst + vreg_base : -1;
+    IrInst* cloned_inst = ir_inst_new(inst->opcode, inst->width, dst, 0);
+    size_t i = 0, size = inst->srcs->size;
+    for (i = 0; i < size; i++) {
+        vector_push_back(cloned_inst->srcs, clone_operand(ir_inst_nth_src(inst, i), vreg_base));
+    }
+    if (inst->symbol != NULL) cloned_inst->symbol = str_new(inst->symbol);
+    if (inst->opcode == IR_LOCAL_ADDR) cloned_inst->stack_index = inst->stack_index + stack_base;
+    for (i = 0; i < 2; i++) {
+        if (inst->targets[i] != NULL) cloned_inst->targets[i] = block_map[inst->targets[i]->id];
+    }
+    return cloned_inst;
+}
+
+IrOperand* clone_operand(IrOperand* operand, int vreg_base) {
+    IrOperand* cloned_operand = ir_operand_copy(operand);
+    if (cloned_operand->type == IR_OPERAND_VREG) cloned_operand->value += vreg_base;
+    return cloned_operand;
+}
+
+IrInst* new_jump_inst(IrBlock* target) {
+    IrInst* inst = ir_inst_new(IR_JMP, 0, -1, 0);
+    inst->targets[0] = target;
+    return inst;
+}
+
+int count_insts(IrFunction* func) {
+    int num_insts = 0;
+    size_t i = 0, size = func->blocks->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        num_insts += block->insts->size;
+    }
+    return num_insts;
+}
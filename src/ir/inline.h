@@ -0,0 +1,12 @@
+#ifndef _INLINE_H_
+#define _INLINE_H_
+
+
+#include <stdio.h>
+#include "ir.h"
+
+
+void inline_functions(IrModule* module, int threshold, FILE* report_file);
+
+
+#endif  // _INLINE_H_
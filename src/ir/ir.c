@@ -0,0 +1,456 @@
+#include "ir.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "../common/memory.h"
+
+
+char* ir_opcode_name[] = {
+    "mov", "arg", "local_addr", "global_addr", "load", "store", "memzero", "memcopy",
+    "neg", "not", "sext8", "sext32",
+    "add", "sub", "mul", "div", "mod", "shl", "sar", "and", "xor", "or",
+    "eq", "ne", "lt", "gt", "le", "ge",
+    "call",
+    "vload", "vstore", "vsplat", "vzero", "vadd", "vsub", "vand", "vxor", "vor", "vreduce", "vend",
+    "phi",
+    "jmp", "br", "ret"
+};
+
+
+// ir-function
+void mark_reachable_blocks(IrBlock* block, char* reachable);
+void prune_phi_srcs(IrBlock* block);
+
+// ir-block
+IrBlock* ir_block_new(int id);
+void ir_block_delete(IrBlock* block);
+
+// ir-printer
+void ir_block_print(FILE* file_ptr, IrBlock* block);
+void ir_inst_print(FILE* file_ptr, IrInst* inst);
+void ir_operand_print(FILE* file_ptr, IrOperand* operand);
+
+// utils
+void unowned_vector_delete(Vector* vector);
+
+
+// ir-module
+IrModule* ir_module_new(GlobalList* global_list) {
+    IrModule* module = (IrModule*)safe_malloc(sizeof(IrModule));
+    module->functions = vector_new();
+    module->global_list = global_list;
+    return module;
+}
+
+void ir_module_append_function(IrModule* module, IrFunction* func) {
+    vector_push_back(module->functions, func);
+}
+
+void ir_module_print(FILE* file_ptr, IrModule* module) {
+    size_t i = 0, size = module->functions->size;
+    for (i = 0; i < size; i++) {
+        ir_function_print(file_ptr, (IrFunction*)vector_at(module->functions, i));
+    }
+}
+
+void ir_module_delete(IrModule* module) {
+    if (module == NULL) return;
+
+    size_t i = 0, size = module->functions->size;
+    for (i = 0; i < size; i++) {
+        ir_function_delete((IrFunction*)vector_at(module->functions, i));
+    }
+    unowned_vector_delete(module->functions);
+    free(module);
+}
+
+// ir-function
+IrFunction* ir_function_new(char* funcname, int stack_offset) {
+    IrFunction* func = (IrFunction*)safe_malloc(sizeof(IrFunction));
+    func->funcname = funcname;
+    func->blocks = vector_new();
+    func->num_vregs = 0;
+    func->num_blocks = 0;
+    func->stack_offset = stack_offset;
+    return func;
+}
+
+int ir_function_create_vreg(IrFunction* func) {
+    return func->num_vregs++;
+}
+
+IrBlock* ir_function_create_block(IrFunction* func) {
+    IrBlock* block = ir_block_new(func->num_blocks++);
+    vector_push_back(func->blocks, block);
+    return block;
+}
+
+IrBlock* ir_function_create_block_after(IrFunction* func, IrBlock* block) {
+    IrBlock* new_block = ir_block_new(func->num_blocks++);
+    Vector* blocks = func->blocks;
+    vector_push_back(blocks, NULL);
+    size_t i = 0;
+    for (i = blocks->size - 1; i > 0 && blocks->data[i - 1] != block; i--) {
+        blocks->data[i] = blocks->data[i - 1];
+    }
+    blocks->data[i] = new_block;
+    return new_block;
+}
+
+void ir_function_compute_cfg(IrFunction* func) {
+    size_t i = 0, j = 0, num_blocks = func->blocks->size;
+    for (i = 0; i < num_blocks; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        block->preds->size = 0;
+        block->succs->size = 0;
+    }
+    for (i = 0; i < num_blocks; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        IrInst* terminator = ir_block_terminator(block);
+        if (terminator == NULL) continue;
+        for (j = 0; j < 2; j++) {
+            IrBlock* succ = terminator->targets[j];
+            if (succ == NULL || (j == 1 && succ == terminator->targets[0])) continue;
+            vector_push_back(block->succs, succ);
+            vector_push_back(succ->preds, block);
+        }
+    }
+}
+
+void ir_function_remove_unreachable_blocks(IrFunction* func) {
+    ir_function_compute_cfg(func);
+    char* reachable = (char*)safe_malloc(func->num_blocks * sizeof(char));
+    memset(reachable, 0, func->num_blocks);
+    mark_reachable_blocks((IrBlock*)vector_at(func->blocks, 0), reachable);
+
+    size_t i = 0, j = 0, size = func->blocks->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        if (reachable[block->id]) {
+            func->blocks->data[j++] = block;
+        } else {
+            ir_block_delete(block);
+        }
+    }
+    func->blocks->size = j;
+    free(reachable);
+
+    ir_function_compute_cfg(func);
+    for (i = 0; i < func->blocks->size; i++) {
+        prune_phi_srcs((IrBlock*)vector_at(func->blocks, i));
+    }
+}
+
+void mark_reachable_blocks(IrBlock* block, char* reachable) {
+    if (reachable[block->id]) return;
+    reachable[block->id] = 1;
+    size_t i = 0, size = block->succs->size;
+    for (i = 0; i < size; i++) {
+        mark_reachable_blocks((IrBlock*)vector_at(block->succs, i), reachable);
+    }
+}
+
+void prune_phi_srcs(IrBlock* block) {
+    size_t i = 0, j = 0, size = block->insts->size;
+    for (i = 0; i < size; i++) {
+        IrInst* inst = (IrInst*)vector_at(block->insts, i);
+        if (inst->opcode != IR_PHI) continue;
+        j = 0;
+        while (j < inst->phi_blocks->size) {
+            IrBlock* pred = (IrBlock*)vector_at(inst->phi_blocks, j);
+            if (ir_block_pred_index(block, pred) >= 0) {
+                j++;
+                continue;
+            }
+            free(vector_at(inst->srcs, j));
+            vector_erase(inst->srcs, j);
+            vector_erase(inst->phi_blocks, j);
+        }
+    }
+}
+
+int ir_function_has_escaping_locals(IrFunction* func) {
+    char* is_local_addr = (char*)safe_malloc((func->num_vregs + 1) * sizeof(char));
+    memset(is_local_addr, 0, func->num_vregs + 1);
+
+    size_t i = 0, j = 0, k = 0, num_blocks = func->blocks->size;
+    for (i = 0; i < num_blocks; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            if (inst->opcode == IR_LOCAL_ADDR) is_local_addr[inst->dst] = 1;
+        }
+    }
+
+    int escaping = 0;
+    for (i = 0; i < num_blocks && !escaping; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        for (j = 0; j < block->insts->size && !escaping; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            for (k = 0; k < inst->srcs->size; k++) {
+                IrOperand* src = ir_inst_nth_src(inst, k);
+                if (src->type != IR_OPERAND_VREG || !is_local_addr[src->value]) continue;
+                if (k == 0 && (inst->opcode == IR_LOAD || inst->opcode == IR_STORE)) continue;
+                escaping = 1;
+            }
+        }
+    }
+    free(is_local_addr);
+    return escaping;
+}
+
+void ir_function_print(FILE* file_ptr, IrFunction* func) {
+    fprintf(file_ptr, "function %s (frame %d)\n", func->funcname, func->stack_offset);
+    size_t i = 0, size = func->blocks->size;
+    for (i = 0; i < size; i++) {
+        ir_block_print(file_ptr, (IrBlock*)vector_at(func->blocks, i));
+    }
+    fprintf(file_ptr, "\n");
+}
+
+void ir_function_delete(IrFunction* func) {
+    if (func == NULL) return;
+
+    size_t i = 0, size = func->blocks->size;
+    for (i = 0; i < size; i++) {
+        ir_block_delete((IrBlock*)vector_at(func->blocks, i));
+    }
+    unowned_vector_delete(func->blocks);
+    free(func->funcname);
+    free(func);
+}
+
+// ir-block
+IrBlock* ir_block_new(int id) {
+    IrBlock* block = (IrBlock*)safe_malloc(sizeof(IrBlock));
+    block->id = id;
+    block->insts = vector_new();
+    block->preds = vector_new();
+    block->succs = vector_new();
+    return block;
+}
+
+void ir_block_append_inst(IrBlock* block, IrInst* inst) {
+    vector_push_back(block->insts, inst);
+}
+
+void ir_block_insert_inst(IrBlock* block, size_t index, IrInst* inst) {
+    Vector* insts = block->insts;
+    vector_push_back(insts, NULL);
+    size_t i = 0;
+    for (i = insts->size - 1; i > index; i--) {
+        insts->data[i] = insts->data[i - 1];
+    }
+    insts->data[index] = inst;
+}
+
+void ir_block_erase_inst(IrBlock* block, size_t index) {
+    ir_inst_delete((IrInst*)vector_at(block->insts, index));
+    vector_erase(block->insts, index);
+}
+
+IrInst* ir_block_terminator(IrBlock* block) {
+    if (block->insts->size == 0) return NULL;
+    IrInst* inst = (IrInst*)vector_at(block->insts, block->insts->size - 1);
+    if (!ir_is_terminator(inst->opcode)) return NULL;
+    return inst;
+}
+
+int ir_block_is_terminated(IrBlock* block) {
+    return ir_block_terminator(block) != NULL;
+}
+
+int ir_block_pred_index(IrBlock* block, IrBlock* pred) {
+    size_t i = 0, size = block->preds->size;
+    for (i = 0; i < size; i++) {
+        if (vector_at(block->preds, i) == pred) return i;
+    }
+    return -1;
+}
+
+void ir_block_delete(IrBlock* block) {
+    if (block == NULL) return;
+
+    size_t i = 0, size = block->insts->size;
+    for (i = 0; i < size; i++) {
+        ir_inst_delete((IrInst*)vector_at(block->insts, i));
+    }
+    unowned_vector_delete(block->insts);
+    unowned_vector_delete(block->preds);
+    unowned_vector_delete(block->succs);
+    free(block);
+}
+
+// ir-inst
+IrInst* ir_inst_new(IrOpcode opcode, int width, int dst, size_t num_srcs, ...) {
+    IrInst* inst = (IrInst*)safe_malloc(sizeof(IrInst));
+    inst->opcode = opcode;
+    inst->width = width;
+    inst->dst = dst;
+    inst->srcs = vector_new();
+    inst->symbol = NULL;
+    inst->stack_index = 0;
+    inst->targets[0] = NULL;
+    inst->targets[1] = NULL;
+    inst->phi_blocks = NULL;
+
+    va_list list;
+    va_start(list, num_srcs);
+    size_t i = 0;
+    for (i = 0; i < num_srcs; i++) {
+        vector_push_back(inst->srcs, va_arg(list, IrOperand*));
+    }
+    va_end(list);
+    return inst;
+}
+
+IrOperand* ir_inst_nth_src(IrInst* inst, size_t n) {
+    return (IrOperand*)vector_at(inst->srcs, n);
+}
+
+void ir_inst_replace_nth_src(IrInst* inst, size_t n, IrOperand* src) {
+    free(vector_at(inst->srcs, n));
+    vector_assign_at(inst->srcs, n, src);
+}
+
+void ir_inst_append_phi_src(IrInst* inst, IrOperand* src, IrBlock* block) {
+    if (inst->phi_blocks == NULL) inst->phi_blocks = vector_new();
+    vector_push_back(inst->srcs, src);
+    vector_push_back(inst->phi_blocks, block);
+}
+
+void ir_inst_delete(IrInst* inst) {
+    if (inst == NULL) return;
+
+    vector_delete(inst->srcs);
+    unowned_vector_delete(inst->phi_blocks);
+    free(inst->symbol);
+    free(inst);
+}
+
+// ir-operand
+IrOperand* ir_operand_new_vreg(int vreg) {
+    IrOperand* operand = (IrOperand*)safe_malloc(sizeof(IrOperand));
+    operand->type = IR_OPERAND_VREG;
+    operand->value = vreg;
+    return operand;
+}
+
+IrOperand* ir_operand_new_imm(int value) {
+    IrOperand* operand = (IrOperand*)safe_malloc(sizeof(IrOperand));
+    operand->type = IR_OPERAND_IMM;
+    operand->value = value;
+    return operand;
+}
+
+IrOperand* ir_operand_copy(IrOperand* operand) {
+    IrOperand* copied_operand = (IrOperand*)safe_malloc(sizeof(IrOperand));
+    copied_operand->type = operand->type;
+    copied_operand->value = operand->value;
+    return copied_operand;
+}
+
+// ir-opcode-classifier
+int ir_is_unary_op(IrOpcode opcode) {
+    return opcode == IR_NEG || opcode == IR_NOT || opcode == IR_SEXT8 || opcode == IR_SEXT32;
+}
+
+int ir_is_binary_op(IrOpcode opcode) {
+    return IR_ADD <= opcode && opcode <= IR_OR;
+}
+
+int ir_is_comparison(IrOpcode opcode) {
+    return IR_EQ <= opcode && opcode <= IR_GE;
+}
+
+int ir_is_terminator(IrOpcode opcode) {
+    return opcode == IR_JMP || opcode == IR_BR || opcode == IR_RET;
+}
+
+int ir_is_vector_op(IrOpcode opcode) {
+    return IR_VLOAD <= opcode && opcode <= IR_VEND;
+}
+
+int ir_writes_memory(IrOpcode opcode) {
+    return opcode == IR_STORE || opcode == IR_MEMZERO || opcode == IR_MEMCOPY || opcode == IR_VSTORE;
+}
+
+int ir_has_side_effects(IrOpcode opcode) {
+    return ir_writes_memory(opcode) || opcode == IR_CALL || ir_is_terminator(opcode) || ir_is_vector_op(opcode);
+}
+
+// ir-printer
+void ir_block_print(FILE* file_ptr, IrBlock* block) {
+    fprintf(file_ptr, "B%d:", block->id);
+    size_t i = 0, size = block->preds->size;
+    if (size > 0) fprintf(file_ptr, "  ; preds");
+    for (i = 0; i < size; i++) {
+        fprintf(file_ptr, " B%d", ((IrBlock*)vector_at(block->preds, i))->id);
+    }
+    fprintf(file_ptr, "\n");
+
+    size = block->insts->size;
+    for (i = 0; i < size; i++) {
+        ir_inst_print(file_ptr, (IrInst*)vector_at(block->insts, i));
+    }
+}
+
+void ir_inst_print(FILE* file_ptr, IrInst* inst) {
+    fprintf(file_ptr, "    ");
+    if (inst->dst >= 0) fprintf(file_ptr, "v%d = ", inst->dst);
+    fprintf(file_ptr, "%s", ir_opcode_name[inst->opcode]);
+    if (inst->width > 0) fprintf(file_ptr, ".%d", inst->width);
+
+    char* separator = " ";
+    switch (inst->opcode) {
+        case IR_LOCAL_ADDR:
+            fprintf(file_ptr, " -%d", inst->stack_index);
+            if (inst->symbol != NULL) fprintf(file_ptr, " (%s)", inst->symbol);
+            separator = ", ";
+            break;
+        case IR_GLOBAL_ADDR:
+        case IR_CALL:
+            fprintf(file_ptr, " %s", inst->symbol);
+            separator = ", ";
+            break;
+        default:
+            break;
+    }
+
+    size_t i = 0, size = inst->srcs->size;
+    for (i = 0; i < size; i++) {
+        fprintf(file_ptr, "%s", separator);
+        if (inst->opcode == IR_PHI) fprintf(file_ptr, "[");
+        ir_operand_print(file_ptr, ir_inst_nth_src(inst, i));
+        if (inst->opcode == IR_PHI) {
+            fprintf(file_ptr, ", B%d]", ((IrBlock*)vector_at(inst->phi_blocks, i))->id);
+        }
+        separator = ", ";
+    }
+    for (i = 0; i < 2; i++) {
+        if (inst->targets[i] == NULL) continue;
+        fprintf(file_ptr, "%sB%d", separator, inst->targets[i]->id);
+        separator = ", ";
+    }
+    fprintf(file_ptr, "\n");
+}
+
+void ir_operand_print(FILE* file_ptr, IrOperand* operand) {
+    switch (operand->type) {
+        case IR_OPERAND_VREG:
+            fprintf(file_ptr, "v%d", operand->value);
+            break;
+        case IR_OPERAND_IMM:
+            fprintf(file_ptr, "$%d", operand->value);
+            break;
+    }
+}
+
+// utils
+void unowned_vector_delete(Vector* vector) {
+    if (vector == NULL) return;
+
+    free(vector->data);
+    free(vector);
+}
@@ -0,0 +1,156 @@
+#ifndef _IR_H_
+#define _IR_H_
+
+
+#include <stdio.h>
+#include "../parser/globallist.h"
+#include "../common/vector.h"
+
+
+typedef enum {
+    // data-movement
+    IR_MOV,
+    IR_ARG,
+    IR_LOCAL_ADDR,
+    IR_GLOBAL_ADDR,
+    IR_LOAD,
+    IR_STORE,
+    IR_MEMZERO,
+    IR_MEMCOPY,
+    // unary-operation
+    IR_NEG,
+    IR_NOT,
+    IR_SEXT8,
+    IR_SEXT32,
+    // binary-operation
+    IR_ADD,
+    IR_SUB,
+    IR_MUL,
+    IR_DIV,
+    IR_MOD,
+    IR_SHL,
+    IR_SAR,
+    IR_AND,
+    IR_XOR,
+    IR_OR,
+    // comparison
+    IR_EQ,
+    IR_NE,
+    IR_LT,
+    IR_GT,
+    IR_LE,
+    IR_GE,
+    // call
+    IR_CALL,
+    // vector
+    IR_VLOAD,
+    IR_VSTORE,
+    IR_VSPLAT,
+    IR_VZERO,
+    IR_VADD,
+    IR_VSUB,
+    IR_VAND,
+    IR_VXOR,
+    IR_VOR,
+    IR_VREDUCE,
+    IR_VEND,
+    // ssa
+    IR_PHI,
+    // terminator
+    IR_JMP,
+    IR_BR,
+    IR_RET
+} IrOpcode;
+
+typedef enum {
+    IR_OPERAND_VREG,
+    IR_OPERAND_IMM
+} IrOperandType;
+
+typedef struct {
+    IrOperandType type;
+    int value;
+} IrOperand;
+
+typedef struct _IrBlock IrBlock;
+
+typedef struct {
+    IrOpcode opcode;
+    int width;
+    int dst;
+    Vector* srcs;
+    char* symbol;
+    int stack_index;
+    IrBlock* targets[2];
+    Vector* phi_blocks;
+} IrInst;
+
+struct _IrBlock {
+    int id;
+    Vector* insts;
+    Vector* preds;
+    Vector* succs;
+};
+
+typedef struct {
+    char* funcname;
+    Vector* blocks;
+    int num_vregs;
+    int num_blocks;
+    int stack_offset;
+} IrFunction;
+
+typedef struct {
+    Vector* functions;
+    GlobalList* global_list;
+} IrModule;
+
+
+// ir-module
+IrModule* ir_module_new(GlobalList* global_list);
+void ir_module_append_function(IrModule* module, IrFunction* func);
+void ir_module_print(FILE* file_ptr, IrModule* module);
+void ir_module_delete(IrModule* module);
+
+// ir-function
+IrFunction* ir_function_new(char* funcname, int stack_offset);
+int ir_function_create_vreg(IrFunction* func);
+IrBlock* ir_function_create_block(IrFunction* func);
+IrBlock* ir_function_create_block_after(IrFunction* func, IrBlock* block);
+void ir_function_compute_cfg(IrFunction* func);
+void ir_function_remove_unreachable_blocks(IrFunction* func);
+int ir_function_has_escaping_locals(IrFunction* func);
+void ir_function_print(FILE* file_ptr, IrFunction* func);
+void ir_function_delete(IrFunction* func);
+
+// ir-block
+void ir_block_append_inst(IrBlock* block, IrInst* inst);
+void ir_block_insert_inst(IrBlock* block, size_t index, IrInst* inst);
+void ir_block_erase_inst(IrBlock* block, size_t index);
+IrInst* ir_block_terminator(IrBlock* block);
+int ir_block_is_terminated(IrBlock* block);
+int ir_block_pred_index(IrBlock* block, IrBlock* pred);
+
+// ir-inst
+IrInst* ir_inst_new(IrOpcode opcode, int width, int dst, size_t num_srcs, ...);
+IrOperand* ir_inst_nth_src(IrInst* inst, size_t n);
+void ir_inst_replace_nth_src(IrInst* inst, size_t n, IrOperand* src);
+void ir_inst_append_phi_src(IrInst* inst, IrOperand* src, IrBlock* block);
+void ir_inst_delete(IrInst* inst);
+
+// ir-operand
+IrOperand* ir_operand_new_vreg(int vreg);
+IrOperand* ir_operand_new_imm(int value);
+IrOperand* ir_operand_copy(IrOperand* operand);
+
+// ir-opcode-classifier
+int ir_is_unary_op(IrOpcode opcode);
+int ir_is_binary_op(IrOpcode opcode);
+int ir_is_comparison(IrOpcode opcode);
+int ir_is_terminator(IrOpcode opcode);
+int ir_is_vector_op(IrOpcode opcode);
+int ir_writes_memory(IrOpcode opcode);
+int ir_has_side_effects(IrOpcode opcode);
+
+
+#endif  // _IR_H_
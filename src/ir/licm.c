@@ -0,0 +1,271 @@
+#include "licm.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "loop.h"
+#include "../common/memory.h"
+
+
+typedef enum {
+    MEMORY_UNKNOWN,
+    MEMORY_LOCAL,
+    MEMORY_GLOBAL
+} MemoryKind;
+
+typedef struct {
+    MemoryKind kind;
+    int stack_index;
+    char* symbol;
+} MemoryBase;
+
+typedef struct {
+    IrFunction* func;
+    Dominance* dominance;
+    IrInst** def_insts;
+    IrBlock** def_blocks;
+    MemoryBase* bases;
+    char* resolved;
+    char* escaped_locals;
+} LicmEnv;
+
+
+// alias-analysis
+MemoryBase* resolve_memory_base(LicmEnv* env, IrOperand* operand);
+void collect_escaped_locals(LicmEnv* env);
+int may_alias(LicmEnv* env, MemoryBase* x, MemoryBase* y);
+int is_clobbered_by_call(LicmEnv* env, MemoryBase* base);
+
+// hoister
+int hoist_loop(LicmEnv* env, Loop* loop);
+int is_loop_invariant(LicmEnv* env, Loop* loop, IrBlock* block, IrInst* inst, Vector* stores, int has_call);
+int is_hoistable_opcode(IrInst* inst);
+int dominates_loop_exits(LicmEnv* env, Loop* loop, IrBlock* block);
+
+
+void hoist_loop_invariants(IrFunction* func, FILE* report_file) {
+    ir_function_compute_cfg(func);
+    Dominance* dominance = dominance_new(func);
+    if (insert_preheaders(func, dominance)) {
+        dominance_delete(dominance);
+        ir_function_compute_cfg(func);
+        dominance = dominance_new(func);
+    }
+
+    LicmEnv env;
+    int num_vregs = func->num_vregs;
+    env.func = func;
+    env.dominance = dominance;
+    env.def_insts = (IrInst**)safe_malloc((num_vregs + 1) * sizeof(IrInst*));
+    env.def_blocks = (IrBlock**)safe_malloc((num_vregs + 1) * sizeof(IrBlock*));
+    env.bases = (MemoryBase*)safe_malloc((num_vregs + 1) * sizeof(MemoryBase));
+    env.resolved = (char*)safe_malloc((num_vregs + 1) * sizeof(char));
+    env.escaped_locals = (char*)safe_malloc((func->stack_offset + 1) * sizeof(char));
+    memset(env.def_insts, 0, (num_vregs + 1) * sizeof(IrInst*));
+    memset(env.def_blocks, 0, (num_vregs + 1) * sizeof(IrBlock*));
+    memset(env.resolved, 0, num_vregs + 1);
+    memset(env.escaped_locals, 0, func->stack_offset + 1);
+
+    size_t i = 0, j = 0;
+    for (i = 0; i < func->blocks->size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            if (inst->dst < 0) continue;
+            env.def_insts[inst->dst] = inst;
+            env.def_blocks[inst->dst] = block;
+        }
+    }
+    collect_escaped_locals(&env);
+
+    Vector* loops = find_loops(func, dominance);
+    for (i = 0; i < loops->size; i++) {
+        Loop* loop = (Loop*)vector_at(loops, i);
+        if (loop->preheader == NULL) {
+            loop_delete(loop);
+            loops->data[i] = NULL;
+            continue;
+        }
+        int num_hoisted = hoist_loop(&env, loop);
+        if (report_file != NULL) {
+            fprintf(report_file, "licm: %s B%d hoisted %d\n", func->funcname, loop->header->id, num_hoisted);
+        }
+        loop_delete(loop);
+        loops->data[i] = NULL;
+    }
+
+    vector_delete(loops);
+    free(env.escaped_locals);
+    free(env.resolved);
+    free(env.bases);
+    free(env.def_blocks);
+    free(env.def_insts);
+    dominance_delete(env.dominance);
+}
+
+// alias-analysis
+MemoryBase* resolve_memory_base(LicmEnv* env, IrOperand* operand) {
+    static MemoryBase unknown_base = { MEMORY_UNKNOWN, 0, NULL };
+    if (operand->type != IR_OPERAND_VREG) return &unknown_base;
+
+    int vreg = operand->value;
+    MemoryBase* base = &env->bases[vreg];
+    if (env->resolved[vreg]) return base;
+    env->resolved[vreg] = 1;
+    *base = unknown_base;
+
+    IrInst* inst = env->def_insts[vreg];
+    if (inst == NULL) return base;
+    switch (inst->opcode) {
+        case IR_LOCAL_ADDR:
+            base->kind = MEMORY_LOCAL;
+            base->stack_index = inst->stack_index;
+            break;
+        case IR_GLOBAL_ADDR:
+            base->kind = MEMORY_GLOBAL;
+            base->symbol = inst->symbol;
+            break;
+        case IR_MOV:
+            *base = *resolve_memory_base(env, ir_inst_nth_src(inst, 0));
+            break;
+        case IR_ADD:
+        case IR_SUB: {
+            MemoryBase* lhs_base = resolve_memory_base(env, ir_inst_nth_src(inst, 0));
+            MemoryBase* rhs_base = resolve_memory_base(env, ir_inst_nth_src(inst, 1));
+            if (lhs_base->kind != MEMORY_UNKNOWN)                              *base = *lhs_base;
+            else if (inst->opcode == IR_ADD && rhs_base->kind != MEMORY_UNKNOWN) *base = *rhs_base;
+            break;
+        }
+        default:
+            break;
+    }
+    return base;
+}
+
+void collect_escaped_locals(LicmEnv* env) {
+    size_t i = 0, j = 0, k = 0;
+    for (i = 0; i < env->func->blocks->size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(env->func->blocks, i);
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            for (k = 0; k < inst->srcs->size; k++) {
+                MemoryBase* base = resolve_memory_base(env, ir_inst_nth_src(inst, k));
+                if (base->kind != MEMORY_LOCAL) continue;
+                if ((inst->opcode == IR_LOAD || inst->opcode == IR_STORE) && k == 0) continue;
+                if (inst->opcode == IR_MOV || inst->opcode == IR_ADD || inst->opcode == IR_SUB) continue;
+                env->escaped_locals[base->stack_index] = 1;
+            }
+        }
+    }
+}
+
+int may_alias(LicmEnv* env, MemoryBase* x, MemoryBase* y) {
+    if (x->kind == MEMORY_UNKNOWN) return y->kind != MEMORY_LOCAL || env->escaped_locals[y->stack_index];
+    if (y->kind == MEMORY_UNKNOWN) return x->kind != MEMORY_LOCAL || env->escaped_locals[x->stack_index];
+    if (x->kind != y->kind) return 0;
+    if (x->kind == MEMORY_LOCAL) return x->stack_index == y->stack_index;
+    return strcmp(x->symbol, y->symbol) == 0;
+}
+
+int is_clobbered_by_call(LicmEnv* env, MemoryBase* base) {
+    return base->kind != MEMORY_LOCAL || env->escaped_locals[base->stack_index];
+}
+
+// hoister
+int hoist_loop(LicmEnv* env, Loop* loop) {
+    Vector* stores = vector_new();
+    int has_call = 0;
+    Vector* rpo = env->dominance->rpo;
+
+    size_t i = 0, j = 0, size = rpo->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(rpo, i);
+        if (!loop->body[block->id]) continue;
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            if (inst->opcode == IR_CALL) has_call = 1;
+            if (ir_writes_memory(inst->opcode)) {
+                vector_push_back(stores, resolve_memory_base(env, ir_inst_nth_src(inst, 0)));
+            }
+        }
+    }
+
+    int num_hoisted = 0;
+    IrBlock* preheader = loop->preheader;
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(rpo, i);
+        if (!loop->body[block->id]) continue;
+        j = 0;
+        while (j < block->insts->size) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            if (!is_loop_invariant(env, loop, block, inst, stores, has_call)) {
+                j++;
+                continue;
+            }
+            vector_erase(block->insts, j);
+            ir_block_insert_inst(preheader, preheader->insts->size - 1, inst);
+            env->def_blocks[inst->dst] = preheader;
+            num_hoisted++;
+        }
+    }
+
+    free(stores->data);
+    free(stores);
+    return num_hoisted;
+}
+
+int is_loop_invariant(LicmEnv* env, Loop* loop, IrBlock* block, IrInst* inst, Vector* stores, int has_call) {
+    if (inst->dst < 0 || !is_hoistable_opcode(inst)) return 0;
+
+    size_t i = 0, size = inst->srcs->size;
+    for (i = 0; i < size; i++) {
+        IrOperand* src = ir_inst_nth_src(inst, i);
+        if (src->type != IR_OPERAND_VREG) continue;
+        IrBlock* def_block = env->def_blocks[src->value];
+        if (def_block == NULL || loop->body[def_block->id]) return 0;
+    }
+    if (inst->opcode != IR_LOAD) return 1;
+
+    if (!dominates_loop_exits(env, loop, block)) return 0;
+    MemoryBase* base = resolve_memory_base(env, ir_inst_nth_src(inst, 0));
+    if (has_call && is_clobbered_by_call(env, base)) return 0;
+    size = stores->size;
+    for (i = 0; i < size; i++) {
+        if (may_alias(env, base, (MemoryBase*)vector_at(stores, i))) return 0;
+    }
+    return 1;
+}
+
+int is_hoistable_opcode(IrInst* inst) {
+    switch (inst->opcode) {
+        case IR_MOV:
+        case IR_LOCAL_ADDR:
+        case IR_GLOBAL_ADDR:
+        case IR_LOAD:
+            return 1;
+        case IR_DIV:
+        case IR_MOD: {
+            IrOperand* divisor = ir_inst_nth_src(inst, 1);
+            return divisor->type == IR_OPERAND_IMM && divisor->value != 0 && divisor->value != -1;
+        }
+        default:
+            return ir_is_unary_op(inst->opcode) || ir_is_binary_op(inst->opcode) || ir_is_comparison(inst->opcode);
+    }
+}
+
+int dominates_loop_exits(LicmEnv* env, Loop* loop, IrBlock* block) {
+    if (block == loop->header) return 1;
+
+    int num_exits = 0;
+    size_t i = 0, j = 0, size = env->dominance->rpo->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* exiting = (IrBlock*)vector_at(env->dominance->rpo, i);
+        if (!loop->body[exiting->id]) continue;
+        for (j = 0; j < exiting->succs->size; j++) {
+            IrBlock* succ = (IrBlock*)vector_at(exiting->succs, j);
+            if (loop->body[succ->id]) continue;
+            if (!dominance_dominates(env->dominance, block, exiting)) return 0;
+            num_exits++;
+        }
+    }
+    return num_exits > 0;
+}
@@ -0,0 +1,12 @@
+#ifndef _LICM_H_
+#define _LICM_H_
+
+
+#include <stdio.h>
+#include "ir.h"
+
+
+void hoist_loop_invariants(IrFunction* func, FILE* report_file);
+
+
+#endif  // _LICM_H_
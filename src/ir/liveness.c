@@ -0,0 +1,124 @@
+#include "liveness.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "../common/memory.h"
+
+
+// dataflow
+void compute_uses_and_defs(IrBlock* block, char* uses, char* defs);
+int update_live_sets(IrBlock* block, Liveness* liveness, char* uses, char* defs);
+
+
+// liveness
+Liveness* liveness_new(IrFunction* func) {
+    Liveness* liveness = (Liveness*)safe_malloc(sizeof(Liveness));
+    int num_vregs = func->num_vregs;
+    int num_blocks = func->num_blocks;
+    liveness->num_vregs = num_vregs;
+    liveness->num_blocks = num_blocks;
+    liveness->live_in = (char**)safe_malloc(num_blocks * sizeof(char*));
+    liveness->live_out = (char**)safe_malloc(num_blocks * sizeof(char*));
+
+    char** uses = (char**)safe_malloc(num_blocks * sizeof(char*));
+    char** defs = (char**)safe_malloc(num_blocks * sizeof(char*));
+    int i = 0;
+    for (i = 0; i < num_blocks; i++) {
+        liveness->live_in[i] = (char*)safe_malloc((num_vregs + 1) * sizeof(char));
+        liveness->live_out[i] = (char*)safe_malloc((num_vregs + 1) * sizeof(char));
+        uses[i] = (char*)safe_malloc((num_vregs + 1) * sizeof(char));
+        defs[i] = (char*)safe_malloc((num_vregs + 1) * sizeof(char));
+        memset(liveness->live_in[i], 0, num_vregs + 1);
+        memset(liveness->live_out[i], 0, num_vregs + 1);
+        memset(uses[i], 0, num_vregs + 1);
+        memset(defs[i], 0, num_vregs + 1);
+    }
+
+    int size = func->blocks->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        compute_uses_and_defs(block, uses[block->id], defs[block->id]);
+    }
+
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (i = size - 1; i >= 0; i--) {
+            IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+            changed |= update_live_sets(block, liveness, uses[block->id], defs[block->id]);
+        }
+    }
+
+    for (i = 0; i < num_blocks; i++) {
+        free(uses[i]);
+        free(defs[i]);
+    }
+    free(uses);
+    free(defs);
+    return liveness;
+}
+
+int liveness_is_live_in(Liveness* liveness, IrBlock* block, int vreg) {
+    return liveness->live_in[block->id][vreg];
+}
+
+int liveness_is_live_out(Liveness* liveness, IrBlock* block, int vreg) {
+    return liveness->live_out[block->id][vreg];
+}
+
+void liveness_delete(Liveness* liveness) {
+    if (liveness == NULL) return;
+
+    int i = 0;
+    for (i = 0; i < liveness->num_blocks; i++) {
+        free(liveness->live_in[i]);
+        free(liveness->live_out[i]);
+    }
+    free(liveness->live_in);
+    free(liveness->live_out);
+    free(liveness);
+}
+
+// dataflow
+void compute_uses_and_defs(IrBlock* block, char* uses, char* defs) {
+    size_t i = 0, j = 0, size = block->insts->size;
+    for (i = 0; i < size; i++) {
+        IrInst* inst = (IrInst*)vector_at(block->insts, i);
+        size_t num_srcs = inst->srcs->size;
+        for (j = 0; j < num_srcs; j++) {
+            IrOperand* src = ir_inst_nth_src(inst, j);
+            if (src->type == IR_OPERAND_VREG && !defs[src->value]) uses[src->value] = 1;
+        }
+        if (inst->dst >= 0) defs[inst->dst] = 1;
+    }
+}
+
+int update_live_sets(IrBlock* block, Liveness* liveness, char* uses, char* defs) {
+    int num_vregs = liveness->num_vregs;
+    char* live_in = liveness->live_in[block->id];
+    char* live_out = liveness->live_out[block->id];
+    int changed = 0;
+
+    size_t i = 0, size = block->succs->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* succ = (IrBlock*)vector_at(block->succs, i);
+        char* succ_live_in = liveness->live_in[succ->id];
+        int vreg = 0;
+        for (vreg = 0; vreg < num_vregs; vreg++) {
+            if (succ_live_in[vreg] && !live_out[vreg]) {
+                live_out[vreg] = 1;
+                changed = 1;
+            }
+        }
+    }
+
+    int vreg = 0;
+    for (vreg = 0; vreg < num_vregs; vreg++) {
+        int is_live_in = uses[vreg] || (live_out[vreg] && !defs[vreg]);
+        if (is_live_in && !live_in[vreg]) {
+            live_in[vreg] = 1;
+            changed = 1;
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,23 @@
+#ifndef _LIVENESS_H_
+#define _LIVENESS_H_
+
+
+#include "ir.h"
+
+
+typedef struct {
+    int num_vregs;
+    int num_blocks;
+    char** live_in;
+    char** live_out;
+} Liveness;
+
+
+// liveness
+Liveness* liveness_new(IrFunction* func);
+int liveness_is_live_in(Liveness* liveness, IrBlock* block, int vreg);
+int liveness_is_live_out(Liveness* liveness, IrBlock* block, int vreg);
+void liveness_delete(Liveness* liveness);
+
+
+#endif  // _LIVENESS_H_
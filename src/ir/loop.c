@@ -0,0 +1,149 @@
+#include "loop.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "../common/memory.h"
+
+
+// loop
+Loop* find_loop_with_header(Vector* loops, IrBlock* header);
+void collect_loop_body(Loop* loop, IrBlock* latch);
+IrBlock* find_preheader(Loop* loop);
+IrBlock* find_outside_pred(Loop* loop);
+IrBlock* insert_preheader(IrFunction* func, Loop* loop, IrBlock* pred);
+int compare_loops(const void* x, const void* y);
+
+
+// loop
+Vector* find_loops(IrFunction* func, Dominance* dominance) {
+    Vector* loops = vector_new();
+    Vector* rpo = dominance->rpo;
+
+    size_t i = 0, j = 0, size = rpo->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(rpo, i);
+        for (j = 0; j < block->succs->size; j++) {
+            IrBlock* succ = (IrBlock*)vector_at(block->succs, j);
+            if (!dominance_dominates(dominance, succ, block)) continue;
+
+            Loop* loop = find_loop_with_header(loops, succ);
+            if (loop == NULL) {
+                loop = (Loop*)safe_malloc(sizeof(Loop));
+                loop->header = succ;
+                loop->preheader = NULL;
+                loop->body = (char*)safe_malloc(func->num_blocks * sizeof(char));
+                memset(loop->body, 0, func->num_blocks);
+                loop->body[succ->id] = 1;
+                loop->size = 1;
+                vector_push_back(loops, loop);
+            }
+            collect_loop_body(loop, block);
+        }
+    }
+
+    for (i = 0; i < loops->size; i++) {
+        Loop* loop = (Loop*)vector_at(loops, i);
+        loop->preheader = find_preheader(loop);
+    }
+    qsort(loops->data, loops->size, sizeof(Loop*), compare_loops);
+    return loops;
+}
+
+Loop* find_loop_with_header(Vector* loops, IrBlock* header) {
+    size_t i = 0, size = loops->size;
+    for (i = 0; i < size; i++) {
+        Loop* loop = (Loop*)vector_at(loops, i);
+        if (loop->header == header) return loop;
+    }
+    return NULL;
+}
+
+void collect_loop_body(Loop* loop, IrBlock* latch) {
+    Vector* worklist = vector_new();
+    vector_push_back(worklist, latch);
+    while (worklist->size > 0) {
+        IrBlock* block = (IrBlock*)vector_at(worklist, worklist->size - 1);
+        worklist->size--;
+        if (loop->body[block->id]) continue;
+        loop->body[block->id] = 1;
+        loop->size++;
+
+        size_t i = 0, size = block->preds->size;
+        for (i = 0; i < size; i++) {
+            vector_push_back(worklist, vector_at(block->preds, i));
+        }
+    }
+    free(worklist->data);
+    free(worklist);
+}
+
+IrBlock* find_preheader(Loop* loop) {
+    IrBlock* pred = find_outside_pred(loop);
+    if (pred == NULL || pred->succs->size != 1) return NULL;
+    return pred;
+}
+
+IrBlock* find_outside_pred(Loop* loop) {
+    IrBlock* outside_pred = NULL;
+    size_t i = 0, size = loop->header->preds->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* pred = (IrBlock*)vector_at(loop->header->preds, i);
+        if (loop->body[pred->id]) continue;
+        if (outside_pred != NULL) return NULL;
+        outside_pred = pred;
+    }
+    return outside_pred;
+}
+
+int insert_preheaders(IrFunction* func, Dominance* dominance) {
+    int num_inserted = 0;
+    Vector* loops = find_loops(func, dominance);
+    size_t i = 0, size = loops->size;
+    for (i = 0; i < size; i++) {
+        Loop* loop = (Loop*)vector_at(loops, i);
+        IrBlock* pred = find_outside_pred(loop);
+        if (pred != NULL && pred->succs->size > 1) {
+            insert_preheader(func, loop, pred);
+            num_inserted++;
+        }
+        loop_delete(loop);
+        loops->data[i] = NULL;
+    }
+    vector_delete(loops);
+    return num_inserted;
+}
+
+IrBlock* insert_preheader(IrFunction* func, Loop* loop, IrBlock* pred) {
+    IrBlock* preheader = ir_function_create_block_after(func, pred);
+    IrInst* jump = ir_inst_new(IR_JMP, 0, -1, 0);
+    jump->targets[0] = loop->header;
+    ir_block_append_inst(preheader, jump);
+
+    IrInst* terminator = ir_block_terminator(pred);
+    size_t i = 0, j = 0;
+    for (i = 0; i < 2; i++) {
+        if (terminator->targets[i] == loop->header) terminator->targets[i] = preheader;
+    }
+
+    for (i = 0; i < loop->header->insts->size; i++) {
+        IrInst* phi = (IrInst*)vector_at(loop->header->insts, i);
+        if (phi->opcode != IR_PHI) break;
+        for (j = 0; j < phi->phi_blocks->size; j++) {
+            if (vector_at(phi->phi_blocks, j) == pred) phi->phi_blocks->data[j] = preheader;
+        }
+    }
+    return preheader;
+}
+
+int compare_loops(const void* x, const void* y) {
+    Loop* loop_x = *(Loop**)x;
+    Loop* loop_y = *(Loop**)y;
+    if (loop_x->size != loop_y->size) return loop_x->size - loop_y->size;
+    return loop_x->header->id - loop_y->header->id;
+}
+
+void loop_delete(Loop* loop) {
+    if (loop == NULL) return;
+    free(loop->body);
+    free(loop);
+}
@@ -0,0 +1,22 @@
+#ifndef _LOOP_H_
+#define _LOOP_H_
+
+
+#include "dominance.h"
+#include "ir.h"
+
+
+typedef struct {
+    IrBlock* header;
+    IrBlock* preheader;
+    char* body;
+    int size;
+} Loop;
+
+
+Vector* find_loops(IrFunction* func, Dominance* dominance);
+int insert_preheaders(IrFunction* func, Dominance* dominance);
+void loop_delete(Loop* loop);
+
+
+#endif  // _LOOP_H_
@@ -0,0 +1,929 @@
+#include "lower.h"
+
+#include <stdlib.h>
+#include "optimize.h"
+#include "strength.h"
+#include "vectorize.h"
+#include "../common/memory.h"
+
+
+typedef struct {
+    IrFunction* func;
+    IrBlock* block;
+    IrBlock* continue_block;
+    IrBlock* break_block;
+    Ast* func_body;
+    int vector_width;
+} LowerEnv;
+
+
+// expression-lowerer
+IrOperand* lower_primary_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_postfix_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_unary_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_cast_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_multiplicative_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_additive_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_shift_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_relational_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_equality_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_bitwise_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_logical_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_assignment_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_expr(Ast* ast, LocalTable* local_table, LowerEnv* env);
+
+// statement-lowerer
+void lower_compound_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env);
+void lower_expr_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env);
+void lower_selection_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env);
+void lower_iteration_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env);
+void lower_jump_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env);
+void lower_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env);
+
+// vector-loop-lowerer
+void lower_vector_loop(Ast* ast, LocalTable* local_table, LowerEnv* env);
+void lower_vector_overlap_checks(
+    VectorLoop* loop, Ast* value, IrOperand* index, IrOperand* remaining,
+    IrBlock* scalar_block, LocalTable* local_table, LowerEnv* env
+);
+void lower_vector_expr(Ast* ast, int reg, int width, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_vector_element_address(Ast* base, IrOperand* index, int size, LocalTable* local_table, LowerEnv* env);
+void lower_vector_inst(IrOpcode opcode, int width, IrOperand* lhs, IrOperand* rhs, LowerEnv* env);
+IrOpcode vector_opcode_of(AstType type);
+
+// declaration-lowerer
+void lower_declaration_list(Ast* ast, LocalTable* local_table, LowerEnv* env);
+void lower_declaration(Ast* ast, LocalTable* local_table, LowerEnv* env);
+void lower_initializer(Ast* init, CType* ctype, int* stack_index, LocalTable* local_table, LowerEnv* env);
+
+// utils
+IrOperand* lower_address(Ast* ast, LocalTable* local_table, LowerEnv* env);
+IrOperand* lower_local_address(int stack_index, LowerEnv* env);
+IrOperand* lower_inst(IrOpcode opcode, int width, size_t num_srcs, IrOperand* lhs, IrOperand* rhs, LowerEnv* env);
+IrOperand* lower_pointer_offset(IrOperand* index, int size, LowerEnv* env);
+IrOperand* lower_truncation(IrOperand* value, CType* ctype, LowerEnv* env);
+void lower_store(IrOperand* address, IrOperand* value, CType* ctype, LowerEnv* env);
+void lower_jump(IrBlock* target, LowerEnv* env);
+void lower_condition(Ast* cond, IrBlock* true_block, IrBlock* false_block, LocalTable* local_table, LowerEnv* env);
+void lower_branch(IrOperand* cond, int width, IrBlock* true_block, IrBlock* false_block, LowerEnv* env);
+void lower_terminator(IrInst* inst, LowerEnv* env);
+IrOpcode binary_opcode_of(AstType type);
+int ir_width_of(CType* ctype);
+
+// assertion
+void assert_lower(int condition);
+
+
+IrFunction* lower_function_definition(Ast* ast, int vector_width) {
+    Ast* func_decl = ast_nth_child(ast, 0);
+    Ast* param_list = ast_nth_child(func_decl, 1);
+    Ast* block = ast_nth_child(ast, 1);
+
+    Ast* func_ident = ast_nth_child(func_decl, 0);
+    LowerEnv env;
+    env.func = ir_function_new(str_new(func_ident->value_ident), block->local_table->stack_offset);
+    env.block = ir_function_create_block(env.func);
+    env.continue_block = NULL;
+    env.break_block = NULL;
+    env.func_body = block;
+    env.vector_width = vector_width;
+
+    size_t i = 0, size = param_list->children->size;
+    // TODO: more than six arguments
+    assert_lower(size <= 6);
+
+    for (i = 0; i < size; i++) {
+        Ast* param_ident = ast_nth_child(ast_nth_child(param_list, i), 0);
+        IrOperand* arg = lower_inst(
+            IR_ARG, ir_width_of(param_ident->ctype), 1, ir_operand_new_imm(i), NULL, &env
+        );
+        IrOperand* address = lower_address(param_ident, block->local_table, &env);
+        lower_store(address, arg, param_ident->ctype, &env);
+    }
+
+    lower_compound_stmt(block, block->local_table, &env);
+    if (!ir_block_is_terminated(env.block)) {
+        ir_block_append_inst(env.block, ir_inst_new(IR_RET, 0, -1, 0));
+    }
+
+    ir_function_compute_cfg(env.func);
+    return env.func;
+}
+
+IrModule* lower_astlist(AstList* astlist, int vector_width) {
+    IrModule* module = ir_module_new(astlist->global_list);
+    while (1) {
+        Ast* ast = astlist_top(astlist);
+        if (ast == NULL) break;
+        ir_module_append_function(module, lower_function_definition(ast, vector_width));
+        astlist_pop(astlist);
+    }
+    astlist->pos = 0;
+    return module;
+}
+
+void print_ir(FILE* file_ptr, AstList* astlist, Option* option) {
+    IrModule* module = lower_astlist(astlist, option->opt_level >= 2 ? option->vector_width : 0);
+    optimize_ir_module(module, option);
+    ir_module_print(file_ptr, module);
+    ir_module_delete(module);
+}
+
+// expression-lowerer
+IrOperand* lower_primary_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    switch (ast->type) {
+        case AST_IMM_INT:
+            return ir_operand_new_imm(ast->value_int);
+        case AST_IDENT: {
+            IrOperand* address = lower_address(ast, local_table, env);
+            return lower_inst(IR_LOAD, ast->ctype->size, 1, address, NULL, env);
+        }
+        default:
+            assert_lower(0);
+            return NULL;
+    }
+}
+
+IrOperand* lower_postfix_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    switch (ast->type) {
+        case AST_FUNC_CALL: {
+            Ast* callable = ast_nth_child(ast, 0);
+            Ast* arg_list = ast_nth_child(ast, 1);
+            // TODO: callable object not only an ident
+            assert_lower(callable->type == AST_IDENT);
+
+            size_t i = 0, num_args = arg_list->children->size;
+            // TODO: more than six arguments
+            assert_lower(num_args <= 6);
+
+            int dst = ir_function_create_vreg(env->func);
+            IrInst* inst = ir_inst_new(IR_CALL, ir_width_of(ast->ctype), dst, 0);
+            inst->symbol = str_new(callable->value_ident);
+            for (i = 0; i < num_args; i++) {
+                vector_push_back(inst->srcs, lower_expr(ast_nth_child(arg_list, i), local_table, env));
+            }
+            ir_block_append_inst(env->block, inst);
+            return ir_operand_new_vreg(dst);
+        }
+        case AST_POST_INCR:
+        case AST_POST_DECR: {
+            Ast* child = ast_nth_child(ast, 0);
+            IrOpcode opcode = ast->type == AST_POST_INCR ? IR_ADD : IR_SUB;
+            IrOperand* address = lower_address(child, local_table, env);
+            IrOperand* value = lower_inst(
+                IR_LOAD, child->ctype->size, 1, ir_operand_copy(address), NULL, env
+            );
+            IrOperand* step = ir_operand_new_imm(
+                child->ctype->basic_ctype == CTYPE_PTR ? child->ctype->ptr_to->size : 1
+            );
+            IrOperand* result = lower_inst(
+                opcode, ir_width_of(child->ctype), 2, ir_operand_copy(value), step, env
+            );
+            lower_store(address, result, child->ctype, env);
+            return value;
+        }
+        default:
+            assert_lower(0);
+            return NULL;
+    }
+}
+
+IrOperand* lower_unary_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    Ast* child = ast_nth_child(ast, 0);
+
+    switch (ast->type) {
+        case AST_PRE_INCR:
+        case AST_PRE_DECR: {
+            IrOpcode opcode = ast->type == AST_PRE_INCR ? IR_ADD : IR_SUB;
+            IrOperand* address = lower_address(child, local_table, env);
+            IrOperand* value = lower_inst(
+                IR_LOAD, child->ctype->size, 1, ir_operand_copy(address), NULL, env
+            );
+            IrOperand* step = ir_operand_new_imm(
+                child->ctype->basic_ctype == CTYPE_PTR ? child->ctype->ptr_to->size : 1
+            );
+            IrOperand* result = lower_inst(opcode, ir_width_of(child->ctype), 2, value, step, env);
+            lower_store(address, ir_operand_copy(result), child->ctype, env);
+            return lower_truncation(result, child->ctype, env);
+        }
+        case AST_ADDR:
+            return lower_address(child, local_table, env);
+        case AST_DEREF: {
+            IrOperand* address = lower_expr(child, local_table, env);
+            return lower_inst(IR_LOAD, ast->ctype->size, 1, address, NULL, env);
+        }
+        case AST_POSI:
+            return lower_expr(child, local_table, env);
+        case AST_NEGA:
+            return lower_inst(IR_NEG, 4, 1, lower_expr(child, local_table, env), NULL, env);
+        case AST_NOT:
+            return lower_inst(IR_NOT, 4, 1, lower_expr(child, local_table, env), NULL, env);
+        case AST_LNOT: {
+            IrOperand* value = lower_expr(child, local_table, env);
+            return lower_inst(IR_EQ, ir_width_of(child->ctype), 2, value, ir_operand_new_imm(0), env);
+        }
+        default:
+            assert_lower(0);
+            return NULL;
+    }
+}
+
+IrOperand* lower_cast_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    switch (ast->type) {
+        case AST_ARRAY_TO_PTR:
+            return lower_address(ast_nth_child(ast, 0), local_table, env);
+        default:
+            assert_lower(0);
+            return NULL;
+    }
+}
+
+IrOperand* lower_multiplicative_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    IrOperand* lhs = lower_expr(ast_nth_child(ast, 0), local_table, env);
+    IrOperand* rhs = lower_expr(ast_nth_child(ast, 1), local_table, env);
+    return lower_inst(binary_opcode_of(ast->type), 4, 2, lhs, rhs, env);
+}
+
+IrOperand* lower_additive_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    Ast* lhs = ast_nth_child(ast, 0);
+    Ast* rhs = ast_nth_child(ast, 1);
+    IrOperand* lhs_operand = lower_expr(lhs, local_table, env);
+    IrOperand* rhs_operand = lower_expr(rhs, local_table, env);
+    BasicCType lhs_basic_ctype = lhs->ctype->basic_ctype;
+    BasicCType rhs_basic_ctype = rhs->ctype->basic_ctype;
+    IrOpcode opcode = binary_opcode_of(ast->type);
+
+    if (lhs_basic_ctype == CTYPE_INT && rhs_basic_ctype == CTYPE_INT) {
+        return lower_inst(opcode, 4, 2, lhs_operand, rhs_operand, env);
+    } else if (lhs_basic_ctype == CTYPE_PTR && rhs_basic_ctype == CTYPE_INT) {
+        rhs_operand = lower_pointer_offset(rhs_operand, lhs->ctype->ptr_to->size, env);
+        return lower_inst(opcode, 8, 2, lhs_operand, rhs_operand, env);
+    } else if (
+        ast->type == AST_ADD &&
+        lhs_basic_ctype == CTYPE_INT &&
+        rhs_basic_ctype == CTYPE_PTR
+    ) {
+        lhs_operand = lower_pointer_offset(lhs_operand, rhs->ctype->ptr_to->size, env);
+        return lower_inst(opcode, 8, 2, lhs_operand, rhs_operand, env);
+    } else if (
+        ast->type == AST_SUB &&
+        lhs_basic_ctype == CTYPE_PTR &&
+        rhs_basic_ctype == CTYPE_PTR &&
+        ctype_equals(lhs->ctype->ptr_to, rhs->ctype->ptr_to)
+    ) {
+        IrOperand* diff = lower_inst(IR_SUB, 8, 2, lhs_operand, rhs_operand, env);
+        int size = lhs->ctype->ptr_to->size;
+        int shift = exact_log2(size);
+        if (shift >= 0) return lower_inst(IR_SAR, 8, 2, diff, ir_operand_new_imm(shift), env);
+        return lower_inst(IR_DIV, 8, 2, diff, ir_operand_new_imm(size), env);
+    }
+    assert_lower(0);
+    return NULL;
+}
+
+IrOperand* lower_shift_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    IrOperand* lhs = lower_expr(ast_nth_child(ast, 0), local_table, env);
+    IrOperand* rhs = lower_expr(ast_nth_child(ast, 1), local_table, env);
+    return lower_inst(binary_opcode_of(ast->type), 4, 2, lhs, rhs, env);
+}
+
+IrOperand* lower_relational_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    Ast* lhs = ast_nth_child(ast, 0);
+    IrOperand* lhs_operand = lower_expr(lhs, local_table, env);
+    IrOperand* rhs_operand = lower_expr(ast_nth_child(ast, 1), local_table, env);
+    IrOpcode opcode = IR_LT;
+    switch (ast->type) {
+        case AST_LT:
+            opcode = IR_LT;
+            break;
+        case AST_GT:
+            opcode = IR_GT;
+            break;
+        case AST_LEQ:
+            opcode = IR_LE;
+            break;
+        case AST_GEQ:
+            opcode = IR_GE;
+            break;
+        default:
+            assert_lower(0);
+    }
+    return lower_inst(opcode, ir_width_of(lhs->ctype), 2, lhs_operand, rhs_operand, env);
+}
+
+IrOperand* lower_equality_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    Ast* lhs = ast_nth_child(ast, 0);
+    IrOperand* lhs_operand = lower_expr(lhs, local_table, env);
+    IrOperand* rhs_operand = lower_expr(ast_nth_child(ast, 1), local_table, env);
+    IrOpcode opcode = ast->type == AST_EQ ? IR_EQ : IR_NE;
+    return lower_inst(opcode, ir_width_of(lhs->ctype), 2, lhs_operand, rhs_operand, env);
+}
+
+IrOperand* lower_bitwise_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    IrOperand* lhs = lower_expr(ast_nth_child(ast, 0), local_table, env);
+    IrOperand* rhs = lower_expr(ast_nth_child(ast, 1), local_table, env);
+    return lower_inst(binary_opcode_of(ast->type), 4, 2, lhs, rhs, env);
+}
+
+IrOperand* lower_logical_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    Ast* lhs = ast_nth_child(ast, 0);
+    Ast* rhs = ast_nth_child(ast, 1);
+    IrBlock* rhs_block = ir_function_create_block(env->func);
+    IrBlock* exit_block = ir_function_create_block(env->func);
+
+    int dst = ir_function_create_vreg(env->func);
+    int short_circuit_value = ast->type == AST_LOR ? 1 : 0;
+    ir_block_append_inst(env->block, ir_inst_new(IR_MOV, 4, dst, 1, ir_operand_new_imm(short_circuit_value)));
+
+    IrOperand* lhs_operand = lower_expr(lhs, local_table, env);
+    switch (ast->type) {
+        case AST_LOR:
+            lower_branch(lhs_operand, ir_width_of(lhs->ctype), exit_block, rhs_block, env);
+            break;
+        case AST_LAND:
+            lower_branch(lhs_operand, ir_width_of(lhs->ctype), rhs_block, exit_block, env);
+            break;
+        default:
+            assert_lower(0);
+    }
+
+    env->block = rhs_block;
+    IrOperand* rhs_operand = lower_expr(rhs, local_table, env);
+    IrOperand* rhs_value = lower_inst(
+        IR_NE, ir_width_of(rhs->ctype), 2, rhs_operand, ir_operand_new_imm(0), env
+    );
+    ir_block_append_inst(env->block, ir_inst_new(IR_MOV, 4, dst, 1, rhs_value));
+    lower_jump(exit_block, env);
+
+    env->block = exit_block;
+    return ir_operand_new_vreg(dst);
+}
+
+IrOperand* lower_assignment_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    Ast* ident = ast_nth_child(ast, 0);
+    Ast* expr = ast_nth_child(ast, 1);
+    IrOperand* value = lower_expr(expr, local_table, env);
+    IrOperand* address = lower_address(ident, local_table, env);
+
+    if (ast->type != AST_ASSIGN) {
+        IrOperand* old_value = lower_inst(
+            IR_LOAD, ident->ctype->size, 1, ir_operand_copy(address), NULL, env
+        );
+        if (ident->ctype->basic_ctype == CTYPE_PTR) {
+            value = lower_pointer_offset(value, ident->ctype->ptr_to->size, env);
+        }
+        value = lower_inst(
+            binary_opcode_of(ast->type), ir_width_of(ident->ctype), 2, old_value, value, env
+        );
+    }
+
+    lower_store(address, ir_operand_copy(value), ident->ctype, env);
+    return lower_truncation(value, ident->ctype, env);
+}
+
+IrOperand* lower_expr(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    AstType type = ast->type;
+    if (is_primary_expr(type))             return lower_primary_expr(ast, local_table, env);
+    else if (is_postfix_expr(type))        return lower_postfix_expr(ast, local_table, env);
+    else if (is_unary_expr(type))          return lower_unary_expr(ast, local_table, env);
+    else if (is_cast_expr(type))           return lower_cast_expr(ast, local_table, env);
+    else if (is_multiplicative_expr(type)) return lower_multiplicative_expr(ast, local_table, env);
+    else if (is_additive_expr(type))       return lower_additive_expr(ast, local_table, env);
+    else if (is_shift_expr(type))          return lower_shift_expr(ast, local_table, env);
+    else if (is_relational_expr(type))     return lower_relational_expr(ast, local_table, env);
+    else if (is_equality_expr(type))       return lower_equality_expr(ast, local_table, env);
+    else if (is_bitwise_expr(type))        return lower_bitwise_expr(ast, local_table, env);
+    else if (is_logical_expr(type))        return lower_logical_expr(ast, local_table, env);
+    else if (is_assignment_expr(type))     return lower_assignment_expr(ast, local_table, env);
+    else if (!is_null_expr(type))          assert_lower(0);
+    return NULL;
+}
+
+// statement-lowerer
+void lower_compound_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    size_t i = 0, size = ast->children->size;
+    switch (ast->type) {
+        case AST_COMP_STMT:
+            for (i = 0; i < size; i++) {
+                Ast* child = ast_nth_child(ast, i);
+                if (child->type == AST_DECL_LIST) {
+                    lower_declaration_list(child, ast->local_table, env);
+                } else {
+                    lower_stmt(child, ast->local_table, env);
+                }
+            }
+            break;
+        default:
+            assert_lower(0);
+            break;
+    }
+}
+
+void lower_expr_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    switch (ast->type) {
+        case AST_EXPR_STMT:
+            free(lower_expr(ast_nth_child(ast, 0), local_table, env));
+            break;
+        default:
+            assert_lower(0);
+            break;
+    }
+}
+
+void lower_selection_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    Ast* cond = ast_nth_child(ast, 0);
+
+    switch (ast->type) {
+        case AST_IF_STMT: {
+            IrBlock* then_block = ir_function_create_block(env->func);
+            IrBlock* else_block = NULL;
+            if (ast->children->size == 3) else_block = ir_function_create_block(env->func);
+            IrBlock* exit_block = ir_function_create_block(env->func);
+
+            lower_condition(cond, then_block, else_block != NULL ? else_block : exit_block, local_table, env);
+
+            env->block = then_block;
+            lower_stmt(ast_nth_child(ast, 1), local_table, env);
+            lower_jump(exit_block, env);
+            if (else_block != NULL) {
+                env->block = else_block;
+                lower_stmt(ast_nth_child(ast, 2), local_table, env);
+                lower_jump(exit_block, env);
+            }
+            env->block = exit_block;
+            break;
+        }
+        default:
+            assert_lower(0);
+            break;
+    }
+}
+
+void lower_iteration_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    Ast* child = NULL;
+    if (ast->type == AST_FOR_STMT) {
+        free(lower_expr(ast_nth_child(ast, 0), local_table, env));
+        lower_vector_loop(ast, local_table, env);
+    }
+
+    IrBlock* old_continue_block = env->continue_block;
+    IrBlock* old_break_block = env->break_block;
+
+    IrBlock* body_block = ir_function_create_block(env->func);
+    IrBlock* continue_block = ir_function_create_block(env->func);
+    IrBlock* exit_block = ir_function_create_block(env->func);
+
+    env->continue_block = continue_block;
+    env->break_block = exit_block;
+
+    switch (ast->type) {
+        case AST_WHILE_STMT:
+            child = ast_nth_child(ast, 0);
+            lower_condition(child, body_block, exit_block, local_table, env);
+            env->block = body_block;
+            lower_stmt(ast_nth_child(ast, 1), local_table, env);
+            lower_jump(continue_block, env);
+            env->block = continue_block;
+            lower_condition(child, body_block, exit_block, local_table, env);
+            break;
+        case AST_DOWHILE_STMT:
+            lower_jump(body_block, env);
+            env->block = body_block;
+            lower_stmt(ast_nth_child(ast, 0), local_table, env);
+            lower_jump(continue_block, env);
+            env->block = continue_block;
+            lower_condition(ast_nth_child(ast, 1), body_block, exit_block, local_table, env);
+            break;
+        case AST_FOR_STMT:
+            child = ast_nth_child(ast, 1);
+            if (!is_null_expr(child->type)) {
+                lower_condition(child, body_block, exit_block, local_table, env);
+            } else {
+                lower_jump(body_block, env);
+            }
+            env->block = body_block;
+            lower_stmt(ast_nth_child(ast, 3), local_table, env);
+            lower_jump(continue_block, env);
+            env->block = continue_block;
+            free(lower_expr(ast_nth_child(ast, 2), local_table, env));
+            if (!is_null_expr(child->type)) {
+                lower_condition(child, body_block, exit_block, local_table, env);
+            } else {
+                lower_jump(body_block, env);
+            }
+            break;
+        default:
+            assert_lower(0);
+            break;
+    }
+    env->block = exit_block;
+
+    env->continue_block = old_continue_block;
+    env->break_block = old_break_block;
+}
+
+void lower_jump_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    switch (ast->type) {
+        case AST_CONTINUE_STMT:
+            assert_lower(env->continue_block != NULL);
+            lower_jump(env->continue_block, env);
+            break;
+        case AST_BREAK_STMT:
+            assert_lower(env->break_block != NULL);
+            lower_jump(env->break_block, env);
+            break;
+        case AST_RETURN_STMT: {
+            Ast* child = ast_nth_child(ast, 0);
+            IrOperand* value = lower_expr(child, local_table, env);
+            lower_terminator(ir_inst_new(IR_RET, ir_width_of(child->ctype), -1, 1, value), env);
+            break;
+        }
+        default:
+            assert_lower(0);
+            break;
+    }
+    env->block = ir_function_create_block(env->func);
+}
+
+void lower_stmt(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    AstType type = ast->type;
+    if (is_compound_stmt(type))       lower_compound_stmt(ast, local_table, env);
+    else if (is_expr_stmt(type))      lower_expr_stmt(ast, local_table, env);
+    else if (is_selection_stmt(type)) lower_selection_stmt(ast, local_table, env);
+    else if (is_iteration_stmt(type)) lower_iteration_stmt(ast, local_table, env);
+    else if (is_jump_stmt(type))      lower_jump_stmt(ast, local_table, env);
+    else                              assert_lower(0);
+}
+
+// vector-loop-lowerer
+void lower_vector_loop(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    if (env->vector_width == 0) return;
+    VectorLoop* loop = analyze_vector_loop(ast, env->func_body, local_table);
+    if (loop == NULL) return;
+
+    int width = loop->elem_size;
+    int lanes = env->vector_width / width;
+    IrBlock* vector_block = ir_function_create_block(env->func);
+    IrBlock* vector_exit_block = ir_function_create_block(env->func);
+    IrBlock* scalar_block = ir_function_create_block(env->func);
+
+    IrOperand* index = lower_inst(IR_SEXT32, 8, 1, lower_expr(loop->index, local_table, env), NULL, env);
+    IrOperand* bound = lower_inst(IR_SEXT32, 8, 1, lower_expr(loop->bound, local_table, env), NULL, env);
+    IrOperand* last = lower_inst(IR_SUB, 8, 2, ir_operand_copy(bound), ir_operand_new_imm(lanes), env);
+    IrOperand* enough = lower_inst(IR_LE, 8, 2, ir_operand_copy(index), ir_operand_copy(last), env);
+    IrBlock* check_block = ir_function_create_block_after(env->func, env->block);
+    lower_branch(enough, 4, check_block, scalar_block, env);
+    env->block = check_block;
+
+    if (loop->dst != NULL) {
+        IrOperand* remaining = lower_inst(IR_SUB, 8, 2, bound, ir_operand_copy(index), env);
+        remaining = lower_inst(IR_MUL, 8, 2, remaining, ir_operand_new_imm(width), env);
+        lower_vector_overlap_checks(loop, loop->value, index, remaining, scalar_block, local_table, env);
+        free(remaining);
+    } else {
+        free(bound);
+        lower_vector_inst(IR_VZERO, 4, ir_operand_new_imm(VECTOR_ACCUMULATOR_REGISTER), NULL, env);
+    }
+    free(index);
+    lower_jump(vector_block, env);
+
+    env->block = vector_block;
+    index = lower_inst(IR_SEXT32, 8, 1, lower_expr(loop->index, local_table, env), NULL, env);
+    lower_vector_expr(loop->value, 0, width, local_table, env);
+    if (loop->dst != NULL) {
+        IrOperand* address = lower_vector_element_address(
+            vector_array_base(loop->dst), index, width, local_table, env
+        );
+        lower_vector_inst(IR_VSTORE, width, address, ir_operand_new_imm(0), env);
+    } else {
+        lower_vector_inst(
+            IR_VADD, 4, ir_operand_new_imm(VECTOR_ACCUMULATOR_REGISTER), ir_operand_new_imm(0), env
+        );
+    }
+    IrOperand* next_index = lower_inst(IR_ADD, 8, 2, index, ir_operand_new_imm(lanes), env);
+    lower_store(lower_address(loop->index, local_table, env), ir_operand_copy(next_index), loop->index->ctype, env);
+    enough = lower_inst(IR_LE, 8, 2, next_index, last, env);
+    lower_branch(enough, 4, vector_block, vector_exit_block, env);
+
+    env->block = vector_exit_block;
+    if (loop->accumulator != NULL) {
+        int sum = ir_function_create_vreg(env->func);
+        ir_block_append_inst(env->block, ir_inst_new(
+            IR_VREDUCE, 4, sum, 1, ir_operand_new_imm(VECTOR_ACCUMULATOR_REGISTER)
+        ));
+        IrOperand* value = lower_inst(
+            IR_ADD, 4, 2, lower_expr(loop->accumulator, local_table, env), ir_operand_new_vreg(sum), env
+        );
+        lower_store(lower_address(loop->accumulator, local_table, env), value, loop->accumulator->ctype, env);
+    }
+    lower_vector_inst(IR_VEND, 0, NULL, NULL, env);
+    lower_jump(scalar_block, env);
+
+    env->block = scalar_block;
+    free(loop);
+}
+
+void lower_vector_overlap_checks(
+    VectorLoop* loop, Ast* value, IrOperand* index, IrOperand* remaining,
+    IrBlock* scalar_block, LocalTable* local_table, LowerEnv* env
+) {
+    switch (value->type) {
+        case AST_DEREF: {
+            Ast* dst_base = vector_array_base(loop->dst);
+            Ast* src_base = vector_array_base(value);
+            if (vector_array_bases_equal(dst_base, src_base)) return;
+
+            int width = loop->elem_size;
+            IrOperand* dst = lower_vector_element_address(dst_base, index, width, local_table, env);
+            IrOperand* src = lower_vector_element_address(src_base, index, width, local_table, env);
+            IrOperand* src_end = lower_inst(IR_ADD, 8, 2, ir_operand_copy(src), ir_operand_copy(remaining), env);
+            IrOperand* after = lower_inst(IR_GE, 8, 2, src, ir_operand_copy(dst), env);
+            IrOperand* before = lower_inst(IR_LE, 8, 2, src_end, dst, env);
+            IrOperand* disjoint = lower_inst(IR_OR, 4, 2, after, before, env);
+            IrBlock* next_block = ir_function_create_block_after(env->func, env->block);
+            lower_branch(disjoint, 4, next_block, scalar_block, env);
+            env->block = next_block;
+            return;
+        }
+        case AST_ADD:
+        case AST_SUB:
+        case AST_AND:
+        case AST_XOR:
+        case AST_OR:
+            lower_vector_overlap_checks(loop, ast_nth_child(value, 0), index, remaining, scalar_block, local_table, env);
+            lower_vector_overlap_checks(loop, ast_nth_child(value, 1), index, remaining, scalar_block, local_table, env);
+            return;
+        default:
+            return;
+    }
+}
+
+void lower_vector_expr(Ast* ast, int reg, int width, LocalTable* local_table, LowerEnv* env) {
+    switch (ast->type) {
+        case AST_IMM_INT:
+        case AST_IDENT:
+            lower_vector_inst(IR_VSPLAT, width, ir_operand_new_imm(reg), lower_expr(ast, local_table, env), env);
+            return;
+        case AST_DEREF:
+            lower_vector_inst(
+                IR_VLOAD, width, ir_operand_new_imm(reg), lower_address(ast, local_table, env), env
+            );
+            return;
+        default:
+            lower_vector_expr(ast_nth_child(ast, 0), reg, width, local_table, env);
+            lower_vector_expr(ast_nth_child(ast, 1), reg + 1, width, local_table, env);
+            lower_vector_inst(
+                vector_opcode_of(ast->type), width, ir_operand_new_imm(reg), ir_operand_new_imm(reg + 1), env
+            );
+            return;
+    }
+}
+
+IrOperand* lower_vector_element_address(Ast* base, IrOperand* index, int size, LocalTable* local_table, LowerEnv* env) {
+    IrOperand* offset = lower_inst(IR_MUL, 8, 2, ir_operand_copy(index), ir_operand_new_imm(size), env);
+    return lower_inst(IR_ADD, 8, 2, lower_expr(base, local_table, env), offset, env);
+}
+
+void lower_vector_inst(IrOpcode opcode, int width, IrOperand* lhs, IrOperand* rhs, LowerEnv* env) {
+    size_t num_srcs = lhs == NULL ? 0 : rhs == NULL ? 1 : 2;
+    ir_block_append_inst(env->block, ir_inst_new(opcode, width, -1, num_srcs, lhs, rhs));
+}
+
+IrOpcode vector_opcode_of(AstType type) {
+    switch (type) {
+        case AST_ADD: return IR_VADD;
+        case AST_SUB: return IR_VSUB;
+        case AST_AND: return IR_VAND;
+        case AST_XOR: return IR_VXOR;
+        case AST_OR:  return IR_VOR;
+        default:
+            assert_lower(0);
+            return IR_VADD;
+    }
+}
+
+// declaration-lowerer
+void lower_declaration_list(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    size_t i = 0, size = ast->children->size;
+    for (i = 0; i < size; i++) {
+        lower_declaration(ast_nth_child(ast, i), local_table, env);
+    }
+}
+
+void lower_declaration(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    Ast* ident = ast_nth_child(ast, 0);
+    Ast* init = NULL;
+
+    switch(ident->ctype->basic_ctype) {
+        case CTYPE_CHAR:
+        case CTYPE_INT:
+        case CTYPE_PTR:
+            init = ast_nth_child(ast, 1);
+            break;
+        case CTYPE_ARRAY:
+            init = ast_nth_child(ast, 2);
+            break;
+        case CTYPE_FUNC:
+            // Do Nothing
+            break;
+    }
+    if (init == NULL) return;
+
+    if (ident->ctype->basic_ctype != CTYPE_ARRAY) {
+        IrOperand* value = lower_expr(init, local_table, env);
+        lower_store(lower_address(ident, local_table, env), value, ident->ctype, env);
+        return;
+    }
+    int stack_index = local_table_get_stack_index(local_table, ident->value_ident);
+    lower_initializer(init, ident->ctype, &stack_index, local_table, env);
+}
+
+void lower_initializer(Ast* init, CType* ctype, int* stack_index, LocalTable* local_table, LowerEnv* env) {
+    size_t i = 0, size = 0;
+    switch(ctype->basic_ctype) {
+        case CTYPE_CHAR:
+        case CTYPE_INT:
+        case CTYPE_PTR: {
+            IrOperand* value = lower_expr(init, local_table, env);
+            lower_store(lower_local_address(*stack_index, env), value, ctype, env);
+            *stack_index -= ctype->size;
+            break;
+        }
+        case CTYPE_ARRAY: {
+            int end_index = *stack_index - ctype->size;
+            if (init->type == AST_IDENT) {
+                ir_block_append_inst(env->block, ir_inst_new(
+                    IR_MEMCOPY, 0, -1, 3, lower_local_address(*stack_index, env),
+                    lower_address(init, local_table, env), ir_operand_new_imm(ctype->size)
+                ));
+                *stack_index = end_index;
+                break;
+            }
+
+            size = init->children->size;
+            for (i = 0; i < size; i++) {
+                lower_initializer(ast_nth_child(init, i), ctype->array_of, stack_index, local_table, env);
+            }
+            if (*stack_index > end_index) {
+                ir_block_append_inst(env->block, ir_inst_new(
+                    IR_MEMZERO, 0, -1, 2, lower_local_address(*stack_index, env),
+                    ir_operand_new_imm(*stack_index - end_index)
+                ));
+                *stack_index = end_index;
+            }
+            break;
+        }
+        case CTYPE_FUNC:
+            // Do Nothing
+            break;
+    }
+}
+
+// utils
+IrOperand* lower_address(Ast* ast, LocalTable* local_table, LowerEnv* env) {
+    switch(ast->type) {
+        case AST_IDENT: {
+            int dst = ir_function_create_vreg(env->func);
+            int stack_index = local_table_get_stack_index(local_table, ast->value_ident);
+            IrInst* inst = NULL;
+            if (stack_index >= 0) {
+                inst = ir_inst_new(IR_LOCAL_ADDR, 8, dst, 0);
+                inst->stack_index = stack_index;
+                inst->symbol = str_new(ast->value_ident);
+            } else {
+                inst = ir_inst_new(IR_GLOBAL_ADDR, 8, dst, 0);
+                inst->symbol = str_new(ast->value_ident);
+            }
+            ir_block_append_inst(env->block, inst);
+            return ir_operand_new_vreg(dst);
+        }
+        case AST_DEREF:
+            return lower_expr(ast_nth_child(ast, 0), local_table, env);
+        default:
+            assert_lower(0);
+            return NULL;
+    }
+}
+
+IrOperand* lower_local_address(int stack_index, LowerEnv* env) {
+    int dst = ir_function_create_vreg(env->func);
+    IrInst* inst = ir_inst_new(IR_LOCAL_ADDR, 8, dst, 0);
+    inst->stack_index = stack_index;
+    ir_block_append_inst(env->block, inst);
+    return ir_operand_new_vreg(dst);
+}
+
+IrOperand* lower_inst(IrOpcode opcode, int width, size_t num_srcs, IrOperand* lhs, IrOperand* rhs, LowerEnv* env) {
+    int dst = ir_function_create_vreg(env->func);
+    ir_block_append_inst(env->block, ir_inst_new(opcode, width, dst, num_srcs, lhs, rhs));
+    return ir_operand_new_vreg(dst);
+}
+
+IrOperand* lower_pointer_offset(IrOperand* index, int size, LowerEnv* env) {
+    index = lower_inst(IR_SEXT32, 8, 1, index, NULL, env);
+    return lower_inst(IR_MUL, 8, 2, index, ir_operand_new_imm(size), env);
+}
+
+IrOperand* lower_truncation(IrOperand* value, CType* ctype, LowerEnv* env) {
+    if (ctype->size != 1) return value;
+    return lower_inst(IR_SEXT8, 4, 1, value, NULL, env);
+}
+
+void lower_store(IrOperand* address, IrOperand* value, CType* ctype, LowerEnv* env) {
+    ir_block_append_inst(env->block, ir_inst_new(IR_STORE, ctype->size, -1, 2, address, value));
+}
+
+void lower_jump(IrBlock* target, LowerEnv* env) {
+    IrInst* inst = ir_inst_new(IR_JMP, 0, -1, 0);
+    inst->targets[0] = target;
+    lower_terminator(inst, env);
+}
+
+void lower_branch(IrOperand* cond, int width, IrBlock* true_block, IrBlock* false_block, LowerEnv* env) {
+    IrInst* inst = ir_inst_new(IR_BR, width, -1, 1, cond);
+    inst->targets[0] = true_block;
+    inst->targets[1] = false_block;
+    lower_terminator(inst, env);
+}
+
+void lower_condition(Ast* cond, IrBlock* true_block, IrBlock* false_block, LocalTable* local_table, LowerEnv* env) {
+    IrBlock* rhs_block = NULL;
+    switch (cond->type) {
+        case AST_LNOT:
+            lower_condition(ast_nth_child(cond, 0), false_block, true_block, local_table, env);
+            break;
+        case AST_LAND:
+            rhs_block = ir_function_create_block_after(env->func, env->block);
+            lower_condition(ast_nth_child(cond, 0), rhs_block, false_block, local_table, env);
+            env->block = rhs_block;
+            lower_condition(ast_nth_child(cond, 1), true_block, false_block, local_table, env);
+            break;
+        case AST_LOR:
+            rhs_block = ir_function_create_block_after(env->func, env->block);
+            lower_condition(ast_nth_child(cond, 0), true_block, rhs_block, local_table, env);
+            env->block = rhs_block;
+            lower_condition(ast_nth_child(cond, 1), true_block, false_block, local_table, env);
+            break;
+        default:
+            lower_branch(lower_expr(cond, local_table, env), ir_width_of(cond->ctype), true_block, false_block, env);
+            break;
+    }
+}
+
+void lower_terminator(IrInst* inst, LowerEnv* env) {
+    if (ir_block_is_terminated(env->block)) {
+        ir_inst_delete(inst);
+        return;
+    }
+    ir_block_append_inst(env->block, inst);
+}
+
+IrOpcode binary_opcode_of(AstType type) {
+    switch (type) {
+        case AST_MUL:
+        case AST_MUL_ASSIGN:
+            return IR_MUL;
+        case AST_DIV:
+        case AST_DIV_ASSIGN:
+            return IR_DIV;
+        case AST_MOD:
+        case AST_MOD_ASSIGN:
+            return IR_MOD;
+        case AST_ADD:
+        case AST_ADD_ASSIGN:
+            return IR_ADD;
+        case AST_SUB:
+        case AST_SUB_ASSIGN:
+            return IR_SUB;
+        case AST_LSHIFT:
+        case AST_LSHIFT_ASSIGN:
+            return IR_SHL;
+        case AST_RSHIFT:
+        case AST_RSHIFT_ASSIGN:
+            return IR_SAR;
+        case AST_AND:
+        case AST_AND_ASSIGN:
+            return IR_AND;
+        case AST_XOR:
+        case AST_XOR_ASSIGN:
+            return IR_XOR;
+        case AST_OR:
+        case AST_OR_ASSIGN:
+            return IR_OR;
+        default:
+            assert_lower(0);
+            return IR_ADD;
+    }
+}
+
+int ir_width_of(CType* ctype) {
+    if (ctype->basic_ctype == CTYPE_PTR || ctype->basic_ctype == CTYPE_ARRAY) return 8;
+    return 4;
+}
+
+// assertion
+void assert_lower(int condition) {
+    if (condition) return;
+    fprintf(stderr, "Error: fail to lower into ir\n");
+    exit(1);
+}
@@ -0,0 +1,16 @@
+#ifndef _LOWER_H_
+#define _LOWER_H_
+
+
+#include <stdio.h>
+#include "ir.h"
+#include "../common/option.h"
+#include "../parser/ast.h"
+
+
+IrModule* lower_astlist(AstList* astlist, int vector_width);
+IrFunction* lower_function_definition(Ast* ast, int vector_width);
+void print_ir(FILE* file_ptr, AstList* astlist, Option* option);
+
+
+#endif  // _LOWER_H_
@@ -0,0 +1,103 @@
+#include "optimize.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "cse.h"
+#include "induction.h"
+#include "inline.h"
+#include "licm.h"
+#include "sccp.h"
+#include "ssa.h"
+#include "strength.h"
+#include "tailrec.h"
+#include "../common/memory.h"
+
+
+// dead-inst-eliminator
+void eliminate_dead_insts(IrFunction* func);
+void mark_live_inst(IrInst* inst, IrInst** def_insts, char* live_insts, Vector* worklist);
+
+
+void optimize_ir_module(IrModule* module, Option* option) {
+    if (option->opt_level < 2) return;
+
+    size_t i = 0, size = module->functions->size;
+    for (i = 0; i < size; i++) {
+        eliminate_tail_recursion((IrFunction*)vector_at(module->functions, i));
+    }
+    inline_functions(module, option->inline_threshold, option->inline_report ? stderr : NULL);
+
+    for (i = 0; i < size; i++) {
+        IrFunction* func = (IrFunction*)vector_at(module->functions, i);
+        construct_ssa(func);
+        propagate_constants(func);
+        eliminate_common_subexprs(func);
+        reduce_strength(func);
+        hoist_loop_invariants(func, option->licm_report ? stderr : NULL);
+        reduce_induction_variables(func);
+        propagate_constants(func);
+        eliminate_dead_insts(func);
+        destruct_ssa(func);
+    }
+}
+
+// dead-inst-eliminator
+void eliminate_dead_insts(IrFunction* func) {
+    int num_vregs = func->num_vregs;
+    IrInst** def_insts = (IrInst**)safe_malloc((num_vregs + 1) * sizeof(IrInst*));
+    memset(def_insts, 0, (num_vregs + 1) * sizeof(IrInst*));
+
+    size_t i = 0, j = 0;
+    for (i = 0; i < func->blocks->size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            if (inst->dst >= 0) def_insts[inst->dst] = inst;
+        }
+    }
+
+    char* live_insts = (char*)safe_malloc((num_vregs + 1) * sizeof(char));
+    memset(live_insts, 0, num_vregs + 1);
+    Vector* worklist = vector_new();
+    for (i = 0; i < func->blocks->size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            if (ir_has_side_effects(inst->opcode)) mark_live_inst(inst, def_insts, live_insts, worklist);
+        }
+    }
+    while (worklist->size > 0) {
+        IrInst* inst = (IrInst*)vector_at(worklist, worklist->size - 1);
+        worklist->size--;
+        for (j = 0; j < inst->srcs->size; j++) {
+            IrOperand* src = ir_inst_nth_src(inst, j);
+            if (src->type != IR_OPERAND_VREG || def_insts[src->value] == NULL) continue;
+            mark_live_inst(def_insts[src->value], def_insts, live_insts, worklist);
+        }
+    }
+
+    for (i = 0; i < func->blocks->size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        j = 0;
+        while (j < block->insts->size) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            if (!ir_has_side_effects(inst->opcode) && (inst->dst < 0 || !live_insts[inst->dst])) {
+                ir_block_erase_inst(block, j);
+                continue;
+            }
+            j++;
+        }
+    }
+
+    vector_delete(worklist);
+    free(live_insts);
+    free(def_insts);
+}
+
+void mark_live_inst(IrInst* inst, IrInst** def_insts, char* live_insts, Vector* worklist) {
+    if (inst->dst >= 0) {
+        if (live_insts[inst->dst]) return;
+        live_insts[inst->dst] = 1;
+    }
+    vector_push_back(worklist, inst);
+}
@@ -0,0 +1,12 @@
+#ifndef _OPTIMIZE_H_
+#define _OPTIMIZE_H_
+
+
+#include "ir.h"
+#include "../common/option.h"
+
+
+void optimize_ir_module(IrModule* module, Option* option);
+
+
+#endif  // _OPTIMIZE_H_
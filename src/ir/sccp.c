@@ -0,0 +1,362 @@
+#include "sccp.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "../common/memory.h"
+
+
+typedef enum {
+    LATTICE_TOP,
+    LATTICE_CONST,
+    LATTICE_BOTTOM
+} LatticeState;
+
+typedef struct {
+    LatticeState state;
+    int value;
+} LatticeValue;
+
+typedef struct {
+    IrFunction* func;
+    LatticeValue* values;
+    char* executable_blocks;
+    char* executable_edges;
+} Sccp;
+
+
+// sccp
+Sccp* sccp_new(IrFunction* func);
+void sccp_delete(Sccp* sccp);
+
+// evaluator
+int visit_block(Sccp* sccp, IrBlock* block);
+LatticeValue evaluate_inst(Sccp* sccp, IrBlock* block, IrInst* inst);
+LatticeValue evaluate_phi(Sccp* sccp, IrBlock* block, IrInst* inst);
+LatticeValue evaluate_operation(IrInst* inst, LatticeValue* srcs);
+int fold_operation(IrOpcode opcode, int width, int lhs, int rhs, int* result);
+int visit_terminator(Sccp* sccp, IrBlock* block, IrInst* inst);
+int mark_edge_executable(Sccp* sccp, IrBlock* block, IrBlock* succ);
+
+// rewriter
+void rewrite_constants(Sccp* sccp);
+void rewrite_block_constants(Sccp* sccp, IrBlock* block);
+
+// lattice
+LatticeValue lattice_of_operand(Sccp* sccp, IrOperand* operand);
+LatticeValue lattice_meet(LatticeValue x, LatticeValue y);
+int lattice_lower(LatticeValue* dest, LatticeValue value);
+
+
+void propagate_constants(IrFunction* func) {
+    ir_function_compute_cfg(func);
+    Sccp* sccp = sccp_new(func);
+    sccp->executable_blocks[((IrBlock*)vector_at(func->blocks, 0))->id] = 1;
+
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        size_t i = 0, size = func->blocks->size;
+        for (i = 0; i < size; i++) {
+            IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+            if (sccp->executable_blocks[block->id]) changed |= visit_block(sccp, block);
+        }
+    }
+
+    rewrite_constants(sccp);
+    sccp_delete(sccp);
+    ir_function_remove_unreachable_blocks(func);
+}
+
+// sccp
+Sccp* sccp_new(IrFunction* func) {
+    Sccp* sccp = (Sccp*)safe_malloc(sizeof(Sccp));
+    int num_vregs = func->num_vregs, num_blocks = func->num_blocks;
+    sccp->func = func;
+    sccp->values = (LatticeValue*)safe_malloc((num_vregs + 1) * sizeof(LatticeValue));
+    sccp->executable_blocks = (char*)safe_malloc(num_blocks * sizeof(char));
+    sccp->executable_edges = (char*)safe_malloc(num_blocks * num_blocks * sizeof(char));
+    memset(sccp->executable_blocks, 0, num_blocks);
+    memset(sccp->executable_edges, 0, num_blocks * num_blocks);
+
+    int i = 0;
+    for (i = 0; i < num_vregs; i++) {
+        sccp->values[i].state = LATTICE_TOP;
+        sccp->values[i].value = 0;
+    }
+    return sccp;
+}
+
+void sccp_delete(Sccp* sccp) {
+    if (sccp == NULL) return;
+
+    free(sccp->values);
+    free(sccp->executable_blocks);
+    free(sccp->executable_edges);
+    free(sccp);
+}
+
+// evaluator
+int visit_block(Sccp* sccp, IrBlock* block) {
+    int changed = 0;
+    size_t i = 0, size = block->insts->size;
+    for (i = 0; i < size; i++) {
+        IrInst* inst = (IrInst*)vector_at(block->insts, i);
+        if (ir_is_terminator(inst->opcode)) {
+            changed |= visit_terminator(sccp, block, inst);
+        } else if (inst->dst >= 0) {
+            changed |= lattice_lower(&sccp->values[inst->dst], evaluate_inst(sccp, block, inst));
+        }
+    }
+    return changed;
+}
+
+LatticeValue evaluate_inst(Sccp* sccp, IrBlock* block, IrInst* inst) {
+    LatticeValue bottom = { LATTICE_BOTTOM, 0 };
+    LatticeValue srcs[2];
+
+    switch (inst->opcode) {
+        case IR_PHI:
+            return evaluate_phi(sccp, block, inst);
+        case IR_MOV:
+            return lattice_of_operand(sccp, ir_inst_nth_src(inst, 0));
+        default:
+            break;
+    }
+    if (!ir_is_unary_op(inst->opcode) && !ir_is_binary_op(inst->opcode) && !ir_is_comparison(inst->opcode)) {
+        return bottom;
+    }
+
+    size_t i = 0, size = inst->srcs->size;
+    for (i = 0; i < size; i++) {
+        srcs[i] = lattice_of_operand(sccp, ir_inst_nth_src(inst, i));
+    }
+    return evaluate_operation(inst, srcs);
+}
+
+LatticeValue evaluate_phi(Sccp* sccp, IrBlock* block, IrInst* inst) {
+    LatticeValue value = { LATTICE_TOP, 0 };
+    int num_blocks = sccp->func->num_blocks;
+    size_t i = 0, size = inst->srcs->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* pred = (IrBlock*)vector_at(inst->phi_blocks, i);
+        if (!sccp->executable_edges[pred->id * num_blocks + block->id]) continue;
+        value = lattice_meet(value, lattice_of_operand(sccp, ir_inst_nth_src(inst, i)));
+    }
+    return value;
+}
+
+LatticeValue evaluate_operation(IrInst* inst, LatticeValue* srcs) {
+    LatticeValue value = { LATTICE_BOTTOM, 0 };
+    size_t i = 0, size = inst->srcs->size;
+    for (i = 0; i < size; i++) {
+        if (srcs[i].state == LATTICE_TOP) value.state = LATTICE_TOP;
+    }
+    if (value.state == LATTICE_TOP) return value;
+
+    if (
+        (inst->opcode == IR_MUL || inst->opcode == IR_AND) &&
+        ((srcs[0].state == LATTICE_CONST && srcs[0].value == 0) ||
+         (srcs[1].state == LATTICE_CONST && srcs[1].value == 0))
+    ) {
+        value.state = LATTICE_CONST;
+        value.value = 0;
+        return value;
+    }
+
+    for (i = 0; i < size; i++) {
+        if (srcs[i].state == LATTICE_BOTTOM) return value;
+    }
+    int rhs = size > 1 ? srcs[1].value : 0;
+    if (fold_operation(inst->opcode, inst->width, srcs[0].value, rhs, &value.value)) {
+        value.state = LATTICE_CONST;
+    }
+    return value;
+}
+
+int fold_operation(IrOpcode opcode, int width, int lhs, int rhs, int* result) {
+    long long wide_lhs = lhs, wide_rhs = rhs, wide_result = 0;
+    unsigned int unsigned_lhs = lhs, unsigned_rhs = rhs;
+
+    if (width == 8) {
+        switch (opcode) {
+            case IR_ADD:
+                wide_result = wide_lhs + wide_rhs;
+                break;
+            case IR_SUB:
+                wide_result = wide_lhs - wide_rhs;
+                break;
+            case IR_MUL:
+                wide_result = wide_lhs * wide_rhs;
+                break;
+            case IR_SEXT32:
+                wide_result = wide_lhs;
+                break;
+            case IR_SHL:
+                if (rhs < 0 || rhs >= 32) return 0;
+                wide_result = wide_lhs * (1LL << rhs);
+                break;
+            case IR_SAR:
+                if (rhs < 0 || rhs >= 64) return 0;
+                wide_result = wide_lhs >> rhs;
+                break;
+            default:
+                if (!ir_is_comparison(opcode)) return 0;
+                break;
+        }
+        if (!ir_is_comparison(opcode)) {
+            if (wide_result != (int)wide_result) return 0;
+            *result = (int)wide_result;
+            return 1;
+        }
+    }
+
+    switch (opcode) {
+        case IR_NEG:
+            *result = (int)(0u - unsigned_lhs);
+            return 1;
+        case IR_NOT:
+            *result = ~lhs;
+            return 1;
+        case IR_SEXT8:
+            *result = (signed char)lhs;
+            return 1;
+        case IR_SEXT32:
+            *result = lhs;
+            return 1;
+        case IR_ADD:
+            *result = (int)(unsigned_lhs + unsigned_rhs);
+            return 1;
+        case IR_SUB:
+            *result = (int)(unsigned_lhs - unsigned_rhs);
+            return 1;
+        case IR_MUL:
+            *result = (int)(unsigned_lhs * unsigned_rhs);
+            return 1;
+        case IR_DIV:
+        case IR_MOD:
+            if (rhs == 0 || (lhs == -2147483647 - 1 && rhs == -1)) return 0;
+            *result = opcode == IR_DIV ? lhs / rhs : lhs % rhs;
+            return 1;
+        case IR_SHL:
+            *result = (int)(unsigned_lhs << (unsigned_rhs & 31));
+            return 1;
+        case IR_SAR:
+            *result = lhs < 0 ? ~(~lhs >> (unsigned_rhs & 31)) : lhs >> (unsigned_rhs & 31);
+            return 1;
+        case IR_AND:
+            *result = lhs & rhs;
+            return 1;
+        case IR_XOR:
+            *result = lhs ^ rhs;
+            return 1;
+        case IR_OR:
+            *result = lhs | rhs;
+            return 1;
+        case IR_EQ:
+            *result = lhs == rhs;
+            return 1;
+        case IR_NE:
+            *result = lhs != rhs;
+            return 1;
+        case IR_LT:
+            *result = lhs < rhs;
+            return 1;
+        case IR_GT:
+            *result = lhs > rhs;
+            return 1;
+        case IR_LE:
+            *result = lhs <= rhs;
+            return 1;
+        case IR_GE:
+            *result = lhs >= rhs;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+int visit_terminator(Sccp* sccp, IrBlock* block, IrInst* inst) {
+    int changed = 0;
+    switch (inst->opcode) {
+        case IR_JMP:
+            changed |= mark_edge_executable(sccp, block, inst->targets[0]);
+            break;
+        case IR_BR: {
+            LatticeValue cond = lattice_of_operand(sccp, ir_inst_nth_src(inst, 0));
+            if (cond.state == LATTICE_TOP) break;
+            if (cond.state == LATTICE_BOTTOM || cond.value != 0) {
+                changed |= mark_edge_executable(sccp, block, inst->targets[0]);
+            }
+            if (cond.state == LATTICE_BOTTOM || cond.value == 0) {
+                changed |= mark_edge_executable(sccp, block, inst->targets[1]);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return changed;
+}
+
+int mark_edge_executable(Sccp* sccp, IrBlock* block, IrBlock* succ) {
+    char* edge = &sccp->executable_edges[block->id * sccp->func->num_blocks + succ->id];
+    if (*edge) return 0;
+    *edge = 1;
+    sccp->executable_blocks[succ->id] = 1;
+    return 1;
+}
+
+// rewriter
+void rewrite_constants(Sccp* sccp) {
+    size_t i = 0, size = sccp->func->blocks->size;
+    for (i = 0; i < size; i++) {
+        rewrite_block_constants(sccp, (IrBlock*)vector_at(sccp->func->blocks, i));
+    }
+}
+
+void rewrite_block_constants(Sccp* sccp, IrBlock* block) {
+    size_t i = 0, j = 0;
+    while (i < block->insts->size) {
+        IrInst* inst = (IrInst*)vector_at(block->insts, i);
+        for (j = 0; j < inst->srcs->size; j++) {
+            LatticeValue value = lattice_of_operand(sccp, ir_inst_nth_src(inst, j));
+            if (value.state != LATTICE_CONST) continue;
+            ir_inst_replace_nth_src(inst, j, ir_operand_new_imm(value.value));
+        }
+
+        if (inst->dst >= 0 && sccp->values[inst->dst].state == LATTICE_CONST && !ir_has_side_effects(inst->opcode)) {
+            ir_block_erase_inst(block, i);
+            continue;
+        }
+        if (inst->opcode == IR_BR && ir_inst_nth_src(inst, 0)->type == IR_OPERAND_IMM) {
+            IrBlock* target = ir_inst_nth_src(inst, 0)->value != 0 ? inst->targets[0] : inst->targets[1];
+            IrInst* jump = ir_inst_new(IR_JMP, 0, -1, 0);
+            jump->targets[0] = target;
+            ir_block_erase_inst(block, i);
+            ir_block_insert_inst(block, i, jump);
+        }
+        i++;
+    }
+}
+
+// lattice
+LatticeValue lattice_of_operand(Sccp* sccp, IrOperand* operand) {
+    LatticeValue value = { LATTICE_CONST, operand->value };
+    if (operand->type == IR_OPERAND_VREG) value = sccp->values[operand->value];
+    return value;
+}
+
+LatticeValue lattice_meet(LatticeValue x, LatticeValue y) {
+    if (x.state == LATTICE_TOP) return y;
+    if (y.state == LATTICE_TOP) return x;
+    if (x.state == LATTICE_CONST && y.state == LATTICE_CONST && x.value == y.value) return x;
+    x.state = LATTICE_BOTTOM;
+    return x;
+}
+
+int lattice_lower(LatticeValue* dest, LatticeValue value) {
+    LatticeValue lowered = lattice_meet(*dest, value);
+    if (lowered.state == dest->state && lowered.value == dest->value) return 0;
+    *dest = lowered;
+    return 1;
+}
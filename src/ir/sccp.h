@@ -0,0 +1,11 @@
+#ifndef _SCCP_H_
+#define _SCCP_H_
+
+
+#include "ir.h"
+
+
+void propagate_constants(IrFunction* func);
+
+
+#endif  // _SCCP_H_
@@ -0,0 +1,518 @@
+#include "ssa.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "dominance.h"
+#include "liveness.h"
+#include "../common/memory.h"
+
+
+typedef struct {
+    int width;
+    int size;
+    Vector* def_blocks;
+    Vector* stack;
+} SsaVariable;
+
+typedef struct {
+    IrFunction* func;
+    Dominance* dominance;
+    Vector* variables;
+    int* variable_of_slot;
+    int* variable_of_addr;
+    int* variable_of_vreg;
+    int num_orig_vregs;
+    Vector* phi_variables;
+    int phi_vreg_base;
+    IrOperand** replacements;
+} SsaBuilder;
+
+
+// ssa-builder
+SsaBuilder* ssa_builder_new(IrFunction* func);
+void ssa_builder_delete(SsaBuilder* builder);
+
+// ssa-variable
+SsaVariable* ssa_variable_new(int width, int size);
+void ssa_variable_delete(SsaVariable* variable);
+int ssa_variable_add_def_block(SsaVariable* variable, IrBlock* block);
+IrOperand* ssa_variable_current_value(SsaVariable* variable);
+
+// variable-collector
+void collect_slot_variables(SsaBuilder* builder);
+void collect_vreg_variables(SsaBuilder* builder);
+void collect_def_blocks(SsaBuilder* builder);
+
+// phi-inserter
+void insert_phis(SsaBuilder* builder);
+void insert_phis_for_variable(SsaBuilder* builder, int variable_index);
+
+// renamer
+void rename_block(SsaBuilder* builder, IrBlock* block);
+int rename_inst(SsaBuilder* builder, IrBlock* block, size_t index, Vector* pushed);
+void rename_srcs(SsaBuilder* builder, IrInst* inst);
+void fill_phi_srcs(SsaBuilder* builder, IrBlock* block, IrBlock* succ);
+void push_value(SsaBuilder* builder, int variable_index, IrOperand* value, Vector* pushed);
+
+// ssa-destructor
+void destruct_block_phis(IrFunction* func, IrBlock* block, Liveness* liveness);
+int can_copy_before_branch(IrBlock* block, IrBlock* pred, Liveness* liveness);
+IrBlock* split_edge(IrFunction* func, IrBlock* pred, IrBlock* succ);
+void insert_phi_copies(IrFunction* func, IrBlock* block, IrBlock* pred, IrBlock* copy_block);
+int is_phi_dst(IrBlock* block, IrOperand* operand);
+
+
+void construct_ssa(IrFunction* func) {
+    ir_function_remove_unreachable_blocks(func);
+    SsaBuilder* builder = ssa_builder_new(func);
+    collect_slot_variables(builder);
+    collect_vreg_variables(builder);
+    collect_def_blocks(builder);
+    insert_phis(builder);
+    rename_block(builder, (IrBlock*)vector_at(func->blocks, 0));
+    ssa_builder_delete(builder);
+}
+
+void destruct_ssa(IrFunction* func) {
+    ir_function_compute_cfg(func);
+    Liveness* liveness = liveness_new(func);
+    size_t i = 0, size = func->blocks->size;
+    for (i = 0; i < size; i++) {
+        destruct_block_phis(func, (IrBlock*)vector_at(func->blocks, i), liveness);
+    }
+    liveness_delete(liveness);
+    ir_function_compute_cfg(func);
+}
+
+// ssa-builder
+SsaBuilder* ssa_builder_new(IrFunction* func) {
+    SsaBuilder* builder = (SsaBuilder*)safe_malloc(sizeof(SsaBuilder));
+    builder->func = func;
+    builder->dominance = dominance_new(func);
+    builder->variables = vector_new();
+
+    int i = 0, num_slots = func->stack_offset + 1, num_vregs = func->num_vregs;
+    builder->variable_of_slot = (int*)safe_malloc(num_slots * sizeof(int));
+    for (i = 0; i < num_slots; i++) {
+        builder->variable_of_slot[i] = -1;
+    }
+    builder->variable_of_addr = (int*)safe_malloc((num_vregs + 1) * sizeof(int));
+    builder->variable_of_vreg = (int*)safe_malloc((num_vregs + 1) * sizeof(int));
+    builder->replacements = (IrOperand**)safe_malloc((num_vregs + 1) * sizeof(IrOperand*));
+    for (i = 0; i < num_vregs; i++) {
+        builder->variable_of_addr[i] = -1;
+        builder->variable_of_vreg[i] = -1;
+        builder->replacements[i] = NULL;
+    }
+    builder->num_orig_vregs = num_vregs;
+    builder->phi_variables = vector_new();
+    builder->phi_vreg_base = num_vregs;
+    return builder;
+}
+
+void ssa_builder_delete(SsaBuilder* builder) {
+    if (builder == NULL) return;
+
+    size_t i = 0, size = builder->variables->size;
+    for (i = 0; i < size; i++) {
+        ssa_variable_delete((SsaVariable*)vector_at(builder->variables, i));
+        builder->variables->data[i] = NULL;
+    }
+    vector_delete(builder->variables);
+    for (i = 0; i < (size_t)builder->num_orig_vregs; i++) {
+        free(builder->replacements[i]);
+    }
+    free(builder->replacements);
+    free(builder->variable_of_slot);
+    free(builder->variable_of_addr);
+    free(builder->variable_of_vreg);
+    vector_delete(builder->phi_variables);
+    dominance_delete(builder->dominance);
+    free(builder);
+}
+
+// ssa-variable
+SsaVariable* ssa_variable_new(int width, int size) {
+    SsaVariable* variable = (SsaVariable*)safe_malloc(sizeof(SsaVariable));
+    variable->width = width;
+    variable->size = size;
+    variable->def_blocks = vector_new();
+    variable->stack = vector_new();
+    return variable;
+}
+
+void ssa_variable_delete(SsaVariable* variable) {
+    if (variable == NULL) return;
+
+    free(variable->def_blocks->data);
+    free(variable->def_blocks);
+    vector_delete(variable->stack);
+    free(variable);
+}
+
+int ssa_variable_add_def_block(SsaVariable* variable, IrBlock* block) {
+    size_t i = 0, size = variable->def_blocks->size;
+    for (i = 0; i < size; i++) {
+        if (vector_at(variable->def_blocks, i) == block) return 0;
+    }
+    vector_push_back(variable->def_blocks, block);
+    return 1;
+}
+
+IrOperand* ssa_variable_current_value(SsaVariable* variable) {
+    if (variable->stack->size == 0) return ir_operand_new_imm(0);
+    return ir_operand_copy((IrOperand*)vector_at(variable->stack, variable->stack->size - 1));
+}
+
+// variable-collector
+void collect_slot_variables(SsaBuilder* builder) {
+    IrFunction* func = builder->func;
+    int num_slots = func->stack_offset + 1;
+    int* slot_sizes = (int*)safe_malloc(num_slots * sizeof(int));
+    int* slot_of_addr = (int*)safe_malloc((func->num_vregs + 1) * sizeof(int));
+    int i = 0;
+    for (i = 0; i < num_slots; i++) {
+        slot_sizes[i] = 0;
+    }
+    for (i = 0; i < func->num_vregs; i++) {
+        slot_of_addr[i] = -1;
+    }
+
+    size_t j = 0, k = 0, l = 0, num_blocks = func->blocks->size;
+    for (j = 0; j < num_blocks; j++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, j);
+        for (k = 0; k < block->insts->size; k++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, k);
+            if (inst->opcode != IR_LOCAL_ADDR) continue;
+            slot_of_addr[inst->dst] = inst->stack_index;
+            if (inst->symbol == NULL) slot_sizes[inst->stack_index] = -1;
+        }
+    }
+
+    for (j = 0; j < num_blocks; j++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, j);
+        for (k = 0; k < block->insts->size; k++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, k);
+            for (l = 0; l < inst->srcs->size; l++) {
+                IrOperand* src = ir_inst_nth_src(inst, l);
+                if (src->type != IR_OPERAND_VREG || slot_of_addr[src->value] < 0) continue;
+                int slot = slot_of_addr[src->value];
+                int is_access = l == 0 && (inst->opcode == IR_LOAD || inst->opcode == IR_STORE);
+                if (!is_access || (slot_sizes[slot] != 0 && slot_sizes[slot] != inst->width)) {
+                    slot_sizes[slot] = -1;
+                } else {
+                    slot_sizes[slot] = inst->width;
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < num_slots; i++) {
+        if (slot_sizes[i] <= 0) continue;
+        builder->variable_of_slot[i] = builder->variables->size;
+        vector_push_back(builder->variables, ssa_variable_new(slot_sizes[i] == 8 ? 8 : 4, slot_sizes[i]));
+    }
+    for (i = 0; i < func->num_vregs; i++) {
+        if (slot_of_addr[i] < 0) continue;
+        builder->variable_of_addr[i] = builder->variable_of_slot[slot_of_addr[i]];
+    }
+    free(slot_sizes);
+    free(slot_of_addr);
+}
+
+void collect_vreg_variables(SsaBuilder* builder) {
+    IrFunction* func = builder->func;
+    int* def_counts = (int*)safe_malloc((func->num_vregs + 1) * sizeof(int));
+    int* widths = (int*)safe_malloc((func->num_vregs + 1) * sizeof(int));
+    int i = 0;
+    for (i = 0; i < func->num_vregs; i++) {
+        def_counts[i] = 0;
+    }
+
+    size_t j = 0, k = 0, num_blocks = func->blocks->size;
+    for (j = 0; j < num_blocks; j++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, j);
+        for (k = 0; k < block->insts->size; k++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, k);
+            if (inst->dst < 0) continue;
+            def_counts[inst->dst]++;
+            widths[inst->dst] = inst->width;
+        }
+    }
+
+    for (i = 0; i < func->num_vregs; i++) {
+        if (def_counts[i] < 2) continue;
+        builder->variable_of_vreg[i] = builder->variables->size;
+        vector_push_back(builder->variables, ssa_variable_new(widths[i], 0));
+    }
+    free(def_counts);
+    free(widths);
+}
+
+void collect_def_blocks(SsaBuilder* builder) {
+    IrFunction* func = builder->func;
+    size_t i = 0, j = 0, num_blocks = func->blocks->size;
+    for (i = 0; i < num_blocks; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* inst = (IrInst*)vector_at(block->insts, j);
+            int variable_index = -1;
+            if (inst->opcode == IR_STORE) {
+                IrOperand* address = ir_inst_nth_src(inst, 0);
+                if (address->type == IR_OPERAND_VREG) {
+                    variable_index = builder->variable_of_addr[address->value];
+                }
+            } else if (inst->dst >= 0) {
+                variable_index = builder->variable_of_vreg[inst->dst];
+            }
+            if (variable_index < 0) continue;
+            SsaVariable* variable = (SsaVariable*)vector_at(builder->variables, variable_index);
+            ssa_variable_add_def_block(variable, block);
+        }
+    }
+}
+
+// phi-inserter
+void insert_phis(SsaBuilder* builder) {
+    size_t i = 0, size = builder->variables->size;
+    for (i = 0; i < size; i++) {
+        insert_phis_for_variable(builder, i);
+    }
+}
+
+void insert_phis_for_variable(SsaBuilder* builder, int variable_index) {
+    SsaVariable* variable = (SsaVariable*)vector_at(builder->variables, variable_index);
+    Dominance* dominance = builder->dominance;
+    char* has_phi = (char*)safe_malloc(builder->func->num_blocks * sizeof(char));
+    memset(has_phi, 0, builder->func->num_blocks);
+
+    size_t i = 0, j = 0;
+    for (i = 0; i < variable->def_blocks->size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(variable->def_blocks, i);
+        Vector* frontier = dominance->frontier[block->id];
+        for (j = 0; j < frontier->size; j++) {
+            IrBlock* frontier_block = (IrBlock*)vector_at(frontier, j);
+            if (has_phi[frontier_block->id]) continue;
+            has_phi[frontier_block->id] = 1;
+            int dst = ir_function_create_vreg(builder->func);
+            ir_block_insert_inst(frontier_block, 0, ir_inst_new(IR_PHI, variable->width, dst, 0));
+            vector_push_back(builder->phi_variables, int_new(variable_index));
+            ssa_variable_add_def_block(variable, frontier_block);
+        }
+    }
+    free(has_phi);
+}
+
+// renamer
+void rename_block(SsaBuilder* builder, IrBlock* block) {
+    Vector* pushed = vector_new();
+
+    size_t i = 0;
+    while (i < block->insts->size) {
+        i += rename_inst(builder, block, i, pushed);
+    }
+    for (i = 0; i < block->succs->size; i++) {
+        fill_phi_srcs(builder, block, (IrBlock*)vector_at(block->succs, i));
+    }
+
+    Vector* children = builder->dominance->children[block->id];
+    for (i = 0; i < children->size; i++) {
+        rename_block(builder, (IrBlock*)vector_at(children, i));
+    }
+
+    for (i = 0; i < pushed->size; i++) {
+        int variable_index = *(int*)vector_at(pushed, i);
+        SsaVariable* variable = (SsaVariable*)vector_at(builder->variables, variable_index);
+        size_t top = variable->stack->size - 1;
+        free(vector_at(variable->stack, top));
+        vector_erase(variable->stack, top);
+    }
+    vector_delete(pushed);
+}
+
+int rename_inst(SsaBuilder* builder, IrBlock* block, size_t index, Vector* pushed) {
+    IrInst* inst = (IrInst*)vector_at(block->insts, index);
+    if (inst->opcode == IR_PHI) {
+        int variable_index = *(int*)vector_at(builder->phi_variables, inst->dst - builder->phi_vreg_base);
+        push_value(builder, variable_index, ir_operand_new_vreg(inst->dst), pushed);
+        return 1;
+    }
+
+    rename_srcs(builder, inst);
+    IrOperand* address = inst->srcs->size > 0 ? ir_inst_nth_src(inst, 0) : NULL;
+    int variable_index = -1;
+    if (address != NULL && address->type == IR_OPERAND_VREG && address->value < builder->num_orig_vregs) {
+        variable_index = builder->variable_of_addr[address->value];
+    }
+
+    switch (inst->opcode) {
+        case IR_LOCAL_ADDR:
+            if (builder->variable_of_addr[inst->dst] < 0) return 1;
+            ir_block_erase_inst(block, index);
+            return 0;
+        case IR_LOAD:
+            if (variable_index < 0) break;
+            builder->replacements[inst->dst] = ssa_variable_current_value(
+                (SsaVariable*)vector_at(builder->variables, variable_index)
+            );
+            ir_block_erase_inst(block, index);
+            return 0;
+        case IR_STORE: {
+            if (variable_index < 0) break;
+            IrOperand* value = ir_operand_copy(ir_inst_nth_src(inst, 1));
+            SsaVariable* variable = (SsaVariable*)vector_at(builder->variables, variable_index);
+            ir_block_erase_inst(block, index);
+            if (variable->size != 1) {
+                push_value(builder, variable_index, value, pushed);
+                return 0;
+            }
+            int dst = ir_function_create_vreg(builder->func);
+            ir_block_insert_inst(block, index, ir_inst_new(IR_SEXT8, 4, dst, 1, value));
+            push_value(builder, variable_index, ir_operand_new_vreg(dst), pushed);
+            return 1;
+        }
+        default:
+            break;
+    }
+
+    if (inst->dst < 0 || inst->dst >= builder->num_orig_vregs) return 1;
+    variable_index = builder->variable_of_vreg[inst->dst];
+    if (variable_index < 0) return 1;
+    if (inst->opcode == IR_MOV) {
+        push_value(builder, variable_index, ir_operand_copy(ir_inst_nth_src(inst, 0)), pushed);
+        ir_block_erase_inst(block, index);
+        return 0;
+    }
+    inst->dst = ir_function_create_vreg(builder->func);
+    push_value(builder, variable_index, ir_operand_new_vreg(inst->dst), pushed);
+    return 1;
+}
+
+void rename_srcs(SsaBuilder* builder, IrInst* inst) {
+    size_t i = 0, size = inst->srcs->size;
+    for (i = 0; i < size; i++) {
+        IrOperand* src = ir_inst_nth_src(inst, i);
+        if (src->type != IR_OPERAND_VREG || src->value >= builder->num_orig_vregs) continue;
+        int variable_index = builder->variable_of_vreg[src->value];
+        if (variable_index >= 0) {
+            SsaVariable* variable = (SsaVariable*)vector_at(builder->variables, variable_index);
+            ir_inst_replace_nth_src(inst, i, ssa_variable_current_value(variable));
+        } else if (builder->replacements[src->value] != NULL) {
+            ir_inst_replace_nth_src(inst, i, ir_operand_copy(builder->replacements[src->value]));
+        }
+    }
+}
+
+void fill_phi_srcs(SsaBuilder* builder, IrBlock* block, IrBlock* succ) {
+    size_t i = 0, size = succ->insts->size;
+    for (i = 0; i < size; i++) {
+        IrInst* inst = (IrInst*)vector_at(succ->insts, i);
+        if (inst->opcode != IR_PHI) break;
+        int variable_index = *(int*)vector_at(builder->phi_variables, inst->dst - builder->phi_vreg_base);
+        SsaVariable* variable = (SsaVariable*)vector_at(builder->variables, variable_index);
+        ir_inst_append_phi_src(inst, ssa_variable_current_value(variable), block);
+    }
+}
+
+void push_value(SsaBuilder* builder, int variable_index, IrOperand* value, Vector* pushed) {
+    SsaVariable* variable = (SsaVariable*)vector_at(builder->variables, variable_index);
+    vector_push_back(variable->stack, value);
+    vector_push_back(pushed, int_new(variable_index));
+}
+
+// ssa-destructor
+void destruct_block_phis(IrFunction* func, IrBlock* block, Liveness* liveness) {
+    IrInst* first = (IrInst*)vector_at(block->insts, 0);
+    if (first == NULL || first->opcode != IR_PHI) return;
+
+    size_t i = 0, num_preds = block->preds->size;
+    for (i = 0; i < num_preds; i++) {
+        IrBlock* pred = (IrBlock*)vector_at(block->preds, i);
+        IrBlock* copy_block = pred;
+        if (pred->succs->size > 1 && !can_copy_before_branch(block, pred, liveness)) {
+            copy_block = split_edge(func, pred, block);
+        }
+        insert_phi_copies(func, block, pred, copy_block);
+    }
+
+    while (block->insts->size > 0) {
+        IrInst* inst = (IrInst*)vector_at(block->insts, 0);
+        if (inst->opcode != IR_PHI) break;
+        ir_block_erase_inst(block, 0);
+    }
+}
+
+int can_copy_before_branch(IrBlock* block, IrBlock* pred, Liveness* liveness) {
+    IrInst* terminator = ir_block_terminator(pred);
+    size_t i = 0, j = 0;
+    for (i = 0; i < terminator->srcs->size; i++) {
+        if (is_phi_dst(block, ir_inst_nth_src(terminator, i))) return 0;
+    }
+
+    for (i = 0; i < pred->succs->size; i++) {
+        IrBlock* succ = (IrBlock*)vector_at(pred->succs, i);
+        if (succ == block) continue;
+        for (j = 0; j < block->insts->size; j++) {
+            IrInst* phi = (IrInst*)vector_at(block->insts, j);
+            if (phi->opcode != IR_PHI) break;
+            if (liveness_is_live_in(liveness, succ, phi->dst)) return 0;
+        }
+    }
+    return 1;
+}
+
+IrBlock* split_edge(IrFunction* func, IrBlock* pred, IrBlock* succ) {
+    IrBlock* block = ir_function_create_block(func);
+    IrInst* jump = ir_inst_new(IR_JMP, 0, -1, 0);
+    jump->targets[0] = succ;
+    ir_block_append_inst(block, jump);
+
+    IrInst* terminator = ir_block_terminator(pred);
+    int i = 0;
+    for (i = 0; i < 2; i++) {
+        if (terminator->targets[i] == succ) terminator->targets[i] = block;
+    }
+    return block;
+}
+
+void insert_phi_copies(IrFunction* func, IrBlock* block, IrBlock* pred, IrBlock* copy_block) {
+    size_t position = copy_block->insts->size - 1;
+    Vector* copies = vector_new();
+
+    size_t i = 0, j = 0, size = block->insts->size;
+    for (i = 0; i < size; i++) {
+        IrInst* phi = (IrInst*)vector_at(block->insts, i);
+        if (phi->opcode != IR_PHI) break;
+        for (j = 0; j < phi->phi_blocks->size; j++) {
+            if (vector_at(phi->phi_blocks, j) == pred) break;
+        }
+        IrOperand* src = ir_operand_copy(ir_inst_nth_src(phi, j));
+        if (src->type == IR_OPERAND_VREG && src->value == phi->dst) {
+            free(src);
+            continue;
+        }
+        if (is_phi_dst(block, src)) {
+            int temp = ir_function_create_vreg(func);
+            ir_block_insert_inst(copy_block, position++, ir_inst_new(IR_MOV, phi->width, temp, 1, src));
+            src = ir_operand_new_vreg(temp);
+        }
+        vector_push_back(copies, ir_inst_new(IR_MOV, phi->width, phi->dst, 1, src));
+    }
+
+    for (i = 0; i < copies->size; i++) {
+        ir_block_insert_inst(copy_block, position++, (IrInst*)vector_at(copies, i));
+        copies->data[i] = NULL;
+    }
+    vector_delete(copies);
+}
+
+int is_phi_dst(IrBlock* block, IrOperand* operand) {
+    if (operand->type != IR_OPERAND_VREG) return 0;
+    size_t i = 0, size = block->insts->size;
+    for (i = 0; i < size; i++) {
+        IrInst* inst = (IrInst*)vector_at(block->insts, i);
+        if (inst->opcode != IR_PHI) break;
+        if (inst->dst == operand->value) return 1;
+    }
+    return 0;
+}
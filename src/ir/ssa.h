@@ -0,0 +1,12 @@
+#ifndef _SSA_H_
+#define _SSA_H_
+
+
+#include "ir.h"
+
+
+void construct_ssa(IrFunction* func);
+void destruct_ssa(IrFunction* func);
+
+
+#endif  // _SSA_H_
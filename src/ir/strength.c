@@ -0,0 +1,105 @@
+#include "strength.h"
+
+#include <stdlib.h>
+
+
+// strength-reducer
+void reduce_block_strength(IrBlock* block);
+IrInst* reduce_multiplication(IrInst* inst);
+IrInst* reduce_division(IrInst* inst);
+
+
+void reduce_strength(IrFunction* func) {
+    size_t i = 0, size = func->blocks->size;
+    for (i = 0; i < size; i++) {
+        reduce_block_strength((IrBlock*)vector_at(func->blocks, i));
+    }
+}
+
+int exact_log2(int value) {
+    if (value <= 0 || (value & (value - 1)) != 0) return -1;
+    int shift = 0;
+    while ((1 << shift) != value) shift++;
+    return shift;
+}
+
+int compute_division_magic(int divisor, int* magic, int* shift) {
+    if (divisor < 3 || exact_log2(divisor) >= 0) return 0;
+
+    unsigned int two31 = 0x80000000u;
+    unsigned int d = divisor;
+    unsigned int anc = two31 - 1 - two31 % d;
+    unsigned int q1 = two31 / anc, r1 = two31 - q1 * anc;
+    unsigned int q2 = two31 / d, r2 = two31 - q2 * d;
+    unsigned int delta = 0;
+    int p = 31;
+    do {
+        p++;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc) {
+            q1++;
+            r1 -= anc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= d) {
+            q2++;
+            r2 -= d;
+        }
+        delta = d - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+
+    *magic = (int)(q2 + 1);
+    *shift = p - 32;
+    return 1;
+}
+
+// strength-reducer
+void reduce_block_strength(IrBlock* block) {
+    size_t i = 0, size = block->insts->size;
+    for (i = 0; i < size; i++) {
+        IrInst* inst = (IrInst*)vector_at(block->insts, i);
+        IrInst* reduced = NULL;
+        switch (inst->opcode) {
+            case IR_MUL:
+                reduced = reduce_multiplication(inst);
+                break;
+            case IR_DIV:
+                reduced = reduce_division(inst);
+                break;
+            default:
+                break;
+        }
+        if (reduced == NULL) continue;
+        ir_block_erase_inst(block, i);
+        ir_block_insert_inst(block, i, reduced);
+    }
+}
+
+IrInst* reduce_multiplication(IrInst* inst) {
+    IrOperand* lhs = ir_inst_nth_src(inst, 0);
+    IrOperand* rhs = ir_inst_nth_src(inst, 1);
+    if (lhs->type == IR_OPERAND_IMM && rhs->type == IR_OPERAND_VREG) {
+        IrOperand* temp = lhs;
+        lhs = rhs;
+        rhs = temp;
+    }
+    if (lhs->type != IR_OPERAND_VREG || rhs->type != IR_OPERAND_IMM) return NULL;
+
+    int width = inst->width, dst = inst->dst;
+    if (rhs->value == 0)  return ir_inst_new(IR_MOV, width, dst, 1, ir_operand_new_imm(0));
+    if (rhs->value == 1)  return ir_inst_new(IR_MOV, width, dst, 1, ir_operand_copy(lhs));
+    if (rhs->value == -1) return ir_inst_new(IR_NEG, width, dst, 1, ir_operand_copy(lhs));
+
+    int shift = exact_log2(rhs->value);
+    if (shift < 0) return NULL;
+    return ir_inst_new(IR_SHL, width, dst, 2, ir_operand_copy(lhs), ir_operand_new_imm(shift));
+}
+
+IrInst* reduce_division(IrInst* inst) {
+    IrOperand* lhs = ir_inst_nth_src(inst, 0);
+    IrOperand* rhs = ir_inst_nth_src(inst, 1);
+    if (rhs->type != IR_OPERAND_IMM || rhs->value != 1) return NULL;
+    return ir_inst_new(IR_MOV, inst->width, inst->dst, 1, ir_operand_copy(lhs));
+}
@@ -0,0 +1,13 @@
+#ifndef _STRENGTH_H_
+#define _STRENGTH_H_
+
+
+#include "ir.h"
+
+
+void reduce_strength(IrFunction* func);
+int exact_log2(int value);
+int compute_division_magic(int divisor, int* magic, int* shift);
+
+
+#endif  // _STRENGTH_H_
@@ -0,0 +1,112 @@
+#include "tailrec.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "../common/memory.h"
+
+
+#define MAX_ARGS 6
+
+
+// tail-recursion
+int is_self_tail_call(IrFunction* func, IrBlock* block, int num_args);
+IrBlock* split_entry_block(IrFunction* func, IrInst** arg_insts);
+void rewrite_tail_call(IrBlock* block, IrInst** arg_insts, IrBlock* body_block);
+int count_arg_insts(IrBlock* entry_block);
+
+
+void eliminate_tail_recursion(IrFunction* func) {
+    if (ir_function_has_escaping_locals(func)) return;
+
+    IrBlock* entry_block = (IrBlock*)vector_at(func->blocks, 0);
+    int num_args = count_arg_insts(entry_block);
+    Vector* tail_blocks = vector_new();
+    size_t i = 0, size = func->blocks->size;
+    for (i = 0; i < size; i++) {
+        IrBlock* block = (IrBlock*)vector_at(func->blocks, i);
+        if (is_self_tail_call(func, block, num_args)) vector_push_back(tail_blocks, block);
+    }
+
+    if (tail_blocks->size > 0) {
+        IrInst* arg_insts[MAX_ARGS] = { NULL };
+        IrBlock* body_block = split_entry_block(func, arg_insts);
+        for (i = 0; i < tail_blocks->size; i++) {
+            rewrite_tail_call((IrBlock*)vector_at(tail_blocks, i), arg_insts, body_block);
+        }
+        ir_function_compute_cfg(func);
+    }
+
+    tail_blocks->size = 0;
+    vector_delete(tail_blocks);
+}
+
+// tail-recursion
+int is_self_tail_call(IrFunction* func, IrBlock* block, int num_args) {
+    size_t size = block->insts->size;
+    if (size < 2) return 0;
+
+    IrInst* call = (IrInst*)vector_at(block->insts, size - 2);
+    IrInst* ret = (IrInst*)vector_at(block->insts, size - 1);
+    if (call->opcode != IR_CALL || ret->opcode != IR_RET || ret->srcs->size != 1) return 0;
+    if (strcmp(call->symbol, func->funcname) != 0 || (int)call->srcs->size != num_args) return 0;
+
+    IrOperand* value = ir_inst_nth_src(ret, 0);
+    return value->type == IR_OPERAND_VREG && value->value == call->dst;
+}
+
+IrBlock* split_entry_block(IrFunction* func, IrInst** arg_insts) {
+    IrBlock* entry_block = (IrBlock*)vector_at(func->blocks, 0);
+    IrBlock* body_block = ir_function_create_block_after(func, entry_block);
+
+    size_t i = 0, j = 0, size = entry_block->insts->size;
+    for (i = 0; i < size; i++) {
+        IrInst* inst = (IrInst*)vector_at(entry_block->insts, i);
+        if (inst->opcode != IR_ARG) {
+            ir_block_append_inst(body_block, inst);
+            continue;
+        }
+        arg_insts[ir_inst_nth_src(inst, 0)->value] = inst;
+        entry_block->insts->data[j++] = inst;
+    }
+    entry_block->insts->size = j;
+
+    IrInst* jump = ir_inst_new(IR_JMP, 0, -1, 0);
+    jump->targets[0] = body_block;
+    ir_block_append_inst(entry_block, jump);
+    return body_block;
+}
+
+void rewrite_tail_call(IrBlock* block, IrInst** arg_insts, IrBlock* body_block) {
+    size_t size = block->insts->size;
+    IrInst* call = (IrInst*)vector_at(block->insts, size - 2);
+    Vector* moves = vector_new();
+
+    size_t i = 0, num_args = call->srcs->size;
+    for (i = 0; i < num_args; i++) {
+        IrInst* arg = arg_insts[i];
+        IrOperand* value = ir_operand_copy(ir_inst_nth_src(call, i));
+        vector_push_back(moves, ir_inst_new(IR_MOV, arg->width, arg->dst, 1, value));
+    }
+    ir_block_erase_inst(block, size - 1);
+    ir_block_erase_inst(block, size - 2);
+
+    for (i = 0; i < moves->size; i++) {
+        ir_block_append_inst(block, (IrInst*)vector_at(moves, i));
+    }
+    IrInst* jump = ir_inst_new(IR_JMP, 0, -1, 0);
+    jump->targets[0] = body_block;
+    ir_block_append_inst(block, jump);
+
+    moves->size = 0;
+    vector_delete(moves);
+}
+
+int count_arg_insts(IrBlock* entry_block) {
+    int num_args = 0;
+    size_t i = 0, size = entry_block->insts->size;
+    for (i = 0; i < size; i++) {
+        IrInst* inst = (IrInst*)vector_at(entry_block->insts, i);
+        if (inst->opcode == IR_ARG) num_args++;
+    }
+    return num_args;
+}
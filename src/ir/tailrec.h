@@ -0,0 +1,11 @@
+#ifndef _TAILREC_H_
+#define _TAILREC_H_
+
+
+#include "ir.h"
+
+
+void eliminate_tail_recursion(IrFunction* func);
+
+
+#endif  // _TAILREC_H_
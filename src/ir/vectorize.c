@@ -0,0 +1,185 @@
+#include "vectorize.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "../common/memory.h"
+
+
+// loop-matcher
+int match_loop_header(Ast* ast, VectorLoop* loop, Ast* func_body, LocalTable* local_table);
+int match_loop_body(Ast* ast, VectorLoop* loop, Ast* func_body, LocalTable* local_table);
+int vector_expr_depth(Ast* ast, VectorLoop* loop, Ast* func_body, LocalTable* local_table);
+int is_vector_array_access(Ast* ast, VectorLoop* loop, Ast* func_body, LocalTable* local_table);
+
+// utils
+int is_private_local(Ast* ast, Ast* func_body, LocalTable* local_table);
+int is_address_taken(Ast* ast, char* symbol_name);
+int is_same_ident(Ast* lhs, Ast* rhs);
+
+
+VectorLoop* analyze_vector_loop(Ast* ast, Ast* func_body, LocalTable* local_table) {
+    if (ast->type != AST_FOR_STMT) return NULL;
+
+    VectorLoop* loop = (VectorLoop*)safe_malloc(sizeof(VectorLoop));
+    loop->index = NULL;
+    loop->bound = NULL;
+    loop->dst = NULL;
+    loop->accumulator = NULL;
+    loop->value = NULL;
+    loop->elem_size = 0;
+    if (
+        !match_loop_header(ast, loop, func_body, local_table) ||
+        !match_loop_body(ast_nth_child(ast, 3), loop, func_body, local_table)
+    ) {
+        free(loop);
+        return NULL;
+    }
+    return loop;
+}
+
+Ast* vector_array_base(Ast* access) {
+    return ast_nth_child(ast_nth_child(access, 0), 0);
+}
+
+int vector_array_bases_equal(Ast* lhs, Ast* rhs) {
+    if (lhs->type != rhs->type) return 0;
+    if (lhs->type == AST_ARRAY_TO_PTR) return is_same_ident(ast_nth_child(lhs, 0), ast_nth_child(rhs, 0));
+    return is_same_ident(lhs, rhs);
+}
+
+// loop-matcher
+int match_loop_header(Ast* ast, VectorLoop* loop, Ast* func_body, LocalTable* local_table) {
+    Ast* cond = ast_nth_child(ast, 1);
+    Ast* step = ast_nth_child(ast, 2);
+    if (cond->type != AST_LT) return 0;
+
+    Ast* index = ast_nth_child(cond, 0);
+    Ast* bound = ast_nth_child(cond, 1);
+    if (index->type != AST_IDENT || index->ctype->basic_ctype != CTYPE_INT) return 0;
+    if (!is_private_local(index, func_body, local_table)) return 0;
+    if (bound->type == AST_IDENT) {
+        if (bound->ctype->basic_ctype != CTYPE_INT || is_same_ident(bound, index)) return 0;
+        if (!is_private_local(bound, func_body, local_table)) return 0;
+    } else if (bound->type != AST_IMM_INT) {
+        return 0;
+    }
+
+    switch (step->type) {
+        case AST_POST_INCR:
+        case AST_PRE_INCR:
+            if (!is_same_ident(ast_nth_child(step, 0), index)) return 0;
+            break;
+        case AST_ADD_ASSIGN: {
+            Ast* increment = ast_nth_child(step, 1);
+            if (!is_same_ident(ast_nth_child(step, 0), index)) return 0;
+            if (increment->type != AST_IMM_INT || increment->value_int != 1) return 0;
+            break;
+        }
+        default:
+            return 0;
+    }
+
+    loop->index = index;
+    loop->bound = bound;
+    return 1;
+}
+
+int match_loop_body(Ast* ast, VectorLoop* loop, Ast* func_body, LocalTable* local_table) {
+    if (ast->type == AST_COMP_STMT) {
+        if (ast->children->size != 1) return 0;
+        ast = ast_nth_child(ast, 0);
+    }
+    if (ast->type != AST_EXPR_STMT) return 0;
+
+    Ast* expr = ast_nth_child(ast, 0);
+    if (expr->type != AST_ASSIGN && expr->type != AST_ADD_ASSIGN) return 0;
+    Ast* lhs = ast_nth_child(expr, 0);
+    Ast* rhs = ast_nth_child(expr, 1);
+
+    if (lhs->type == AST_DEREF && expr->type == AST_ASSIGN) {
+        loop->elem_size = lhs->ctype->size;
+        if (!is_vector_array_access(lhs, loop, func_body, local_table)) return 0;
+        loop->dst = lhs;
+        loop->value = rhs;
+    } else if (lhs->type == AST_IDENT) {
+        if (lhs->ctype->basic_ctype != CTYPE_INT || !is_private_local(lhs, func_body, local_table)) return 0;
+        if (is_same_ident(lhs, loop->index) || is_same_ident(lhs, loop->bound)) return 0;
+        if (expr->type == AST_ASSIGN) {
+            if (rhs->type != AST_ADD || !is_same_ident(ast_nth_child(rhs, 0), lhs)) return 0;
+            rhs = ast_nth_child(rhs, 1);
+        }
+        loop->elem_size = 4;
+        loop->accumulator = lhs;
+        loop->value = rhs;
+    } else {
+        return 0;
+    }
+
+    int depth = vector_expr_depth(loop->value, loop, func_body, local_table);
+    return depth > 0 && depth <= MAX_VECTOR_DEPTH;
+}
+
+int vector_expr_depth(Ast* ast, VectorLoop* loop, Ast* func_body, LocalTable* local_table) {
+    switch (ast->type) {
+        case AST_IMM_INT:
+            return 1;
+        case AST_IDENT:
+            if (ast->ctype->basic_ctype != CTYPE_INT && ast->ctype->basic_ctype != CTYPE_CHAR) return 0;
+            if (is_same_ident(ast, loop->index) || is_same_ident(ast, loop->accumulator)) return 0;
+            return is_private_local(ast, func_body, local_table);
+        case AST_DEREF:
+            return is_vector_array_access(ast, loop, func_body, local_table);
+        case AST_ADD:
+        case AST_SUB:
+        case AST_AND:
+        case AST_XOR:
+        case AST_OR: {
+            if (ast->ctype->basic_ctype != CTYPE_INT) return 0;
+            int lhs_depth = vector_expr_depth(ast_nth_child(ast, 0), loop, func_body, local_table);
+            int rhs_depth = vector_expr_depth(ast_nth_child(ast, 1), loop, func_body, local_table);
+            if (lhs_depth == 0 || rhs_depth == 0) return 0;
+            return lhs_depth > rhs_depth + 1 ? lhs_depth : rhs_depth + 1;
+        }
+        default:
+            return 0;
+    }
+}
+
+int is_vector_array_access(Ast* ast, VectorLoop* loop, Ast* func_body, LocalTable* local_table) {
+    if (ast->type != AST_DEREF) return 0;
+    BasicCType basic_ctype = ast->ctype->basic_ctype;
+    if ((basic_ctype != CTYPE_INT && basic_ctype != CTYPE_CHAR) || ast->ctype->size != loop->elem_size) return 0;
+
+    Ast* offset = ast_nth_child(ast, 0);
+    if (offset->type != AST_ADD || !is_same_ident(ast_nth_child(offset, 1), loop->index)) return 0;
+
+    Ast* base = ast_nth_child(offset, 0);
+    if (base->type == AST_ARRAY_TO_PTR) return ast_nth_child(base, 0)->type == AST_IDENT;
+    return base->type == AST_IDENT && base->ctype->basic_ctype == CTYPE_PTR &&
+        is_private_local(base, func_body, local_table);
+}
+
+// utils
+int is_private_local(Ast* ast, Ast* func_body, LocalTable* local_table) {
+    return local_table_get_stack_index(local_table, ast->value_ident) >= 0 &&
+        !is_address_taken(func_body, ast->value_ident);
+}
+
+int is_address_taken(Ast* ast, char* symbol_name) {
+    if (ast == NULL) return 0;
+    if (ast->type == AST_ADDR) {
+        Ast* child = ast_nth_child(ast, 0);
+        if (child->type == AST_IDENT && strcmp(child->value_ident, symbol_name) == 0) return 1;
+    }
+
+    size_t i = 0, size = ast->children->size;
+    for (i = 0; i < size; i++) {
+        if (is_address_taken(ast_nth_child(ast, i), symbol_name)) return 1;
+    }
+    return 0;
+}
+
+int is_same_ident(Ast* lhs, Ast* rhs) {
+    if (lhs == NULL || rhs == NULL || lhs->type != AST_IDENT || rhs->type != AST_IDENT) return 0;
+    return strcmp(lhs->value_ident, rhs->value_ident) == 0;
+}
@@ -0,0 +1,27 @@
+#ifndef _VECTORIZE_H_
+#define _VECTORIZE_H_
+
+
+#include "../parser/ast.h"
+
+
+#define MAX_VECTOR_DEPTH 6
+#define VECTOR_ACCUMULATOR_REGISTER 7
+
+
+typedef struct {
+    Ast* index;
+    Ast* bound;
+    Ast* dst;
+    Ast* accumulator;
+    Ast* value;
+    int elem_size;
+} VectorLoop;
+
+
+VectorLoop* analyze_vector_loop(Ast* ast, Ast* func_body, LocalTable* local_table);
+Ast* vector_array_base(Ast* access);
+int vector_array_bases_equal(Ast* lhs, Ast* rhs);
+
+
+#endif  // _VECTORIZE_H_
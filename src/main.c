@@ -1,8 +1,11 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include "common/option.h"
 #include "lex/lex.h"
 #include "parser/parser.h"
 #include "semanalyzer/semanalyzer.h"
+#include "semanalyzer/deadcode.h"
+#include "ir/lower.h"
 #include "gen/gen.h"
 
 
@@ -10,24 +13,25 @@ FILE* safe_fopen(char* filename, char* mode);
 
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        fprintf(stderr, "Error: ivalid command-line arguments\n");
-        return 1;
-    }
+    Option* option = option_new();
+    option_parse(option, argc, argv);
 
-    FILE* input_file_ptr = safe_fopen(argv[1], "r");
+    FILE* input_file_ptr = safe_fopen(option->input_filename, "r");
     TokenList* tokenlist = tokenize(input_file_ptr);
     fclose(input_file_ptr);
 
     AstList* astlist = parse(tokenlist);
     analyze_semantics(astlist);
+    if (option->opt_level >= 1) eliminate_dead_code(astlist, option->dce_report ? stderr : NULL);
 
-    FILE* output_file_ptr = safe_fopen(argv[2], "w");
-    print_code(output_file_ptr, astlist);
+    FILE* output_file_ptr = safe_fopen(option->output_filename, "w");
+    if (option->emit_ir) print_ir(output_file_ptr, astlist, option);
+    else                 print_code(output_file_ptr, astlist, option);
     fclose(output_file_ptr);
 
     astlist_delete(astlist);
     tokenlist_delete(tokenlist);
+    option_delete(option);
     return 0;
 }
 
@@ -127,6 +127,20 @@ void ast_move(Ast* dest, Ast* src) {
     free(src);
 }
 
+void ast_wrap(Ast* ast, AstType type) {
+    Ast* inner = (Ast*)safe_malloc(sizeof(Ast));
+    *inner = *ast;
+    ast->type = type;
+    ast->ctype = NULL;
+    ast->children = vector_new();
+    vector_push_back(ast->children, inner);
+}
+
+void ast_unwrap(Ast* ast) {
+    Ast* inner = ast_replace_nth_child(ast, 0, NULL);
+    ast_move(ast, inner);
+}
+
 void ast_append_child(Ast* ast, Ast* child) {
     return vector_push_back(ast->children, child);
 }
@@ -139,6 +153,12 @@ void ast_set_nth_child(Ast* ast, size_t n, Ast* child) {
     vector_assign_at(ast->children, n, child);
 }
 
+Ast* ast_replace_nth_child(Ast* ast, size_t n, Ast* child) {
+    Ast* replaced = ast_nth_child(ast, n);
+    vector_assign_at(ast->children, n, child);
+    return replaced;
+}
+
 void ast_delete(Ast* ast) {
     if (ast == NULL) return;
     ast_delete_members(ast);
@@ -222,7 +242,12 @@ int is_logical_expr(AstType type) {
 }
 
 int is_assignment_expr(AstType type) {
-    return type == AST_ASSIGN;
+    return type == AST_ASSIGN        ||
+           type == AST_MUL_ASSIGN    || type == AST_DIV_ASSIGN    ||
+           type == AST_MOD_ASSIGN    || type == AST_ADD_ASSIGN    ||
+           type == AST_SUB_ASSIGN    || type == AST_LSHIFT_ASSIGN ||
+           type == AST_RSHIFT_ASSIGN || type == AST_AND_ASSIGN    ||
+           type == AST_XOR_ASSIGN    || type == AST_OR_ASSIGN;
 }
 
 int is_null_expr(AstType type) {
@@ -56,6 +56,16 @@ typedef enum {
     AST_LOR,
     // assignment-expression
     AST_ASSIGN,
+    AST_MUL_ASSIGN,
+    AST_DIV_ASSIGN,
+    AST_MOD_ASSIGN,
+    AST_ADD_ASSIGN,
+    AST_SUB_ASSIGN,
+    AST_LSHIFT_ASSIGN,
+    AST_RSHIFT_ASSIGN,
+    AST_AND_ASSIGN,
+    AST_XOR_ASSIGN,
+    AST_OR_ASSIGN,
     // null-expression
     AST_NULL,
 
@@ -117,9 +127,12 @@ Ast* ast_new_str(AstType type, char* value_str);
 Ast* ast_new_ident(AstType type, char* value_ident);
 Ast* ast_copy(Ast* ast);
 void ast_move(Ast* dest, Ast* src);
+void ast_wrap(Ast* ast, AstType type);
+void ast_unwrap(Ast* ast);
 void ast_append_child(Ast* ast, Ast* child);
 Ast* ast_nth_child(Ast* ast, size_t n);
 void ast_set_nth_child(Ast* ast, size_t n, Ast* child);
+Ast* ast_replace_nth_child(Ast* ast, size_t n, Ast* child);
 void ast_delete(Ast* ast);
 
 // expression-ast-classifier
@@ -24,6 +24,7 @@ void assert_global_list(int condition);
 GlobalList* global_list_new() {
     GlobalList* global_list = (GlobalList*)safe_malloc(sizeof(GlobalList));
     global_list->inner_vector = vector_new();
+    global_list->str_labels = map_new();
     global_list->num_str_labels = 0;
     global_list->pos = 0;
     return global_list;
@@ -100,6 +101,11 @@ void global_list_define(GlobalList* global_list, char* symbol_name, GlobalData*
     global_variable->status = GLOBAL_SYMBOL_DEF;
 }
 
+void global_list_make_readonly(GlobalList* global_list, char* symbol_name) {
+    GlobalVariable* global_variable = global_list_find(global_list, symbol_name);
+    if (global_variable != NULL) global_variable->readonly = 1;
+}
+
 CType* global_list_get_ctype(GlobalList* global_list, char* symbol_name) {
     GlobalVariable* global_variable = global_list_find(global_list, symbol_name);
     if (global_variable != NULL) return global_variable->ctype;
@@ -138,6 +144,14 @@ char* global_list_create_str_label(GlobalList* global_list) {
     return label;
 }
 
+char* global_list_find_str_label(GlobalList* global_list, char* value_str) {
+    return (char*)map_find(global_list->str_labels, value_str);
+}
+
+void global_list_bind_str_label(GlobalList* global_list, char* value_str, char* label) {
+    map_insert(global_list->str_labels, value_str, str_new(label));
+}
+
 void global_list_delete(GlobalList* global_list) {
     if (global_list == NULL) return;
 
@@ -148,6 +162,7 @@ void global_list_delete(GlobalList* global_list) {
         inner_vector->data[i] = NULL;
     }
     vector_delete(inner_vector);
+    map_delete(global_list->str_labels);
     free(global_list);
 }
 
@@ -158,6 +173,7 @@ GlobalVariable* global_variable_new(char* symbol_name, CType* ctype, GlobalSymbo
     global_variable->ctype = ctype;
     global_variable->global_data = NULL;
     global_variable->status = status;
+    global_variable->readonly = 0;
     return global_variable;
 }
 
@@ -187,12 +203,13 @@ GlobalData* global_data_new_integer(int value_int, int size) {
     return data;
 }
 
-GlobalData* global_data_new_address(char* address_of) {
+GlobalData* global_data_new_address(char* address_of, int address_offset) {
     GlobalData* data = (GlobalData*)safe_malloc(sizeof(GlobalData));
     data->type = GBL_TYPE_ADDR;
     data->size = 8;
     data->address_of = address_of;
-   return data;
+    data->address_offset = address_offset;
+    return data;
 }
 
 GlobalData* global_data_new_string(char* value_str) {
@@ -203,6 +220,15 @@ GlobalData* global_data_new_string(char* value_str) {
     return data;
 }
 
+GlobalData* global_data_new_bytes(int size) {
+    GlobalData* data = (GlobalData*)safe_malloc(sizeof(GlobalData));
+    data->type = GBL_TYPE_BYTES;
+    data->size = size;
+    data->value_bytes = (unsigned char*)safe_malloc(size * sizeof(unsigned char));
+    memset(data->value_bytes, 0, size);
+    return data;
+}
+
 GlobalData* global_data_nth_child(GlobalData* global_data, size_t n) {
     assert_global_list(global_data->type == GBL_TYPE_LIST);
     return (GlobalData*)vector_at(global_data->children, n);
@@ -226,6 +252,9 @@ void global_data_delete(GlobalData* global_data) {
         case GBL_TYPE_STR:
             free(global_data->value_str);
             break;
+        case GBL_TYPE_BYTES:
+            free(global_data->value_bytes);
+            break;
         case GBL_TYPE_LIST: {
             size_t i = 0, size = global_data->children->size;
             for (i = 0; i < size; i++) {
@@ -3,6 +3,7 @@
 
 
 #include "type.h"
+#include "../common/map.h"
 #include "../common/vector.h"
 
 
@@ -10,6 +11,7 @@ typedef enum {
     GBL_TYPE_INTEGER,
     GBL_TYPE_ADDR,
     GBL_TYPE_STR,
+    GBL_TYPE_BYTES,
     GBL_TYPE_LIST
 } GlobalDataType;
 
@@ -18,8 +20,12 @@ typedef struct {
     int size;
     union {
         int value_int;
-        char* address_of;
+        struct {
+            char* address_of;
+            int address_offset;
+        };
         char* value_str;
+        unsigned char* value_bytes;
         Vector* children;
     };
 } GlobalData;
@@ -35,10 +41,12 @@ typedef struct {
     CType* ctype;
     GlobalData* global_data;
     GlobalSymbolStatus status;
+    int readonly;
 } GlobalVariable;
 
 typedef struct {
      Vector* inner_vector;
+     Map* str_labels;
      int num_str_labels;
      int pos;
 } GlobalList;
@@ -52,17 +60,21 @@ void global_list_pop(GlobalList* global_list);
 int global_list_exists(GlobalList* global_list, char* symbol_name);
 void global_list_tentatively_define(GlobalList* global_list, char* symbol_name);
 void global_list_define(GlobalList* global_list, char* symbol_name, GlobalData* global_data);
+void global_list_make_readonly(GlobalList* global_list, char* symbol_name);
 CType* global_list_get_ctype(GlobalList* global_list, char* symbol_name);
 CType* global_list_get_function_ctype(GlobalList* global_list, char* symbol_name);
 GlobalData* global_list_get_global_data(GlobalList* global_list, char* symbol_name);
 char* global_list_create_str_label(GlobalList* global_list);
+char* global_list_find_str_label(GlobalList* global_list, char* value_str);
+void global_list_bind_str_label(GlobalList* global_list, char* value_str, char* label);
 void global_list_delete(GlobalList* global_list);
 
 // global-data
 GlobalData* global_data_new_list();
 GlobalData* global_data_new_integer(int value_int, int size);
-GlobalData* global_data_new_address(char* address_of);
+GlobalData* global_data_new_address(char* address_of, int address_offset);
 GlobalData* global_data_new_string(char* value_str);
+GlobalData* global_data_new_bytes(int size);
 void global_data_append_child(GlobalData* global_data, GlobalData* child);
 GlobalData* global_data_nth_child(GlobalData* global_data, size_t n);
 void global_data_delete(GlobalData* global_data);
@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "../common/memory.h"
+#include "../semanalyzer/constexpr.h"
 
 
 // expression-parser
@@ -374,63 +375,55 @@ Ast* parse_logical_or_expr(TokenList* tokenlist) {
 }
 
 Ast* parse_assignment_expr(TokenList* tokenlist) {
-    size_t pos_memo = tokenlist->pos;
-    Ast* ast = parse_unary_expr(tokenlist);
+    Ast* ast = parse_logical_or_expr(tokenlist);
 
     Token* token = tokenlist_top(tokenlist);
-    int op_type = -1;
+    int assign_type = -1;
     switch (token->type) {
         case TOKEN_EQ:
-            op_type = AST_NULL;
+            assign_type = AST_ASSIGN;
             break;
         case TOKEN_ASTERISK_EQ:
-            op_type = AST_MUL;
+            assign_type = AST_MUL_ASSIGN;
             break;
         case TOKEN_SLASH_EQ:
-            op_type = AST_DIV;
+            assign_type = AST_DIV_ASSIGN;
             break;
         case TOKEN_PERCENT_EQ:
-            op_type = AST_MOD;
+            assign_type = AST_MOD_ASSIGN;
             break;
         case TOKEN_PLUS_EQ:
-            op_type = AST_ADD;
+            assign_type = AST_ADD_ASSIGN;
             break;
         case TOKEN_MINUS_EQ:
-            op_type = AST_SUB;
+            assign_type = AST_SUB_ASSIGN;
             break;
         case TOKEN_DBL_LANGLE_EQ:
-            op_type = AST_LSHIFT;
+            assign_type = AST_LSHIFT_ASSIGN;
             break;
         case TOKEN_DBL_RANGLE_EQ:
-            op_type = AST_RSHIFT;
+            assign_type = AST_RSHIFT_ASSIGN;
             break;
         case TOKEN_AND_EQ:
-            op_type = AST_AND;
+            assign_type = AST_AND_ASSIGN;
             break;
         case TOKEN_HAT_EQ:
-            op_type = AST_XOR;
+            assign_type = AST_XOR_ASSIGN;
             break;
         case TOKEN_BAR_EQ:
-            op_type = AST_OR;
+            assign_type = AST_OR_ASSIGN;
             break;
         default:
-            op_type = -1;
+            assign_type = -1;
             break;
     }
+    if (assign_type < 0) return ast;
 
-    if (op_type < 0) {
-        tokenlist->pos = pos_memo;
-        ast_delete(ast);
-        ast = parse_logical_or_expr(tokenlist);
-    } else if (op_type == AST_NULL) {
-        tokenlist_pop(tokenlist);
-        ast = ast_new(AST_ASSIGN, 2, ast, parse_assignment_expr(tokenlist));
-    } else {
-        tokenlist_pop(tokenlist);
-        Ast* op_ast = ast_new(op_type, 2, ast_copy(ast), parse_assignment_expr(tokenlist));
-        ast = ast_new(AST_ASSIGN, 2, ast, op_ast);
-    }
-    return ast;
+    tokenlist_pop(tokenlist);
+    assert_syntax(
+        is_primary_expr(ast->type) || is_postfix_expr(ast->type) || is_unary_expr(ast->type)
+    );
+    return ast_new(assign_type, 2, ast, parse_assignment_expr(tokenlist));
 }
 
 Ast* parse_expr(TokenList* tokenlist) {
@@ -723,10 +716,11 @@ Ast* parse_array_len_list(TokenList* tokenlist) {
         if (token->type != TOKEN_LBRACKET) break;
         tokenlist_pop(tokenlist);
 
-        token = assert_and_top_token(tokenlist, TOKEN_IMM_INT);
-        tokenlist_pop(tokenlist);
-        ast_append_child(ast, ast_new_int(AST_IMM_INT, token->value_int));
-        // TODO: assignment-expr for array length
+        Ast* array_len = parse_logical_or_expr(tokenlist);
+        int value = 0;
+        assert_syntax(evaluate_integer_constant_expr(array_len, &value) && value >= 0);
+        ast_delete(array_len);
+        ast_append_child(ast, ast_new_int(AST_IMM_INT, value));
 
         assert_and_pop_token(tokenlist, TOKEN_RBRACKET);
     }
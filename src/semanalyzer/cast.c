@@ -27,18 +27,15 @@ void apply_inplace_array_to_ptr_conversion(Ast* ast) {
     )
         return;
 
-    Ast* array = ast_copy(ast);
-    Ast* ptr = ast_new(AST_ARRAY_TO_PTR, 1, array);
-    ptr->ctype = ctype_new_ptr(ctype_copy(array->ctype->array_of));
-    ast_move(ast, ptr);
+    ast_wrap(ast, AST_ARRAY_TO_PTR);
+    Ast* array = ast_nth_child(ast, 0);
+    ast->ctype = ctype_new_ptr(ctype_copy(array->ctype->array_of));
 }
 
 void revert_inplace_array_to_ptr_conversion(Ast* ast) {
     if (ast->type != AST_ARRAY_TO_PTR) return;
 
-    Ast* array = ast_nth_child(ast, 0);
-    ast_set_nth_child(ast, 0, NULL);
-    ast_move(ast, array);
+    ast_unwrap(ast);
 }
 
 void apply_inplace_function_declaration_conversion(Ast* ast) {
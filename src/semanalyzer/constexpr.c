@@ -0,0 +1,216 @@
+#include "constexpr.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../common/memory.h"
+
+
+// folder
+int is_foldable_expr(Ast* ast);
+void fold_pointer_offset(Ast* ast);
+
+// evaluator
+int evaluate_unary_operation(AstType type, int operand, int* value);
+int evaluate_binary_operation(AstType type, int lhs, int rhs, int* value);
+int wrap_integer(long long wide_value);
+
+
+int evaluate_integer_constant_expr(Ast* ast, int* value) {
+    int lhs = 0, rhs = 0;
+
+    switch (ast->type) {
+        case AST_IMM_INT:
+            *value = ast->value_int;
+            return 1;
+        case AST_POSI:
+        case AST_NEGA:
+        case AST_NOT:
+        case AST_LNOT:
+            if (!evaluate_integer_constant_expr(ast_nth_child(ast, 0), &lhs)) return 0;
+            return evaluate_unary_operation(ast->type, lhs, value);
+        case AST_LAND:
+        case AST_LOR:
+            if (!evaluate_integer_constant_expr(ast_nth_child(ast, 0), &lhs)) return 0;
+            if ((ast->type == AST_LAND) == (lhs == 0)) {
+                *value = lhs != 0;
+                return 1;
+            }
+            if (!evaluate_integer_constant_expr(ast_nth_child(ast, 1), &rhs)) return 0;
+            *value = rhs != 0;
+            return 1;
+        default:
+            break;
+    }
+
+    if (
+        !is_multiplicative_expr(ast->type) && !is_additive_expr(ast->type) &&
+        !is_shift_expr(ast->type) && !is_relational_expr(ast->type) &&
+        !is_equality_expr(ast->type) && !is_bitwise_expr(ast->type)
+    )
+        return 0;
+    if (ast->ctype != NULL && ast->ctype->basic_ctype == CTYPE_PTR) return 0;
+    if (!evaluate_integer_constant_expr(ast_nth_child(ast, 0), &lhs)) return 0;
+    if (!evaluate_integer_constant_expr(ast_nth_child(ast, 1), &rhs)) return 0;
+    return evaluate_binary_operation(ast->type, lhs, rhs, value);
+}
+
+int evaluate_address_constant_expr(Ast* ast, char** symbol, int* offset) {
+    Ast* child = NULL;
+    Ast* integer = NULL;
+    int value = 0;
+
+    switch (ast->type) {
+        case AST_ADDR:
+        case AST_ARRAY_TO_PTR:
+            child = ast_nth_child(ast, 0);
+            if (child->type != AST_IDENT) return 0;
+            *symbol = child->value_ident;
+            *offset = 0;
+            return 1;
+        case AST_ADD:
+        case AST_SUB:
+            if (ast->ctype == NULL || ast->ctype->basic_ctype != CTYPE_PTR) return 0;
+            child = ast_nth_child(ast, 0);
+            integer = ast_nth_child(ast, 1);
+            if (child->ctype->basic_ctype != CTYPE_PTR) {
+                integer = child;
+                child = ast_nth_child(ast, 1);
+            }
+            if (!evaluate_address_constant_expr(child, symbol, offset)) return 0;
+            if (!evaluate_integer_constant_expr(integer, &value)) return 0;
+            if (ast->type == AST_SUB) value = -value;
+            *offset += value * ast->ctype->ptr_to->size;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+void apply_inplace_constant_folding(Ast* ast) {
+    fold_pointer_offset(ast);
+    if (!is_foldable_expr(ast)) return;
+
+    int value = 0;
+    if (!evaluate_integer_constant_expr(ast, &value)) return;
+
+    Ast* folded = ast_new_int(AST_IMM_INT, value);
+    folded->ctype = ctype_new_int();
+    ast_move(ast, folded);
+}
+
+// folder
+int is_foldable_expr(Ast* ast) {
+    if (ast->type == AST_IMM_INT || is_postfix_expr(ast->type) || is_assignment_expr(ast->type)) return 0;
+    if (ast->children->size == 0 || ast_nth_child(ast, 0)->type != AST_IMM_INT) return 0;
+    if (ast->children->size == 1) return 1;
+
+    Ast* lhs = ast_nth_child(ast, 0);
+    if (ast->type == AST_LAND && lhs->value_int == 0) return 1;
+    if (ast->type == AST_LOR && lhs->value_int != 0) return 1;
+    return ast_nth_child(ast, 1)->type == AST_IMM_INT;
+}
+
+void fold_pointer_offset(Ast* ast) {
+    if (ast->type != AST_ADD && ast->type != AST_SUB) return;
+    if (ast->ctype == NULL || ast->ctype->basic_ctype != CTYPE_PTR) return;
+
+    Ast* lhs = ast_nth_child(ast, 0);
+    Ast* rhs = ast_nth_child(ast, 1);
+    if (rhs->type != AST_IMM_INT) return;
+    if (lhs->type != AST_ADD && lhs->type != AST_SUB) return;
+    if (lhs->ctype->basic_ctype != CTYPE_PTR || ast_nth_child(lhs, 1)->type != AST_IMM_INT) return;
+
+    int inner_offset = ast_nth_child(lhs, 1)->value_int;
+    if (lhs->type == AST_SUB) inner_offset = wrap_integer(-(long long)inner_offset);
+    int outer_offset = ast->type == AST_SUB ? wrap_integer(-(long long)rhs->value_int) : rhs->value_int;
+
+    Ast* ptr = ast_replace_nth_child(lhs, 0, NULL);
+    ast_delete(ast_replace_nth_child(ast, 0, ptr));
+    rhs->value_int = wrap_integer((long long)inner_offset + outer_offset);
+    ast->type = AST_ADD;
+}
+
+// evaluator
+int evaluate_unary_operation(AstType type, int operand, int* value) {
+    switch (type) {
+        case AST_POSI:
+            *value = operand;
+            return 1;
+        case AST_NEGA:
+            *value = wrap_integer(-(long long)operand);
+            return 1;
+        case AST_NOT:
+            *value = ~operand;
+            return 1;
+        case AST_LNOT:
+            *value = !operand;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+int evaluate_binary_operation(AstType type, int lhs, int rhs, int* value) {
+    long long wide_lhs = lhs, wide_rhs = rhs;
+
+    switch (type) {
+        case AST_MUL:
+            *value = wrap_integer(wide_lhs * wide_rhs);
+            return 1;
+        case AST_DIV:
+        case AST_MOD:
+            if (rhs == 0) return 0;
+            if (lhs == -2147483647 - 1 && rhs == -1) return 0;
+            *value = type == AST_DIV ? lhs / rhs : lhs % rhs;
+            return 1;
+        case AST_ADD:
+            *value = wrap_integer(wide_lhs + wide_rhs);
+            return 1;
+        case AST_SUB:
+            *value = wrap_integer(wide_lhs - wide_rhs);
+            return 1;
+        case AST_LSHIFT:
+            if (rhs < 0 || rhs >= 32) return 0;
+            *value = (int)((unsigned int)lhs << rhs);
+            return 1;
+        case AST_RSHIFT:
+            if (rhs < 0 || rhs >= 32) return 0;
+            *value = lhs < 0 ? ~(~lhs >> rhs) : lhs >> rhs;
+            return 1;
+        case AST_LT:
+            *value = lhs < rhs;
+            return 1;
+        case AST_GT:
+            *value = lhs > rhs;
+            return 1;
+        case AST_LEQ:
+            *value = lhs <= rhs;
+            return 1;
+        case AST_GEQ:
+            *value = lhs >= rhs;
+            return 1;
+        case AST_EQ:
+            *value = lhs == rhs;
+            return 1;
+        case AST_NEQ:
+            *value = lhs != rhs;
+            return 1;
+        case AST_AND:
+            *value = lhs & rhs;
+            return 1;
+        case AST_XOR:
+            *value = lhs ^ rhs;
+            return 1;
+        case AST_OR:
+            *value = lhs | rhs;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+int wrap_integer(long long wide_value) {
+    int value = (int)(unsigned int)wide_value;
+    if (value != wide_value) fprintf(stderr, "Warning: integer overflow in constant expression\n");
+    return value;
+}
@@ -0,0 +1,13 @@
+#ifndef _CONSTEXPR_H_
+#define _CONSTEXPR_H_
+
+
+#include "../parser/ast.h"
+
+
+int evaluate_integer_constant_expr(Ast* ast, int* value);
+int evaluate_address_constant_expr(Ast* ast, char** symbol, int* offset);
+void apply_inplace_constant_folding(Ast* ast);
+
+
+#endif  // _CONSTEXPR_H_
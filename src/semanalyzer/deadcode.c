@@ -0,0 +1,266 @@
+#include "deadcode.h"
+
+#include <stdlib.h>
+#include "../common/memory.h"
+
+
+typedef struct {
+    int num_stmts;
+    int num_nodes;
+} DeadCodeStats;
+
+
+// statement-eliminator
+Ast* eliminate_stmt_dead_code(Ast* ast, DeadCodeStats* stats);
+void eliminate_compound_stmt_dead_code(Ast* ast, DeadCodeStats* stats);
+Ast* eliminate_expr_stmt_dead_code(Ast* ast, DeadCodeStats* stats);
+Ast* eliminate_selection_stmt_dead_code(Ast* ast, DeadCodeStats* stats);
+Ast* eliminate_iteration_stmt_dead_code(Ast* ast, DeadCodeStats* stats);
+
+// expression-eliminator
+Ast* eliminate_unused_expr(Ast* ast, DeadCodeStats* stats);
+int has_side_effects(Ast* ast);
+
+// utils
+int is_terminating_stmt(Ast* ast);
+Ast* wrap_expr_stmt(Ast* expr);
+Ast* ensure_stmt(Ast* ast);
+void discard_ast(Ast* ast, DeadCodeStats* stats);
+void count_ast(Ast* ast, DeadCodeStats* stats);
+
+
+void eliminate_dead_code(AstList* astlist, FILE* report_file) {
+    Vector* inner_vector = astlist->inner_vector;
+    size_t i = 0, size = inner_vector->size;
+    for (i = 0; i < size; i++) {
+        Ast* ast = (Ast*)vector_at(inner_vector, i);
+        if (ast->type != AST_FUNC_DEF) continue;
+
+        DeadCodeStats stats = { 0, 0 };
+        eliminate_compound_stmt_dead_code(ast_nth_child(ast, 1), &stats);
+        if (report_file != NULL) {
+            Ast* func_ident = ast_nth_child(ast_nth_child(ast, 0), 0);
+            fprintf(
+                report_file, "dce: %s removed %d statements, %d nodes\n",
+                func_ident->value_ident, stats.num_stmts, stats.num_nodes
+            );
+        }
+    }
+}
+
+// statement-eliminator
+Ast* eliminate_stmt_dead_code(Ast* ast, DeadCodeStats* stats) {
+    if (ast == NULL) return NULL;
+
+    AstType type = ast->type;
+    if (is_compound_stmt(type)) {
+        eliminate_compound_stmt_dead_code(ast, stats);
+        if (ast->children->size > 0) return ast;
+        discard_ast(ast, stats);
+        return NULL;
+    }
+    if (is_expr_stmt(type))      return eliminate_expr_stmt_dead_code(ast, stats);
+    if (is_selection_stmt(type)) return eliminate_selection_stmt_dead_code(ast, stats);
+    if (is_iteration_stmt(type)) return eliminate_iteration_stmt_dead_code(ast, stats);
+    return ast;
+}
+
+void eliminate_compound_stmt_dead_code(Ast* ast, DeadCodeStats* stats) {
+    Vector* children = ast->children;
+    size_t i = 0, j = 0, size = children->size;
+    int reachable = 1;
+    for (i = 0; i < size; i++) {
+        Ast* child = ast_nth_child(ast, i);
+        if (!reachable) {
+            discard_ast(child, stats);
+            continue;
+        }
+        if (child->type != AST_DECL_LIST) child = eliminate_stmt_dead_code(child, stats);
+        if (child == NULL) continue;
+        children->data[j++] = child;
+        reachable = !is_terminating_stmt(child);
+    }
+    children->size = j;
+}
+
+Ast* eliminate_expr_stmt_dead_code(Ast* ast, DeadCodeStats* stats) {
+    Ast* expr = eliminate_unused_expr(ast_replace_nth_child(ast, 0, NULL), stats);
+    if (expr == NULL) {
+        discard_ast(ast, stats);
+        return NULL;
+    }
+    ast_set_nth_child(ast, 0, expr);
+    return ast;
+}
+
+Ast* eliminate_selection_stmt_dead_code(Ast* ast, DeadCodeStats* stats) {
+    Ast* cond = ast_nth_child(ast, 0);
+    Ast* then_stmt = eliminate_stmt_dead_code(ast_replace_nth_child(ast, 1, NULL), stats);
+    Ast* else_stmt = NULL;
+    if (ast->children->size == 3) {
+        else_stmt = eliminate_stmt_dead_code(ast_replace_nth_child(ast, 2, NULL), stats);
+    }
+
+    if (cond->type == AST_IMM_INT) {
+        Ast* taken_stmt = cond->value_int != 0 ? then_stmt : else_stmt;
+        discard_ast(cond->value_int != 0 ? else_stmt : then_stmt, stats);
+        discard_ast(ast, stats);
+        return taken_stmt;
+    }
+
+    if (then_stmt == NULL && else_stmt == NULL) {
+        ast_set_nth_child(ast, 0, NULL);
+        discard_ast(ast, stats);
+        return wrap_expr_stmt(eliminate_unused_expr(cond, stats));
+    }
+
+    if (then_stmt == NULL) {
+        ast_wrap(cond, AST_LNOT);
+        cond->ctype = ctype_new_int();
+        then_stmt = else_stmt;
+        else_stmt = NULL;
+    }
+    ast_set_nth_child(ast, 1, then_stmt);
+    if (else_stmt != NULL) ast_set_nth_child(ast, 2, else_stmt);
+    else                   ast->children->size = 2;
+    return ast;
+}
+
+Ast* eliminate_iteration_stmt_dead_code(Ast* ast, DeadCodeStats* stats) {
+    Ast* init = NULL;
+    Ast* cond = NULL;
+    size_t i = 0;
+
+    switch (ast->type) {
+        case AST_WHILE_STMT:
+            cond = ast_nth_child(ast, 0);
+            if (cond->type == AST_IMM_INT && cond->value_int == 0) {
+                discard_ast(ast, stats);
+                return NULL;
+            }
+            ast_set_nth_child(ast, 1, ensure_stmt(eliminate_stmt_dead_code(ast_replace_nth_child(ast, 1, NULL), stats)));
+            break;
+        case AST_DOWHILE_STMT:
+            ast_set_nth_child(ast, 0, ensure_stmt(eliminate_stmt_dead_code(ast_replace_nth_child(ast, 0, NULL), stats)));
+            break;
+        case AST_FOR_STMT:
+            cond = ast_nth_child(ast, 1);
+            if (cond->type == AST_IMM_INT && cond->value_int == 0) {
+                init = ast_replace_nth_child(ast, 0, NULL);
+                discard_ast(ast, stats);
+                return wrap_expr_stmt(eliminate_unused_expr(init, stats));
+            }
+            for (i = 0; i <= 2; i += 2) {
+                Ast* expr = ast_nth_child(ast, i);
+                if (is_null_expr(expr->type) || has_side_effects(expr)) continue;
+                discard_ast(ast_replace_nth_child(ast, i, ast_new(AST_NULL, 0)), stats);
+            }
+            ast_set_nth_child(ast, 3, ensure_stmt(eliminate_stmt_dead_code(ast_replace_nth_child(ast, 3, NULL), stats)));
+            break;
+        default:
+            break;
+    }
+    return ast;
+}
+
+// expression-eliminator
+Ast* eliminate_unused_expr(Ast* ast, DeadCodeStats* stats) {
+    if (ast == NULL) return NULL;
+    if (!has_side_effects(ast)) {
+        discard_ast(ast, stats);
+        return NULL;
+    }
+
+    AstType type = ast->type;
+    if (
+        is_postfix_expr(type) || type == AST_PRE_INCR || type == AST_PRE_DECR ||
+        is_logical_expr(type) || is_assignment_expr(type)
+    )
+        return ast;
+
+    Ast* kept = NULL;
+    int num_kept = 0;
+    size_t i = 0, size = ast->children->size;
+    for (i = 0; i < size; i++) {
+        Ast* child = eliminate_unused_expr(ast_nth_child(ast, i), stats);
+        ast_set_nth_child(ast, i, child);
+        if (child == NULL) continue;
+        kept = child;
+        num_kept++;
+    }
+    if (num_kept > 1) return ast;
+
+    for (i = 0; i < size; i++) {
+        ast_set_nth_child(ast, i, NULL);
+    }
+    discard_ast(ast, stats);
+    return kept;
+}
+
+int has_side_effects(Ast* ast) {
+    if (ast == NULL) return 0;
+
+    AstType type = ast->type;
+    if (
+        type == AST_FUNC_CALL || type == AST_POST_INCR || type == AST_POST_DECR ||
+        type == AST_PRE_INCR || type == AST_PRE_DECR || is_assignment_expr(type)
+    )
+        return 1;
+
+    size_t i = 0, size = ast->children->size;
+    for (i = 0; i < size; i++) {
+        if (has_side_effects(ast_nth_child(ast, i))) return 1;
+    }
+    return 0;
+}
+
+// utils
+int is_terminating_stmt(Ast* ast) {
+    size_t size = ast->children->size;
+    switch (ast->type) {
+        case AST_CONTINUE_STMT:
+        case AST_BREAK_STMT:
+        case AST_RETURN_STMT:
+            return 1;
+        case AST_COMP_STMT:
+            return size > 0 && is_terminating_stmt(ast_nth_child(ast, size - 1));
+        case AST_IF_STMT:
+            return size == 3 &&
+                is_terminating_stmt(ast_nth_child(ast, 1)) &&
+                is_terminating_stmt(ast_nth_child(ast, 2));
+        default:
+            return 0;
+    }
+}
+
+Ast* wrap_expr_stmt(Ast* expr) {
+    if (expr == NULL) return NULL;
+    return ast_new(AST_EXPR_STMT, 1, expr);
+}
+
+Ast* ensure_stmt(Ast* ast) {
+    if (ast != NULL) return ast;
+    return ast_new(AST_EXPR_STMT, 1, ast_new(AST_NULL, 0));
+}
+
+void discard_ast(Ast* ast, DeadCodeStats* stats) {
+    count_ast(ast, stats);
+    ast_delete(ast);
+}
+
+void count_ast(Ast* ast, DeadCodeStats* stats) {
+    if (ast == NULL) return;
+
+    AstType type = ast->type;
+    if (
+        is_compound_stmt(type) || is_expr_stmt(type) || is_selection_stmt(type) ||
+        is_iteration_stmt(type) || is_jump_stmt(type) || type == AST_DECL_LIST
+    )
+        stats->num_stmts++;
+    stats->num_nodes++;
+
+    size_t i = 0, size = ast->children->size;
+    for (i = 0; i < size; i++) {
+        count_ast(ast_nth_child(ast, i), stats);
+    }
+}
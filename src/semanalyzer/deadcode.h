@@ -0,0 +1,12 @@
+#ifndef _DEADCODE_H_
+#define _DEADCODE_H_
+
+
+#include <stdio.h>
+#include "../parser/ast.h"
+
+
+void eliminate_dead_code(AstList* astlist, FILE* report_file);
+
+
+#endif  // _DEADCODE_H_
@@ -4,9 +4,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include "cast.h"
+#include "constexpr.h"
 #include "../common/memory.h"
 
 
+#define MIN_TEMPLATE_ELEMENTS 4
+
+
 // expression-semantics-analyzer
 void analyze_primary_expr_semantics(Ast* ast, GlobalList* global_list, LocalTable* local_table);
 void analyze_postfix_expr_semantics(Ast* ast, GlobalList* global_list, LocalTable* local_table);
@@ -58,6 +62,9 @@ GlobalData* global_ident_initializer_to_data(Ast* init, CType* ident_ctype);
 GlobalData* global_array_initializer_to_data(Ast* init, CType* array_ctype);
 void local_initializer_to_completed(Ast* init, CType* ctype);
 void local_array_initializer_to_completed(Ast* init, CType* array_ctype);
+void local_array_initializer_to_template(Ast* init, CType* array_ctype, GlobalList* global_list);
+int count_constant_initializer_elements(Ast* init, CType* ctype);
+void pack_initializer_bytes(Ast* init, CType* ctype, unsigned char* bytes);
 
 // assertion
 void assert_semantics(int condition);
@@ -95,12 +102,19 @@ void analyze_primary_expr_semantics(Ast* ast, GlobalList* global_list, LocalTabl
             ast->ctype = ctype_new_int();
             break;
         case AST_IMM_STR: {
-            Ast* ident = ast_new_ident(AST_IDENT, global_list_create_str_label(global_list));
+            char* label = global_list_find_str_label(global_list, ast->value_str);
+            Ast* ident = ast_new_ident(AST_IDENT, NULL);
             ident->ctype = ctype_new_array(ctype_new_char(), strlen(ast->value_str) + 1);
-
-            global_list_insert_copy(global_list, ident->value_ident, ident->ctype);
-            GlobalData* global_data = global_initializer_to_data(ast, ident->ctype);
-            global_list_define(global_list, ident->value_ident, global_data);
+            if (label != NULL) {
+                ident->value_ident = str_new(label);
+            } else {
+                ident->value_ident = global_list_create_str_label(global_list);
+                global_list_insert_copy(global_list, ident->value_ident, ident->ctype);
+                GlobalData* global_data = global_initializer_to_data(ast, ident->ctype);
+                global_list_define(global_list, ident->value_ident, global_data);
+                global_list_make_readonly(global_list, ident->value_ident);
+                global_list_bind_str_label(global_list, ast->value_str, ident->value_ident);
+            }
 
             ast_move(ast, ident);
             apply_inplace_array_to_ptr_conversion(ast);
@@ -313,10 +327,35 @@ void analyze_assignment_expr_semantics(Ast* ast, GlobalList* global_list, LocalT
     Ast* rhs = ast_nth_child(ast, 1);
     analyze_expr_semantics(lhs, global_list, local_table);
     analyze_expr_semantics(rhs, global_list, local_table);
-    assert_semantics(
-        (lhs->type == AST_IDENT || lhs->type == AST_DEREF) &&
-        ctype_compatible(lhs->ctype, rhs->ctype)
-    );
+    assert_semantics(lhs->type == AST_IDENT || lhs->type == AST_DEREF);
+
+    switch (ast->type) {
+        case AST_ASSIGN:
+            assert_semantics(ctype_compatible(lhs->ctype, rhs->ctype));
+            break;
+        case AST_ADD_ASSIGN:
+        case AST_SUB_ASSIGN:
+            apply_inplace_integer_promotion(rhs);
+            assert_semantics(
+                ctype_is_integer_ctype(lhs->ctype) || lhs->ctype->basic_ctype == CTYPE_PTR
+            );
+            assert_semantics(rhs->ctype->basic_ctype == CTYPE_INT);
+            break;
+        case AST_MUL_ASSIGN:
+        case AST_DIV_ASSIGN:
+        case AST_MOD_ASSIGN:
+        case AST_LSHIFT_ASSIGN:
+        case AST_RSHIFT_ASSIGN:
+        case AST_AND_ASSIGN:
+        case AST_XOR_ASSIGN:
+        case AST_OR_ASSIGN:
+            apply_inplace_integer_promotion(rhs);
+            assert_semantics(ctype_is_integer_ctype(lhs->ctype));
+            assert_semantics(rhs->ctype->basic_ctype == CTYPE_INT);
+            break;
+        default:
+            assert_semantics(0);
+    }
     ast->ctype = ctype_copy(lhs->ctype);
 }
 
@@ -334,6 +373,7 @@ void analyze_expr_semantics(Ast* ast, GlobalList* global_list, LocalTable* local
     else if (is_logical_expr(type))        analyze_logical_expr_semantics(ast, global_list, local_table);
     else if (is_assignment_expr(type))     analyze_assignment_expr_semantics(ast, global_list, local_table);
     else if (!is_null_expr(type))          assert_semantics(0);
+    apply_inplace_constant_folding(ast);
 }
 
 // statement-semantics-analyzer
@@ -503,6 +543,7 @@ void analyze_local_declaration_semantics(Ast* ast, GlobalList* global_list, Loca
             init = ast_nth_child(ast, 2);
             analyze_initializer_semantics(init, ident->ctype, global_list, local_table);
             local_initializer_to_completed(init, ident->ctype);
+            local_array_initializer_to_template(init, ident->ctype, global_list);
             break;
         case CTYPE_FUNC:
             apply_inplace_function_declaration_conversion(ast);
@@ -619,19 +660,15 @@ GlobalData* global_initializer_to_data(Ast* init, CType* ctype) {
 
 GlobalData* global_ident_initializer_to_data(Ast* init, CType* ident_ctype) {
     GlobalData* global_data = NULL;
-    switch (init->type) {
-        case AST_IMM_INT:
-            global_data = global_data_new_integer(init->value_int, ident_ctype->size);
-            break;
-        case AST_ADDR: 
-        case AST_ARRAY_TO_PTR: {
-            Ast* address_of = ast_nth_child(init, 0);
-            assert_semantics(address_of->type == AST_IDENT);
-            global_data = global_data_new_address(str_new(address_of->value_ident));
-            break;
-        }
-        default:
-            assert_semantics(0);
+    char* address_of = NULL;
+    int value = 0;
+
+    if (evaluate_integer_constant_expr(init, &value)) {
+        global_data = global_data_new_integer(value, ident_ctype->size);
+    } else if (evaluate_address_constant_expr(init, &address_of, &value)) {
+        global_data = global_data_new_address(str_new(address_of), value);
+    } else {
+        assert_semantics(0);
     }
     return global_data;
 }
@@ -650,6 +687,12 @@ GlobalData* global_array_initializer_to_data(Ast* init, CType* array_ctype) {
             break;
         }
         case AST_INIT_LIST: {
+            if (count_constant_initializer_elements(init, array_ctype) >= 0) {
+                global_data = global_data_new_bytes(array_ctype->size);
+                pack_initializer_bytes(init, array_ctype, global_data->value_bytes);
+                break;
+            }
+
             global_data = global_data_new_list();
             GlobalData* child = NULL;
             size_t i = 0, size = init->children->size;
@@ -682,7 +725,6 @@ void local_initializer_to_completed(Ast* init, CType* ctype) {
 }
 
 void local_array_initializer_to_completed(Ast* init, CType* array_ctype) {
-    int array_len = array_ctype->size / array_ctype->array_of->size;
     size_t i = 0, size = 0;
 
     switch (init->type) {
@@ -692,34 +734,81 @@ void local_array_initializer_to_completed(Ast* init, CType* array_ctype) {
             for (i = 0; i < size; i++) {
                 ast_append_child(init, ast_new_int(AST_IMM_INT, init->value_str[i]));
             }
-            for (i = size; i < array_len; i++) {
-                ast_append_child(init, ast_new_int(AST_IMM_INT, 0));
-            }
             break;
         }
         case AST_INIT_LIST:
             size = init->children->size;
-            switch (array_ctype->array_of->basic_ctype) {
-                case CTYPE_CHAR:
-                case CTYPE_INT:
-                case CTYPE_PTR:
-                    for (i = size; i < array_len; i++) {
-                        ast_append_child(init, ast_new_int(AST_IMM_INT, 0));
-                    }
-                    break;
-                case CTYPE_ARRAY:
-                    for (i = 0; i < size; i++) {
-                        Ast* child = ast_nth_child(init, i);
-                        local_array_initializer_to_completed(child, array_ctype->array_of);
-                    }
-                    for (i = size; i < array_len; i++) {
-                        Ast* child = ast_new(AST_INIT_LIST, 0);
-                        local_array_initializer_to_completed(child, array_ctype->array_of);
-                        ast_append_child(init, child);
-                    }
-                    break;
-                case CTYPE_FUNC:
-                    assert_semantics(0);
+            if (array_ctype->array_of->basic_ctype != CTYPE_ARRAY) break;
+            for (i = 0; i < size; i++) {
+                local_array_initializer_to_completed(ast_nth_child(init, i), array_ctype->array_of);
+            }
+            break;
+        default:
+            assert_semantics(0);
+    }
+}
+
+void local_array_initializer_to_template(Ast* init, CType* array_ctype, GlobalList* global_list) {
+    CType* elem_ctype = array_ctype;
+    while (elem_ctype->basic_ctype == CTYPE_ARRAY) elem_ctype = elem_ctype->array_of;
+
+    int num_elements = count_constant_initializer_elements(init, array_ctype);
+    int array_len = array_ctype->size / elem_ctype->size;
+    if (num_elements < MIN_TEMPLATE_ELEMENTS || 2 * num_elements < array_len) return;
+
+    Ast* ident = ast_new_ident(AST_IDENT, global_list_create_str_label(global_list));
+    ident->ctype = ctype_copy(array_ctype);
+
+    global_list_insert_copy(global_list, ident->value_ident, ident->ctype);
+    GlobalData* global_data = global_initializer_to_data(init, ident->ctype);
+    global_list_define(global_list, ident->value_ident, global_data);
+    global_list_make_readonly(global_list, ident->value_ident);
+
+    ast_move(init, ident);
+}
+
+int count_constant_initializer_elements(Ast* init, CType* ctype) {
+    int value = 0;
+    switch (ctype->basic_ctype) {
+        case CTYPE_CHAR:
+        case CTYPE_INT:
+            return evaluate_integer_constant_expr(init, &value) ? 1 : -1;
+        case CTYPE_ARRAY: {
+            if (init->type == AST_IMM_STR) return strlen(init->value_str) + 1;
+
+            int num_elements = 0;
+            size_t i = 0, size = init->children->size;
+            for (i = 0; i < size; i++) {
+                int num_child_elements = count_constant_initializer_elements(ast_nth_child(init, i), ctype->array_of);
+                if (num_child_elements < 0) return -1;
+                num_elements += num_child_elements;
+            }
+            return num_elements;
+        }
+        default:
+            return -1;
+    }
+}
+
+void pack_initializer_bytes(Ast* init, CType* ctype, unsigned char* bytes) {
+    int value = 0;
+    size_t i = 0, size = 0;
+    switch (ctype->basic_ctype) {
+        case CTYPE_CHAR:
+        case CTYPE_INT:
+            evaluate_integer_constant_expr(init, &value);
+            for (i = 0; i < ctype->size; i++) {
+                bytes[i] = ((unsigned int)value >> (8 * i)) & 0xff;
+            }
+            break;
+        case CTYPE_ARRAY:
+            if (init->type == AST_IMM_STR) {
+                memcpy(bytes, init->value_str, strlen(init->value_str));
+                break;
+            }
+            size = init->children->size;
+            for (i = 0; i < size; i++) {
+                pack_initializer_bytes(ast_nth_child(init, i), ctype->array_of, bytes + i * ctype->array_of->size);
             }
             break;
         default:
@@ -5,6 +5,12 @@ setup_test() {
 }
 
 test_mincc() {
+    for option in -O0 -O1 -O2; do
+        test_mincc_with_option "$1" "$2" ${option}
+    done
+}
+
+test_mincc_with_option() {
     MINCC=./build/mincc.out
     IN_C=./build/in.c
     OUT_ASSEMBLY=./build/out.s
@@ -13,11 +19,12 @@ test_mincc() {
 
     input=$1
     expected=$2
+    option=$3
     echo ${input} > ${IN_C}
-    ${MINCC} ${IN_C} ${OUT_ASSEMBLY}
+    ${MINCC} ${option} ${IN_C} ${OUT_ASSEMBLY}
 
     if [ $? -ne 0 ]; then
-        echo "\e[0;31m[FAIL]\e[m failed to compile"
+        echo "\e[0;31m[FAIL]\e[m failed to compile (${option})"
         exit 1
     fi
 
@@ -25,9 +32,9 @@ test_mincc() {
     actual=$(${EXEC} | tr '\n' '$')
 
     if [ ${actual} = ${expected} ]; then
-        echo "\e[0;32m[PASS]\e[m ${input}\n=> ${expected}"
+        echo "\e[0;32m[PASS]\e[m ${input} (${option})\n=> ${expected}"
     else
-        echo "\e[0;31m[FAIL]\e[m ${input}\n=> ${expected} expected, but got ${actual}"
+        echo "\e[0;31m[FAIL]\e[m ${input} (${option})\n=> ${expected} expected, but got ${actual}"
         exit 1
     fi
 
@@ -79,6 +86,13 @@ int put_int(int x);
 int main() { put_int((6-3+1) * (9-6+7-2)); return 0; }"   "32\$"
 test_mincc "
 int put_int(int x);
+int main() { put_int(((((((((((((((((((((((((((((((1)))))))))))))))))))))))))))))) + 1); return 0; }"   "2\$"
+test_mincc "
+int put_int(int x);
+int sum(int x1, int x2, int x3, int x4, int x5, int x6);
+int main() { put_int(1+(2+(3+(4+(5+(6+(7+(8+(9+(10+sum(1,2,3,4,5,6*(1+(2+(3+(4+(5+(6+(7+(8+1))))))))))))))))))); return 0; }"   "292\$"
+test_mincc "
+int put_int(int x);
 int main() { put_int((4*1) * (4/3) ); return 0; }"         "4\$"
 
 test_mincc "
@@ -305,6 +319,65 @@ int main() {
     return 0;
 }"                           "28\$"
 
+test_mincc "
+int put_int(int x);
+int main() {
+    int x = 7;
+    put_int(x += 5);
+    put_int(x -= 2);
+    put_int(x *= -3);
+    put_int(x /= 4);
+    put_int(x %= 4);
+    put_int(x);
+    return 0;
+}"                           "12\$10\$-30\$-7\$-3\$-3\$"
+test_mincc "
+int put_int(int x);
+int main() {
+    int x = 12;
+    put_int(x <<= 2);
+    put_int(x >>= 3);
+    put_int(x &= 5);
+    put_int(x ^= 7);
+    put_int(x |= 8);
+    int y = -64;
+    put_int(y >>= 2);
+    return 0;
+}"                           "48\$6\$4\$3\$11\$-16\$"
+test_mincc "
+int put_int(int x);
+int main() {
+    char c = 120;
+    put_int(c += 10);
+    put_int(c -= 3);
+    char d = 100;
+    put_int(d *= 3);
+    char e = -7;
+    put_int(e /= 2);
+    put_int(e);
+    return 0;
+}"                           "-126\$127\$44\$-3\$-3\$"
+test_mincc "
+int put_int(int x);
+int main() {
+    int a[4] = {1, 2, 3, 4};
+    int* p = a;
+    p += 3;
+    put_int(*p);
+    p -= 2;
+    put_int(*p);
+    int i = 1, j = 2, k = 1;
+    a[i*j+k] += 10;
+    a[i] *= a[i*j+k];
+    put_int(a[3]);
+    put_int(a[1]);
+    int x = 0, y = 0;
+    x += y += 3;
+    put_int(x);
+    put_int(y);
+    return 0;
+}"                           "4\$2\$14\$28\$3\$3\$"
+
 test_mincc "
 int put_int(int x);
 int main() {
@@ -1142,4 +1215,520 @@ int main() {
     return 0;
 }"                           "l0\$local1\$global0\$g1\$"
 
+test_mincc "
+int put_int(int x);
+
+int main() {
+    int a = 1, b = 2, t = 0, n = 3;
+    char c = 127;
+    while (n > 0) {
+        t = a;
+        a = b;
+        b = t;
+        n--;
+    }
+    c++;
+    put_int(a);
+    put_int(b);
+    put_int(c);
+    return 0;
+}"                           "2\$1\$-128\$"
+
+test_mincc "
+int put_int(int x);
+
+int set(int* p) {
+    *p = 5;
+    return 0;
+}
+
+int main() {
+    int x = 1, i = 0, k = 0, flag = 0;
+    set(&x);
+    for (i = 0; i < 4; i++) {
+        flag = (i > 0 && i < 3) || k;
+        k += flag;
+    }
+    put_int(x);
+    put_int(k);
+    return 0;
+}"                           "5\$3\$"
+
+test_mincc "
+int put_int(int x);
+
+int g = 1 + 2 * 3;
+int h = -(1 << 4) | 3;
+char c = 100 + 27 + 1;
+int big = 2147483647 + 1;
+int t = (7 / 2) % 2 + !0 + (3 > 2 && 0) + (0 || 5);
+int a[2 * 3 + 1];
+int m[1 + 1][10 / 5];
+int v[4] = { 10, 20, 30, 40 };
+int* p = v + 3 - 1;
+int* q = &g + 0;
+
+int main() {
+    int x = 2 * 3 + 4;
+    int* r = v + 1 + 1 + 1;
+    put_int(g);
+    put_int(h);
+    put_int(c);
+    put_int(big);
+    put_int(t);
+    put_int(x);
+    put_int(*p);
+    put_int(*q);
+    put_int(*r);
+    put_int(*(r - 1 - 2));
+    put_int(~5 ^ (12 >> 2));
+    put_int(-2147483647 - 1 < 0);
+    a[6] = 7;
+    m[1][1] = 8;
+    put_int(a[6] + m[1][1]);
+    return 0;
+}"                           "7\$-13\$-128\$-2147483648\$3\$10\$30\$7\$40\$10\$-7\$1\$15\$"
+
+test_mincc "
+int put_int(int x);
+int fib(int n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }
+int total(int* a, int n) { int s = 0; int i; for (i = 0; i < n; i++) s += a[i]; return s; }
+int main() {
+    int a[5]; int i; char c = 120; int* p = a; int x = 7; int y = 3;
+    for (i = 0; i < 5; i++) a[i] = i * i;
+    put_int(total(a, 5));
+    for (i = 0; i < 10; i++) c++;
+    put_int(c);
+    c += 200;
+    put_int(c);
+    p++; p += 2;
+    put_int(*p);
+    put_int(*--p);
+    x <<= 3; x >>= 1; x *= y; x %= 5;
+    put_int(x);
+    put_int(fib(15) + y);
+    return 0;
+}"                           "30\$-126\$74\$9\$4\$4\$613\$"
+test_mincc "
+int put_int(int x);
+int mix(char c, int a, int* p) { int k; c = c + a; for (k = 0; k < 3; k++) a = a * 2 + c; return a + *p + k; }
+int main() {
+    int v = 5; int* q = &v; int j; int s = 0;
+    for (j = 0; j < 4; j++) s += mix(j + 125, j, q);
+    *q = 1;
+    put_int(s);
+    put_int(v);
+    return 0;
+}"                           "80\$1\$"
+
+test_mincc "
+int put_int(int x);
+int main() {
+    int a[6]; int i; int* p; int* q; char* c; int k = -2;
+    for (i = 0; i < 6; i++) a[i] = i * 3 + i * 5 + i * 9 - i * 8;
+    p = a + 5; q = a + 1;
+    put_int(p - q);
+    put_int(*(p + k));
+    put_int(*(k + p));
+    p += k;
+    put_int(*p);
+    c = \"hello\";
+    put_int((c + 4) - c);
+    put_int(k * 1 + k * 0 + k * -1 + k * 16 + 12 * k);
+    return 0;
+}"                           "4\$27\$27\$27\$4\$-56\$"
+
+test_mincc "
+int put_int(int x);
+int digit_sum(int n) { int s = 0; while (n != 0) { s += n % 10; n = n / 10; } return s; }
+int main() {
+    int vals[12]; int i; int acc = 0; int k = -2147483647 - 1;
+    vals[0] = 0; vals[1] = 7; vals[2] = -7; vals[3] = 2147483647; vals[4] = k; vals[5] = -1;
+    vals[6] = 100; vals[7] = -100; vals[8] = 12345; vals[9] = -12345; vals[10] = 99; vals[11] = -99;
+    for (i = 0; i < 12; i++) {
+        int v = vals[i];
+        acc = acc * 31 + v / 3 + v % 3 + v / 7 + v % 7 + v / 8 + v % 8 + v / -4 + v % -4
+            + v / 1 + v % 1 + (v != k) * v / -1 + v / 10 + v % 10 + v / -10 + v % -10 + v / 1000000 + v % 641
+            + v / 2 + v % 2 + v / 2147483647;
+    }
+    put_int(acc);
+    put_int(digit_sum(2147483647));
+    put_int(digit_sum(-98765));
+    return 0;
+}"                           "262576909\$46\$-35\$"
+
+test_mincc "
+int put_int(int x);
+int calls;
+int check(int x) { calls++; return x; }
+int main() {
+    int a[4]; int* p = a; int* q = a + 3; int i = 0; int n = 0;
+    if (check(0) && check(1)) put_int(1); else put_int(2);
+    if (check(1) || check(0)) put_int(3);
+    if (!(check(0) || check(0)) && !check(0)) put_int(4);
+    put_int(calls);
+    if (p < q && !(p == q) && q - p == 3) put_int(5);
+    if (p >= q || p + 3 != q) put_int(-1); else put_int(6);
+    while (p < q && *(p = p + 1) != 7) i++;
+    do n++; while (n < 3 && !(n == 5));
+    for (; !(i > 5) || n == 0; i++) n += 10;
+    put_int(i);
+    put_int(n);
+    put_int((i > 2 && n > 2) + (i < 2 || n < 2) + !(i == 6));
+    return 0;
+}"                           "2\$3\$4\$5\$5\$6\$6\$33\$1\$"
+
+test_mincc "
+int put_int(int x);
+int g;
+int tab[8];
+int bump(int* p) { *p = *p + 1; return 0; }
+int f(int* p, int n) {
+    int s = 0; int i; int a[4]; int b[2]; int k = n * 3;
+    a[0] = 5; b[0] = 1;
+    for (i = 0; i < n; i++) { s += a[0] + g + k * 7 + *p + b[0]; tab[i & 7] = s; *p = i; bump(b); }
+    i = 0;
+    while (i < n) { s += tab[2] + g; g = g + 1; i++; }
+    return s;
+}
+int main() { int x = 4; g = 2; put_int(f(&x, 5)); put_int(x); put_int(g); return 0; }"   "2340\$4\$7\$"
+
+test_mincc "
+int put_int(int x);
+int tests;
+int below(int i, int n) { tests++; return i < n; }
+int main() {
+    int i; int s = 0; int j = 0;
+    for (i = 0; below(i, 6); i++) { if (i == 2) continue; if (i == 4) break; s += i; }
+    put_int(s); put_int(tests);
+    tests = 0; i = 0;
+    while (below(i, 5)) { i++; if (i % 2) continue; s += 10; }
+    put_int(s); put_int(tests);
+    tests = 0;
+    while (below(9, 5)) s = -1;
+    for (i = 7; below(i, 3); i++) s = -1;
+    put_int(s); put_int(tests);
+    for (i = 0; ; i++) { j += i; if (j > 20) break; }
+    put_int(i); put_int(j);
+    i = 0;
+    do { i++; if (i < 3) continue; j++; } while (i < 5);
+    put_int(j);
+    return 0;
+}"                           "4\$5\$24\$6\$24\$2\$6\$21\$24\$"
+
+test_mincc "
+int put_int(int x);
+int m[4][5];
+char buf[16];
+int dot(int* a, int* b, int n) { int s = 0; int i; for (i = 0; i < n; i++) s += a[i] * b[i]; return s; }
+int main() {
+    int i; int j; int s = 0; int v[6]; int* p;
+    for (i = 0; i < 4; i++) for (j = 0; j < 5; j++) m[i][j] = i * 10 + j;
+    for (i = 3; i >= 0; i--) for (j = 4; j > 0; j -= 2) s += m[i][j];
+    put_int(s);
+    for (i = 0; i < 16; i++) buf[i] = 97 + i;
+    s = 0;
+    for (i = 1; i <= 15; i += 3) s = s * 2 + buf[i] - buf[i - 1];
+    put_int(s);
+    for (i = 0; i < 6; i++) v[i] = i + 1;
+    put_int(dot(v, v, 6));
+    put_int(dot(v + 2, v, 0));
+    for (i = 0; i != 6; i++) if (v[i] == 4) break;
+    put_int(i);
+    s = 0; p = v;
+    for (i = 0; i < 5; i++) { s += p[i]; p = v + 1; }
+    put_int(s);
+    return 0;
+}"                           "144\$31\$91\$0\$3\$19\$"
+
+test_mincc "
+int put_int(int x);
+int n;
+int bump(int x) { n = n * 10 + x; return n; }
+int sign(int x) { if (x < 0) return -1; else if (x > 0) return 1; else return 0; put_int(99); }
+int main() {
+    int a[3]; int* p; int i; int x = 1;
+    a[0] = 4; a[1] = 5; a[2] = 6; p = a;
+    x + 1; a[1] * 2; ;
+    bump(1) + bump(2);
+    *p++;
+    -bump(3);
+    if (0) bump(7);
+    if (1) bump(4); else bump(8);
+    while (0) bump(9);
+    for (i = bump(5); 0; i++) bump(9);
+    if (x) ; else bump(9);
+    if (bump(6)) ;
+    for (i = 0; i < 3; i + 1) { i++; continue; bump(9); }
+    put_int(n); put_int(*p); put_int(i);
+    put_int(sign(-3) + sign(0) * 10 + sign(8) * 100);
+    return 0;
+    put_int(9);
+}"                           "123456\$5\$3\$99\$"
+
+test_mincc "
+int put_int(int x);
+int g;
+int sq(int x) { return x * x; }
+int clamp(int x, int lo, int hi) { if (x < lo) return lo; if (x > hi) return hi; return x; }
+int sum3(int* p) { int s = 0; int i; for (i = 0; i < 3; i++) s += p[i]; return s; }
+int fact(int n) { if (n <= 1) return 1; return n * fact(n - 1); }
+int even(int n);
+int odd(int n) { if (n == 0) return 0; return even(n - 1); }
+int even(int n) { if (n == 0) return 1; return odd(n - 1); }
+int setg(int v) { g = v; }
+int twice(int x) { int y[2]; y[0] = sq(x); y[1] = sq(x + 1); return y[0] + y[1]; }
+int main() {
+    int a[3]; int i; int s = 0;
+    a[0] = 1; a[1] = 2; a[2] = 3;
+    for (i = 0; i < 10; i++) s += sq(i) + clamp(i, 2, 7);
+    put_int(s);
+    put_int(sum3(a) + 2 * sum3(a));
+    put_int(fact(6));
+    put_int(even(7) * 10 + odd(7));
+    setg(5); put_int(g);
+    put_int(twice(3) + a[2]);
+    return 0;
+}"                           "330\$18\$720\$1\$5\$28\$"
+
+test_mincc "
+int put_int(int x);
+int g0;
+int down(int n, int acc) { if (n == 0) return acc; return down(n - 1, acc + 1); }
+int gcd(int a, int b) { if (b == 0) return a; return gcd(b, a % b); }
+int is_even(int n);
+int is_odd(int n) { if (n == 0) return 0; return is_even(n - 1); }
+int is_even(int n) { if (n == 0) return 1; return is_odd(n - 1); }
+int count(char* s, int c, int acc) { if (*s == 0) return acc; return count(s + 1, c, acc + (*s == c)); }
+int esc(int n, int* p) { int x; x = n; if (n == 0) return *p; return esc(n - 1, &x); }
+int main() {
+    g0 = 7;
+    put_int(down(50000, 0));
+    put_int(gcd(1071, 462));
+    put_int(is_even(30001));
+    put_int(count(\"abracadabra\", 97, 0));
+    put_int(esc(5, &g0));
+    put_int(esc(0, &g0));
+    return 0;
+}"                           "50000\$21\$0\$5\$1\$7\$"
+test_mincc_with_option "
+int put_int(int x);
+int down(int n, int acc) { if (n == 0) return acc; return down(n - 1, acc + 1); }
+int is_even(int n);
+int is_odd(int n) { if (n == 0) return 0; return is_even(n - 1); }
+int is_even(int n) { if (n == 0) return 1; return is_odd(n - 1); }
+int main() {
+    put_int(down(5000000, 0));
+    put_int(is_even(3000001));
+    return 0;
+}" "5000000\$0\$" -O1
+test_mincc_with_option "
+int put_int(int x);
+int down(int n, int acc) { if (n == 0) return acc; return down(n - 1, acc + 1); }
+int is_even(int n);
+int is_odd(int n) { if (n == 0) return 0; return is_even(n - 1); }
+int is_even(int n) { if (n == 0) return 1; return is_odd(n - 1); }
+int main() {
+    put_int(down(5000000, 0));
+    put_int(is_even(3000001));
+    return 0;
+}" "5000000\$0\$" -O2
+
+test_mincc "
+int put_int(int x);
+int pick(int a, int b) { int x[2]; x[0] = a; x[1] = b; if (a > b) return x[0]; return x[1]; }
+int fill(int n) { int x[28]; int i; int s; for (i = 0; i < 28; i++) x[i] = i * n; s = 0; for (i = 0; i < 28; i++) s = s + x[i]; return s; }
+int big(int n) { int x[40]; int i; for (i = 0; i < 40; i++) x[i] = n; return x[39] + x[0]; }
+int digits(int n) { char c; c = 0; while (n > 0) { n = n / 10; c++; } return c; }
+int main() {
+    int a[4];
+    a[0] = pick(3, 9);
+    a[1] = fill(2);
+    a[2] = big(4);
+    a[3] = digits(123456);
+    put_int(a[0] + a[3]);
+    put_int(a[1]);
+    put_int(a[2]);
+    put_int(pick(9, 3));
+    return 0;
+}"                           "15\$756\$8\$9\$"
+
+test_mincc "
+int put_int(int x);
+int id(int x) { return x; }
+int many(int a, int b) {
+    int c; int d; int e; int f; int g; int h; int k; int arr[3];
+    c = id(a + 1); d = id(b + 2); e = id(c * d); f = id(e - a); g = id(f + b); h = id(g * 2); k = id(h + c);
+    arr[0] = a; arr[1] = id(b); arr[2] = arr[0] + arr[1];
+    return a + b + c + d + e + f + g + h + k + arr[2];
+}
+int fill(int* p, int n) { int i; for (i = 0; i < n; i++) p[i] = id(i * i); return n; }
+int main() {
+    int buf[10];
+    int s; int i;
+    put_int(many(3, 4));
+    fill(buf, 10);
+    s = 0;
+    for (i = 0; i < 10; i++) s = s + buf[i];
+    put_int(s);
+    return 0;
+}"                           "198\$285\$"
+
+test_mincc "
+int put_int(int x);
+int g;
+int bump() { g++; return g; }
+int a[4];
+int main() {
+    int i; int x; int y; int* p;
+    for (i = 0; i < 4; i++) a[i] = i + 1;
+    i = 1;
+    a[i] = a[i] + a[i + 1] * a[i + 1];
+    put_int(a[1]);
+    x = a[i];
+    a[i]++ > 0 && (x = x + a[i]);
+    put_int(x);
+    y = i++;
+    y = y + i;
+    y = y * --i;
+    put_int(y);
+    g = 10;
+    x = g;
+    bump() > 0 && (x = x + g);
+    put_int(x);
+    x = g * g;
+    bump();
+    put_int(x + g * g);
+    p = a;
+    *(p + 2) = *(p + 2) + 1;
+    x = *(p + 2);
+    *(p + 2) = 0;
+    put_int(x + *(p + 2));
+    x = a[3] * a[3];
+    a[3] = bump();
+    put_int(x + a[3] * a[3]);
+    return 0;
+}"                           "11\$23\$3\$21\$265\$4\$185\$"
+
+test_mincc "
+int put_int(int x);
+int main() {
+    int a[37]; int b[37]; char c[45]; char d[45]; int i; int n; int s; int k; int* p; int* q;
+    n = 37; k = 3;
+    for (i = 0; i < n; i++) a[i] = i * 3;
+    for (i = 0; i < n; i++) b[i] = 100 - i;
+    for (i = 0; i < 45; i++) c[i] = i * 7;
+    for (i = 0; i < 45; i++) d[i] = 120;
+    for (i = 0; i < 45; i++) d[i] = c[i] + d[i] - k;
+    s = 0;
+    for (i = 0; i < 45; i++) s = s + d[i];
+    put_int(s);
+    for (i = 0; i < n; i++) a[i] = a[i] + b[i] + k;
+    s = 0;
+    for (i = 0; i < n; i++) s += a[i] ^ 5;
+    put_int(s);
+    p = a; q = a + 1;
+    for (i = 0; i < 30; i++) q[i] = p[i] + 1;
+    put_int(a[30]);
+    s = 7;
+    for (i = 1; i < n; i++) s += (a[i] & 255) | b[i];
+    put_int(s);
+    return 0;
+}
+" "-349\$5102\$133\$5527\$"
+test_mincc "
+int put_int(int x);
+int f(int k) {
+    char buf[300] = \"\";
+    int a[10] = {1, 2, 3, 4, 5, 6, 7, 8};
+    int b[2][3] = {{k}, {k + 1, k + 2, k + 3}};
+    char s[13] = \"hello world\";
+    int big[100] = {k, 2};
+    int t = 0; int i;
+    for (i = 0; i < 300; i++) t = t + buf[i];
+    for (i = 0; i < 10; i++) t = t + a[i] * (i + 1);
+    for (i = 0; i < 6; i++) t = t * 3 + b[i / 3][i % 3];
+    for (i = 0; i < 13; i++) t = t + s[i] * i;
+    for (i = 0; i < 100; i++) t = t + big[i] * (i + 7);
+    return t;
+}
+int main() { put_int(f(5)); put_int(f(-2)); return 0; }
+" "155685\$153844\$"
+test_mincc "
+int put_int(int x);
+char* g = \"shared\";
+int same(char* p, char* q) { return p == q; }
+int main() {
+    char* a = \"shared\";
+    char* b = \"other\";
+    char* c = \"shared\";
+    put_int(a[1] + b[0] + c[5]);
+    put_int(same(a, g)); put_int(same(a, b)); put_int(same(\"other\", b));
+    return 0;
+}
+" "315\$1\$0\$1\$"
+test_mincc "
+int put_int(int x);
+char c;
+int n;
+int* p;
+int zeros[1000];
+int filled[3] = {0, 0, 0};
+char tag[4];
+char name[8] = \"\";
+int init[4] = {1, 2};
+char* msg = \"x\";
+int main() {
+    int i; int s = 0;
+    for (i = 0; i < 1000; i++) s = s + zeros[i];
+    zeros[999] = 7; c = 3; n = 4; p = &n;
+    put_int(s + zeros[999] + c + *p + filled[2] + tag[3] + name[7] + init[1] + msg[0]);
+    return 0;
+}
+" "136\$"
+test_mincc "
+int put_int(int x);
+int table[1000] = {-500,419,338,257,176,95,14,-67,-148,-229,-310,-391,-472,447,366,285,204,123,42,-39,-120,-201,-282,-363,-444,475,394,313,232,151,70,-11,-92,-173,-254,-335,-416,-497,422,341};
+char rows[3][5] = {\"ab\", \"cde\", {1, -2}};
+int grid[2][3] = {{1}, {0, 0, -70000}};
+char bytes[20] = {1, 2, 3};
+int* ptrs[2] = {table, table};
+int main() {
+    int i; int s = 0;
+    for (i = 0; i < 1000; i++) s = s + table[i] * (i % 13 + 1);
+    put_int(s);
+    put_int(rows[0][1] + rows[1][2] * 3 + rows[2][1] + rows[2][4]);
+    put_int(grid[0][0] + grid[1][2] + grid[0][2]);
+    put_int(bytes[0] + bytes[2] + bytes[19]);
+    put_int(ptrs[1][5] - ptrs[0][3]);
+    return 0;
+}
+" "-29532\$399\$-69999\$4\$-162\$"
+test_mincc "
+int put_int(int x);
+int same(char* s, char* t) {
+    while (*s == *t && *s != 0) {
+        s = s + 1;
+        t = t + 1;
+    }
+    return *s - *t;
+}
+int main() {
+    char a; char b; char c; int n;
+    a = 5; b = 5; c = -3; n = 0;
+    if (a == b) n = n + 1;
+    if (c < a) n = n + 10;
+    if (a == b && c != b) n = n + 100;
+    if (c > b || a >= b) n = n + 1000;
+    put_int(n);
+    put_int(same(\"abc\", \"abc\"));
+    put_int(same(\"abd\", \"abc\"));
+    return 0;
+}
+" "1111\$0\$1\$"
+test_mincc "int put_int(int x); int GA[16]; int f(int j, int n) { int s = 0; int i = 0; for (i = 0; i < n; i++) { if (j < 16) s += GA[j]; s += 1; } return s; } int main() { GA[1] = 5; put_int(f(1000000000, 3)); put_int(f(1, 3)); return 0; }" "3\$18\$"
+test_mincc "int put_int(int x); int f(int x) { put_int(x / 3); put_int(x % 3); put_int(x / -3); put_int(x % -3); put_int(x / 7); put_int(x % 7); put_int(x / -7); put_int(x % -7); put_int(x / 8); put_int(x % 8); put_int(x / -8); put_int(x % -8); return 0; } int main() { f(2147483647); f(-2147483647 - 1); f(-13); f(13); f(0); return 0; }" "715827882\$1\$-715827882\$1\$306783378\$1\$-306783378\$1\$268435455\$7\$-268435455\$7\$-715827882\$-2\$715827882\$-2\$-306783378\$-2\$306783378\$-2\$-268435456\$0\$268435456\$0\$-4\$-1\$4\$-1\$-1\$-6\$1\$-6\$-1\$-5\$1\$-5\$4\$1\$-4\$1\$1\$6\$-1\$6\$1\$5\$-1\$5\$0\$0\$0\$0\$0\$0\$0\$0\$0\$0\$0\$0\$"
+test_mincc "int put_int(int x); int f(int x) { put_int(x / 10); put_int(x % 10); put_int(x / -10); put_int(x % -10); put_int(x / 641); put_int(x % -641); put_int(x / 2147483647); put_int(x % -2147483647); put_int(x / (-2147483647 - 1)); put_int(x % (-2147483647 - 1)); put_int(x / 1); put_int(x % 1); return 0; } int main() { f(2147483647); f(-2147483647 - 1); f(-2147483647); f(-641); f(99); return 0; }" "214748364\$7\$-214748364\$7\$3350208\$319\$1\$0\$0\$2147483647\$2147483647\$0\$-214748364\$-8\$214748364\$-8\$-3350208\$-320\$-1\$-1\$1\$0\$-2147483648\$0\$-214748364\$-7\$214748364\$-7\$-3350208\$-319\$-1\$0\$0\$-2147483647\$-2147483647\$0\$-64\$-1\$64\$-1\$-1\$0\$0\$-641\$0\$-641\$-641\$0\$9\$9\$-9\$9\$0\$99\$0\$99\$0\$99\$99\$0\$"
+test_mincc "int put_int(int x); int a[64]; int f(int n) { int i; int s = 0; for (i = 0; i < n; i++) { if (a[i + 1] < 0) break; s += a[i + 1]; } return s; } int g(int n) { int i; int s = 0; for (i = 0; i < n; i++) { if (a[2 * i] < 0) break; s += a[2 * i]; } return s; } int main() { int i; for (i = 0; i < 64; i++) a[i] = i % 10; a[10] = -1; put_int(f(2147483647)); put_int(g(1500000000)); a[10] = 5; a[6] = -1; put_int(f(1500000000)); put_int(g(2147483647)); return 0; }" "45\$20\$15\$6\$"
+test_mincc "int put_int(int x); int f(int x, int big) { if (big) return x << 1000; return x << 3; } int g(int x, int big) { if (big) return x >> 999; return x >> 2; } int main() { put_int(f(5, 0)); put_int(g(-64, 0)); put_int(f(-7, 0) >> 1); return 0; }" "40\$-16\$-28\$"
 teardown_test
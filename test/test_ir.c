@@ -0,0 +1,184 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../src/ir/cse.h"
+#include "../src/ir/dominance.h"
+#include "../src/ir/ir.h"
+#include "../src/ir/licm.h"
+#include "../src/ir/liveness.h"
+#include "../src/ir/strength.h"
+#include "../src/common/memory.h"
+
+
+int main() {
+    IrFunction* func = ir_function_new(str_new("f"), 0);
+    IrBlock* entry_block = ir_function_create_block(func);
+    IrBlock* loop_block = ir_function_create_block(func);
+    IrBlock* exit_block = ir_function_create_block(func);
+    assert(func->num_blocks == 3);
+    assert(entry_block->id == 0);
+    assert(exit_block->id == 2);
+
+    int n = ir_function_create_vreg(func);
+    int i = ir_function_create_vreg(func);
+    int cond = ir_function_create_vreg(func);
+    assert(func->num_vregs == 3);
+
+    ir_block_append_inst(entry_block, ir_inst_new(IR_ARG, 4, n, 1, ir_operand_new_imm(0)));
+    ir_block_append_inst(entry_block, ir_inst_new(IR_MOV, 4, i, 1, ir_operand_new_imm(0)));
+    IrInst* jump = ir_inst_new(IR_JMP, 0, -1, 0);
+    jump->targets[0] = loop_block;
+    ir_block_append_inst(entry_block, jump);
+    assert(ir_block_is_terminated(entry_block));
+    assert(ir_block_terminator(entry_block) == jump);
+
+    ir_block_append_inst(loop_block, ir_inst_new(
+        IR_ADD, 4, i, 2, ir_operand_new_vreg(i), ir_operand_new_imm(1)
+    ));
+    assert(!ir_block_is_terminated(loop_block));
+    ir_block_append_inst(loop_block, ir_inst_new(
+        IR_LT, 4, cond, 2, ir_operand_new_vreg(i), ir_operand_new_vreg(n)
+    ));
+    IrInst* branch = ir_inst_new(IR_BR, 4, -1, 1, ir_operand_new_vreg(cond));
+    branch->targets[0] = loop_block;
+    branch->targets[1] = exit_block;
+    ir_block_append_inst(loop_block, branch);
+
+    ir_block_append_inst(exit_block, ir_inst_new(IR_RET, 4, -1, 1, ir_operand_new_vreg(i)));
+
+    ir_function_compute_cfg(func);
+    assert(entry_block->preds->size == 0);
+    assert(entry_block->succs->size == 1);
+    assert(loop_block->preds->size == 2);
+    assert(vector_at(loop_block->preds, 0) == entry_block);
+    assert(vector_at(loop_block->preds, 1) == loop_block);
+    assert(loop_block->succs->size == 2);
+    assert(exit_block->preds->size == 1);
+    assert(exit_block->succs->size == 0);
+
+    Liveness* liveness = liveness_new(func);
+    assert(!liveness_is_live_in(liveness, entry_block, n));
+    assert(liveness_is_live_out(liveness, entry_block, n));
+    assert(liveness_is_live_out(liveness, entry_block, i));
+    assert(liveness_is_live_in(liveness, loop_block, n));
+    assert(liveness_is_live_in(liveness, loop_block, i));
+    assert(!liveness_is_live_in(liveness, loop_block, cond));
+    assert(liveness_is_live_out(liveness, loop_block, n));
+    assert(!liveness_is_live_out(liveness, loop_block, cond));
+    assert(liveness_is_live_in(liveness, exit_block, i));
+    assert(!liveness_is_live_in(liveness, exit_block, n));
+    liveness_delete(liveness);
+
+    Dominance* dominance = dominance_new(func);
+    assert(dominance->idom[entry_block->id] == entry_block);
+    assert(dominance->idom[loop_block->id] == entry_block);
+    assert(dominance->idom[exit_block->id] == loop_block);
+    assert(dominance_dominates(dominance, entry_block, exit_block));
+    assert(!dominance_dominates(dominance, exit_block, loop_block));
+    assert(dominance->frontier[loop_block->id]->size == 1);
+    assert(vector_at(dominance->frontier[loop_block->id], 0) == loop_block);
+    assert(dominance->frontier[exit_block->id]->size == 0);
+    dominance_delete(dominance);
+
+    ir_function_delete(func);
+
+    func = ir_function_new(str_new("g"), 0);
+    IrBlock* block = ir_function_create_block(func);
+    int x = ir_function_create_vreg(func);
+    ir_block_append_inst(block, ir_inst_new(IR_ARG, 8, x, 1, ir_operand_new_imm(0)));
+    ir_block_append_inst(block, ir_inst_new(IR_MUL, 8, -1, 2, ir_operand_new_vreg(x), ir_operand_new_imm(8)));
+    ir_block_append_inst(block, ir_inst_new(IR_MUL, 4, -1, 2, ir_operand_new_imm(1), ir_operand_new_vreg(x)));
+    ir_block_append_inst(block, ir_inst_new(IR_MUL, 4, -1, 2, ir_operand_new_vreg(x), ir_operand_new_imm(-1)));
+    ir_block_append_inst(block, ir_inst_new(IR_MUL, 4, -1, 2, ir_operand_new_vreg(x), ir_operand_new_imm(12)));
+    ir_block_append_inst(block, ir_inst_new(IR_DIV, 4, -1, 2, ir_operand_new_vreg(x), ir_operand_new_imm(1)));
+    reduce_strength(func);
+    IrInst* shl = (IrInst*)vector_at(block->insts, 1);
+    assert(shl->opcode == IR_SHL && shl->width == 8 && ir_inst_nth_src(shl, 1)->value == 3);
+    assert(((IrInst*)vector_at(block->insts, 2))->opcode == IR_MOV);
+    assert(((IrInst*)vector_at(block->insts, 3))->opcode == IR_NEG);
+    assert(((IrInst*)vector_at(block->insts, 4))->opcode == IR_MUL);
+    assert(((IrInst*)vector_at(block->insts, 5))->opcode == IR_MOV);
+    assert(exact_log2(1) == 0 && exact_log2(64) == 6 && exact_log2(12) < 0 && exact_log2(0) < 0);
+    ir_function_delete(func);
+
+    func = ir_function_new(str_new("g"), 0);
+    entry_block = ir_function_create_block(func);
+    loop_block = ir_function_create_block(func);
+    exit_block = ir_function_create_block(func);
+    int arg = ir_function_create_vreg(func);
+    int addr = ir_function_create_vreg(func);
+    int sum = ir_function_create_vreg(func);
+    int value = ir_function_create_vreg(func);
+    cond = ir_function_create_vreg(func);
+    ir_block_append_inst(entry_block, ir_inst_new(IR_ARG, 4, arg, 1, ir_operand_new_imm(0)));
+    IrInst* global_addr = ir_inst_new(IR_GLOBAL_ADDR, 8, addr, 0);
+    global_addr->symbol = str_new("x");
+    ir_block_append_inst(entry_block, global_addr);
+    jump = ir_inst_new(IR_JMP, 0, -1, 0);
+    jump->targets[0] = loop_block;
+    ir_block_append_inst(entry_block, jump);
+    ir_block_append_inst(loop_block, ir_inst_new(
+        IR_ADD, 4, sum, 2, ir_operand_new_vreg(arg), ir_operand_new_imm(4)
+    ));
+    ir_block_append_inst(loop_block, ir_inst_new(IR_LOAD, 4, value, 1, ir_operand_new_vreg(addr)));
+    ir_block_append_inst(loop_block, ir_inst_new(
+        IR_LT, 4, cond, 2, ir_operand_new_vreg(sum), ir_operand_new_vreg(value)
+    ));
+    branch = ir_inst_new(IR_BR, 4, -1, 1, ir_operand_new_vreg(cond));
+    branch->targets[0] = loop_block;
+    branch->targets[1] = exit_block;
+    ir_block_append_inst(loop_block, branch);
+    ir_block_append_inst(exit_block, ir_inst_new(IR_RET, 4, -1, 1, ir_operand_new_vreg(sum)));
+    hoist_loop_invariants(func, NULL);
+    assert(loop_block->insts->size == 1);
+    assert(entry_block->insts->size == 6);
+    assert(ir_block_terminator(entry_block) == jump);
+
+    ir_block_insert_inst(loop_block, 0, ir_inst_new(
+        IR_STORE, 4, -1, 2, ir_operand_new_vreg(addr), ir_operand_new_vreg(arg)
+    ));
+    ir_block_insert_inst(loop_block, 1, ir_inst_new(
+        IR_LOAD, 4, ir_function_create_vreg(func), 1, ir_operand_new_vreg(addr)
+    ));
+    hoist_loop_invariants(func, NULL);
+    assert(loop_block->insts->size == 3);
+    ir_function_delete(func);
+
+    func = ir_function_new(str_new("h"), 0);
+    block = ir_function_create_block(func);
+    x = ir_function_create_vreg(func);
+    int inc1 = ir_function_create_vreg(func);
+    int inc2 = ir_function_create_vreg(func);
+    addr = ir_function_create_vreg(func);
+    int load1 = ir_function_create_vreg(func);
+    int load2 = ir_function_create_vreg(func);
+    int load3 = ir_function_create_vreg(func);
+    sum = ir_function_create_vreg(func);
+    ir_block_append_inst(block, ir_inst_new(IR_ARG, 4, x, 1, ir_operand_new_imm(0)));
+    ir_block_append_inst(block, ir_inst_new(IR_ADD, 4, inc1, 2, ir_operand_new_vreg(x), ir_operand_new_imm(1)));
+    ir_block_append_inst(block, ir_inst_new(IR_ADD, 4, inc2, 2, ir_operand_new_imm(1), ir_operand_new_vreg(x)));
+    global_addr = ir_inst_new(IR_GLOBAL_ADDR, 8, addr, 0);
+    global_addr->symbol = str_new("x");
+    ir_block_append_inst(block, global_addr);
+    ir_block_append_inst(block, ir_inst_new(IR_LOAD, 4, load1, 1, ir_operand_new_vreg(addr)));
+    ir_block_append_inst(block, ir_inst_new(IR_LOAD, 4, load2, 1, ir_operand_new_vreg(addr)));
+    ir_block_append_inst(block, ir_inst_new(
+        IR_STORE, 4, -1, 2, ir_operand_new_vreg(addr), ir_operand_new_vreg(inc2)
+    ));
+    ir_block_append_inst(block, ir_inst_new(IR_LOAD, 4, load3, 1, ir_operand_new_vreg(addr)));
+    ir_block_append_inst(block, ir_inst_new(
+        IR_ADD, 4, sum, 2, ir_operand_new_vreg(load2), ir_operand_new_vreg(load3)
+    ));
+    ir_block_append_inst(block, ir_inst_new(IR_RET, 4, -1, 1, ir_operand_new_vreg(sum)));
+    eliminate_common_subexprs(func);
+    assert(block->insts->size == 8);
+    IrInst* store = (IrInst*)vector_at(block->insts, 4);
+    assert(store->opcode == IR_STORE && ir_inst_nth_src(store, 1)->value == inc1);
+    assert(((IrInst*)vector_at(block->insts, 5))->dst == load3);
+    IrInst* add = (IrInst*)vector_at(block->insts, 6);
+    assert(ir_inst_nth_src(add, 0)->value == load1 && ir_inst_nth_src(add, 1)->value == load3);
+    ir_function_delete(func);
+
+    fprintf(stdout, "OK\n");
+    return 0;
+}
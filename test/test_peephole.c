@@ -0,0 +1,117 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/gen/asminst.h"
+#include "../src/gen/peephole.h"
+#include "../src/common/memory.h"
+
+
+Vector* codes_new(char** lines) {
+    Vector* codes = vector_new();
+    char** p = lines;
+    for (p = lines; *p != NULL; p++) {
+        vector_push_back(codes, str_new(*p));
+    }
+    return codes;
+}
+
+void assert_codes(Vector* codes, char** expected) {
+    size_t i = 0;
+    for (i = 0; expected[i] != NULL; i++) {
+        assert(i < codes->size);
+        assert(strcmp((char*)vector_at(codes, i), expected[i]) == 0);
+    }
+    assert(i == codes->size);
+}
+
+
+int main() {
+    Option* option = option_new();
+
+    AsmInst* inst = asm_inst_parse("\tmov %rax, 8(%rdi,%rsi,4)\n");
+    assert(inst->type == ASM_INST_OP);
+    assert(strcmp(inst->opcode, "mov") == 0);
+    assert(inst->operands->size == 2);
+    assert(strcmp(asm_inst_nth_operand(inst, 1), "8(%rdi,%rsi,4)") == 0);
+    assert(asm_operand_register_mask(asm_inst_nth_operand(inst, 1)) == ((1 << 5) | (1 << 4)));
+    char* rendered = asm_inst_render(inst);
+    assert(strcmp(rendered, "\tmov %rax, 8(%rdi,%rsi,4)\n") == 0);
+    free(rendered);
+    asm_inst_delete(inst);
+
+    char* push_pop[] = {
+        "\t.text\n", "_f:\n",
+        "\tpush $5\n", "\tpop %rdi\n",
+        "\tlea -8(%rbp), %rax\n", "\tmov %rdi, (%rax)\n", "\tmovq $0, %rax\n",
+        "\tjmp .L_f_return\n", ".L_f_return:\n", "\tret\n", NULL
+    };
+    char* push_pop_expected[] = {
+        "\t.text\n", "_f:\n",
+        "\tmov $5, %rdi\n",
+        "\tmov %rdi, -8(%rbp)\n", "\tmovq $0, %rax\n",
+        ".L_f_return:\n", "\tret\n", NULL
+    };
+    Vector* codes = codes_new(push_pop);
+    optimize_peephole(codes, option);
+    assert_codes(codes, push_pop_expected);
+    vector_delete(codes);
+
+    char* branch[] = {
+        "\tcmp %edi, %eax\n", "\tsetl %al\n", "\tmovzb %al, %eax\n",
+        "\tmovq %rax, %r10\n", "\tmovq %r10, %rax\n", "\tcmp $0, %rax\n", "\tje .L_f_0\n",
+        "\tmovq $1, %rax\n", "\tret\n",
+        ".L_f_0:\n", "\tmovq $0, %rax\n", "\tret\n", NULL
+    };
+    char* branch_expected[] = {
+        "\tcmp %edi, %eax\n", "\tjge .L_f_0\n",
+        "\tmovq $1, %rax\n", "\tret\n",
+        ".L_f_0:\n", "\tmovq $0, %rax\n", "\tret\n", NULL
+    };
+    codes = codes_new(branch);
+    optimize_peephole(codes, option);
+    assert_codes(codes, branch_expected);
+    vector_delete(codes);
+
+    char* live_flags[] = {
+        "\tcmp $0, %rax\n", "\tje .L_f_0\n", "\tmovq $1, %rax\n",
+        ".L_f_0:\n", "\tsetne %al\n", "\tret\n", NULL
+    };
+    char* live_flags_expected[] = {
+        "\ttest %rax, %rax\n", "\tje .L_f_0\n", "\tmovq $1, %rax\n",
+        ".L_f_0:\n", "\tsetne %al\n", "\tret\n", NULL
+    };
+    codes = codes_new(live_flags);
+    optimize_peephole(codes, option);
+    assert_codes(codes, live_flags_expected);
+    vector_delete(codes);
+
+    char* scaled_index[] = {
+        "\tmovslq %edi, %rdi\n", "\tsal $2, %rdi\n", "\tadd %rdi, %rax\n",
+        "\tmov (%rax), %eax\n", "\tret\n", NULL
+    };
+    char* scaled_index_expected[] = {
+        "\tmovslq %edi, %rdi\n", "\tmov (%rax,%rdi,4), %eax\n", "\tret\n", NULL
+    };
+    codes = codes_new(scaled_index);
+    optimize_peephole(codes, option);
+    assert_codes(codes, scaled_index_expected);
+    vector_delete(codes);
+
+    char* accumulator[] = {
+        "\tmovq %rbx, %rdi\n", "\tmovq %r10, %rax\n", "\timul %edi, %eax\n", "\tmovq %rax, %r10\n",
+        "\tmovq $7, %rdi\n", "\tmovq %r10, %rax\n", "\tsub %edi, %eax\n", "\tmovq %rax, %r10\n",
+        "\tmovq %r10, %rax\n", "\tret\n", NULL
+    };
+    char* accumulator_expected[] = {
+        "\timul %ebx, %r10d\n", "\tsub $7, %r10d\n", "\tmovq %r10, %rax\n", "\tret\n", NULL
+    };
+    codes = codes_new(accumulator);
+    optimize_peephole(codes, option);
+    assert_codes(codes, accumulator_expected);
+    vector_delete(codes);
+
+    option_delete(option);
+    fprintf(stdout, "OK\n");
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include "../src/ir/strength.h"
+
+
+#define BOUNDARY_SAMPLES (1 << 20)
+
+
+int divide_by_magic(int n, int magic, int shift) {
+    int high = (int)(((long long)n * magic) >> 32);
+    if (magic < 0) high += n;
+    high >>= shift;
+    return high + (int)((unsigned int)high >> 31);
+}
+
+int divide_by_power_of_two(int n, int shift) {
+    int bias = (int)((unsigned int)(n >> 31) >> (32 - shift));
+    return (n + bias) >> shift;
+}
+
+void check_division(int n, int divisor) {
+    int magic = 0, shift = exact_log2(divisor);
+    int quotient = 0;
+    if (shift > 0) {
+        quotient = divide_by_power_of_two(n, shift);
+    } else {
+        assert(compute_division_magic(divisor, &magic, &shift));
+        quotient = divide_by_magic(n, magic, shift);
+    }
+    if (quotient != n / divisor) {
+        fprintf(stderr, "%d / %d: expected %d, got %d\n", n, divisor, n / divisor, quotient);
+        assert(0);
+    }
+}
+
+void check_boundary(long long boundary, int divisor) {
+    long long n = 0;
+    for (n = boundary - 1; n <= boundary + 1; n++) {
+        if (n >= INT_MIN && n <= INT_MAX) check_division((int)n, divisor);
+    }
+}
+
+void check_divisor(int divisor, int exhaustive) {
+    long long n = 0;
+    if (exhaustive) {
+        for (n = INT_MIN; n <= INT_MAX; n++) check_division((int)n, divisor);
+        return;
+    }
+    for (n = -70000; n <= 70000; n++) check_division((int)n, divisor);
+    for (n = 0; n < 70000; n++) {
+        check_division((int)(INT_MIN + n), divisor);
+        check_division((int)(INT_MAX - n), divisor);
+    }
+    long long quotient = 0, min_quotient = INT_MIN / divisor, max_quotient = INT_MAX / divisor;
+    long long step = (max_quotient - min_quotient) / BOUNDARY_SAMPLES + 1;
+    for (quotient = min_quotient; quotient <= max_quotient; quotient += step) {
+        check_boundary(quotient * divisor, divisor);
+    }
+    check_boundary(max_quotient * divisor, divisor);
+}
+
+
+int main(int argc, char** argv) {
+    int exhaustive = argc > 1 && strcmp(argv[1], "--exhaustive") == 0;
+
+    int magic = 0, shift = 0;
+    assert(!compute_division_magic(1, &magic, &shift));
+    assert(!compute_division_magic(8, &magic, &shift));
+    assert(compute_division_magic(3, &magic, &shift));
+    assert(magic == 0x55555556 && shift == 0);
+    assert(compute_division_magic(7, &magic, &shift));
+    assert(magic == (int)0x92492493 && shift == 2);
+    assert(compute_division_magic(10, &magic, &shift));
+    assert(magic == 0x66666667 && shift == 2);
+
+    int divisors[] = {
+        2, 3, 5, 6, 7, 9, 10, 11, 12, 13, 16, 25, 60, 100, 125, 641, 1000, 1024,
+        3600, 86400, 1000000, 1 << 30, 2147483647, 0
+    };
+    int* p = divisors;
+    for (p = divisors; *p != 0; p++) {
+        check_divisor(*p, exhaustive);
+    }
+    if (!exhaustive) {
+        int divisor = 0;
+        for (divisor = 3; divisor < 4096; divisor++) {
+            if (exact_log2(divisor) >= 0) continue;
+            assert(compute_division_magic(divisor, &magic, &shift));
+            check_division(INT_MAX, divisor);
+            check_division(INT_MIN, divisor);
+            check_division(-divisor, divisor);
+            check_division(divisor - 1, divisor);
+            check_division(-divisor + 1, divisor);
+        }
+    }
+
+    fprintf(stdout, "OK\n");
+    return 0;
+}